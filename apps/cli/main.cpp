@@ -1,14 +1,33 @@
+#include <algorithm>
+#include <bit>
 #include <cctype>
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "planner/astar.hpp"
+#include "planner/batch.hpp"
+#include "planner/bitgrid.hpp"
+#include "planner/components.hpp"
+#include "planner/hpa.hpp"
+#include "planner/paged_grid.hpp"
+#include "planner/plan.hpp"
+#include "sim/compiled_scenario.hpp"
 #include "sim/engine.hpp"
+#include "sim/json_writer.hpp"
+#include "sim/monte_carlo.hpp"
+#include "sim/obstacles.hpp"
+#include "sim/scenario.hpp"
+#include "sim/thread_pool.hpp"
+#include "sim/trajectory.hpp"
 
 // -----------------------------
 // Minimal, dependency-free helpers
@@ -16,198 +35,101 @@
 static void usage()
 {
   std::cout << "rescue_cli --scenario <path> [--ticks N] [--seed N] [--out results.json] [--pretty]\n"
-               "          [--ascii out.txt] [--emit-paths]\n";
+               "          [--ascii out.txt] [--emit-paths] [--planner astar|jps|hpa|flow]\n"
+               "          [--cluster-size N] [--open-list heap|buckets]\n"
+               "          [--threads N] [--rng mt19937|philox]\n"
+               "          [--checkpoint-every N] [--checkpoint-prefix checkpoint_] [--resume snapshot.bin]\n"
+               "          [--monte-carlo RUNS] [--trajectory out.rtraj] [--trajectory-chunk N]\n"
+               "rescue_cli --compile <in.json> <out.rsc>\n"
+               "rescue_cli --compile-tiles <in.json> <out.tiles> [--tile-size N]\n"
+               "rescue_cli --trajectory-frame <in.rtraj> <frame>\n";
 }
 
-static std::string read_all_text(const std::string& path)
+// --compile: parse and rasterize once, then write the binary image that --scenario maps.
+static int compile_scenario(const std::string& in_path, const std::string& out_path)
 {
-  std::ifstream in(path, std::ios::binary);
-  if (!in) return {};
-  std::ostringstream ss;
-  ss << in.rdbuf();
-  return ss.str();
-}
-
-static std::optional<std::string> extract_string_field(const std::string& text, const std::string& key)
-{
-  const std::string needle = "\"" + key + "\"";
-  auto k = text.find(needle);
-  if (k == std::string::npos) return std::nullopt;
-
-  auto colon = text.find(':', k + needle.size());
-  if (colon == std::string::npos) return std::nullopt;
-
-  auto q1 = text.find('"', colon + 1);
-  if (q1 == std::string::npos) return std::nullopt;
-  auto q2 = text.find('"', q1 + 1);
-  if (q2 == std::string::npos) return std::nullopt;
-
-  return text.substr(q1 + 1, q2 - q1 - 1);
-}
-
-static std::optional<long long> extract_int_field(const std::string& text, const std::string& key)
-{
-  const std::string needle = "\"" + key + "\"";
-  auto k = text.find(needle);
-  if (k == std::string::npos) return std::nullopt;
-
-  auto colon = text.find(':', k + needle.size());
-  if (colon == std::string::npos) return std::nullopt;
-
-  auto p = colon + 1;
-  while (p < text.size() && std::isspace(static_cast<unsigned char>(text[p]))) ++p;
-
-  bool neg = false;
-  if (p < text.size() && text[p] == '-')
+  rescueops::sim::Scenario scenario;
+  std::string error;
+  if (!rescueops::sim::load_scenario_file(in_path, scenario, &error))
   {
-    neg = true;
-    ++p;
+    std::cerr << "Failed to load scenario: " << in_path << " (" << error << ")\n";
+    return 1;
   }
-
-  long long v = 0;
-  bool any = false;
-  while (p < text.size() && std::isdigit(static_cast<unsigned char>(text[p])))
+  const int w = std::max(0, scenario.world.width);
+  const int h = std::max(0, scenario.world.height);
+  std::vector<std::uint8_t> blocked(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), 0);
+  const auto obstacles_count = rescueops::sim::rasterize_obstacles(scenario, w, h, blocked);
+  if (!rescueops::sim::write_compiled_scenario(out_path, scenario, blocked, &error))
   {
-    any = true;
-    v = v * 10 + (text[p] - '0');
-    ++p;
+    std::cerr << "Failed to compile scenario: " << error << "\n";
+    return 3;
   }
-  if (!any) return std::nullopt;
-
-  return neg ? -v : v;
+  std::cout << "Compiled " << in_path << " -> " << out_path << " (" << scenario.world.units.size() << " units, "
+            << scenario.targets.size() << " targets, " << obstacles_count << " blocked cells)\n";
+  return 0;
 }
 
-// Extract a JSON array substring by key, with simple bracket matching.
-// Returns the contents from '[' to the matching ']' inclusive.
-static std::optional<std::string> extract_array_blob(const std::string& text, const std::string& key)
+// --compile-tiles: write the obstacle grid as a tile file for PagedGrid. Rasterized one band of
+// tile rows at a time, so the full byte grid is never held in memory.
+static int compile_tiles(const std::string& in_path, const std::string& out_path, int tile_size)
 {
-  const std::string needle = "\"" + key + "\"";
-  auto k = text.find(needle);
-  if (k == std::string::npos) return std::nullopt;
-
-  auto lb = text.find('[', k + needle.size());
-  if (lb == std::string::npos) return std::nullopt;
-
-  int depth = 0;
-  for (std::size_t i = lb; i < text.size(); ++i)
+  rescueops::sim::Scenario scenario;
+  std::string error;
+  if (!rescueops::sim::load_scenario_file(in_path, scenario, &error))
   {
-    if (text[i] == '[') ++depth;
-    else if (text[i] == ']')
-    {
-      --depth;
-      if (depth == 0) return text.substr(lb, i - lb + 1);
-    }
+    std::cerr << "Failed to load scenario: " << in_path << " (" << error << ")\n";
+    return 1;
   }
-  return std::nullopt;
-}
-
-struct Target
-{
-  std::string unit;
-  int tx = 0;
-  int ty = 0;
-};
-
-// Parse targets from: "targets": [{"unit":"alpha","tx":12,"ty":7}, ...]
-static std::vector<Target> parse_targets(const std::string& scenario_text)
-{
-  std::vector<Target> out;
-
-  auto blobOpt = extract_array_blob(scenario_text, "targets");
-  if (!blobOpt) return out;
-  const std::string blob = *blobOpt;
-
-  std::size_t pos = 0;
-  while (true)
+  const int w = std::max(0, scenario.world.width);
+  const int h = std::max(0, scenario.world.height);
+  std::size_t obstacles_count = 0;
+  const bool ok = rescueops::planner::write_tile_file(
+    out_path, w, h, tile_size,
+    [&](int y0, int rows, std::span<std::uint8_t> band) {
+      obstacles_count += rescueops::sim::rasterize_obstacles(scenario, w, rows, band, y0);
+    },
+    &error);
+  if (!ok)
   {
-    auto o = blob.find('{', pos);
-    if (o == std::string::npos) break;
-    auto e = blob.find('}', o);
-    if (e == std::string::npos) break;
-
-    auto obj = blob.substr(o, e - o + 1);
-
-    Target t;
-    auto u = extract_string_field(obj, "unit");
-    auto tx = extract_int_field(obj, "tx");
-    auto ty = extract_int_field(obj, "ty");
-    if (u && tx && ty)
-    {
-      t.unit = *u;
-      t.tx = static_cast<int>(*tx);
-      t.ty = static_cast<int>(*ty);
-      out.push_back(t);
-    }
-
-    pos = e + 1;
+    std::cerr << "Failed to write tiles: " << error << "\n";
+    return 3;
   }
-  return out;
+  std::cout << "Compiled " << in_path << " -> " << out_path << " (" << w << "x" << h << ", tile size " << tile_size
+            << ", " << obstacles_count << " blocked cells)\n";
+  return 0;
 }
 
-// Obstacles format (single key):
-// "obstacles": [
-//   {"x":16,"y":0,"w":1,"h":8},   // rect
-//   {"x":10,"y":10}              // single cell
-// ]
-static int apply_obstacles(const std::string& scenario_text, int w, int h, std::vector<std::uint8_t>& blocked)
+// --trajectory-frame: one recorded frame as a JSON object on stdout.
+static int print_trajectory_frame(const std::string& path, rescueops::sim::Tick frame)
 {
-  int count = 0;
-
-  auto set_cell = [&](int x, int y) {
-    if (x < 0 || y < 0 || x >= w || y >= h) return;
-    const std::size_t idx = static_cast<std::size_t>(y * w + x);
-    if (blocked[idx] == 0)
-    {
-      blocked[idx] = 1;
-      ++count;
-    }
-  };
-
-  auto blobOpt = extract_array_blob(scenario_text, "obstacles");
-  if (!blobOpt) return 0;
-
-  const std::string blob = *blobOpt;
-  std::size_t pos = 0;
-  while (true)
+  rescueops::sim::TrajectoryReader reader;
+  std::string error;
+  if (!reader.open(path, &error))
   {
-    auto o = blob.find('{', pos);
-    if (o == std::string::npos) break;
-    auto e = blob.find('}', o);
-    if (e == std::string::npos) break;
-
-    const std::string obj = blob.substr(o, e - o + 1);
-
-    auto x = extract_int_field(obj, "x");
-    auto y = extract_int_field(obj, "y");
-    if (!x || !y)
-    {
-      pos = e + 1;
-      continue;
-    }
-
-    auto rw = extract_int_field(obj, "w");
-    auto rh = extract_int_field(obj, "h");
-
-    if (rw && rh)
-    {
-      const int W = static_cast<int>(*rw);
-      const int H = static_cast<int>(*rh);
-      for (int yy = 0; yy < H; ++yy)
-        for (int xx = 0; xx < W; ++xx)
-          set_cell(static_cast<int>(*x) + xx, static_cast<int>(*y) + yy);
-    }
-    else
-    {
-      set_cell(static_cast<int>(*x), static_cast<int>(*y));
-    }
-
-    pos = e + 1;
+    std::cerr << "Failed to open trajectory: " << path << " (" << error << ")\n";
+    return 1;
   }
-
-  return count;
+  std::vector<std::uint32_t> ids;
+  std::vector<int> x;
+  std::vector<int> y;
+  if (!reader.read_frame(frame, ids, x, y))
+  {
+    std::cerr << "Frame " << frame << " is not in " << path << " (recorded: " << reader.first_frame() << ".."
+              << reader.last_frame() << ")\n";
+    return 1;
+  }
+  rescueops::sim::JsonWriter out(std::cout);
+  out.raw("{\"frame\": ").number(frame).raw(", \"units\": [");
+  for (std::size_t i = 0; i < ids.size(); ++i)
+  {
+    if (i > 0) out.raw(", ");
+    out.raw("{\"id\": ").number(ids[i]).raw(", \"pos\": {\"x\": ").number(x[i]).raw(", \"y\": ").number(y[i]).raw("}}");
+  }
+  out.raw("]}\n");
+  return out.flush() ? 0 : 3;
 }
 
-static char unit_glyph(const std::string& name)
+static char unit_glyph(std::string_view name)
 {
   for (char c : name)
   {
@@ -228,23 +150,23 @@ struct PlanOut
 };
 
 static std::string render_ascii_map(const rescueops::sim::World& w,
-                                    const std::vector<Target>& targets,
+                                    const std::vector<rescueops::sim::ScenarioTarget>& targets,
                                     const std::vector<PlanOut>& plans,
-                                    const std::vector<std::uint8_t>& blocked,
+                                    const rescueops::planner::BitGrid& blocked,
                                     bool draw_paths)
 {
   std::vector<std::string> grid(static_cast<std::size_t>(w.height), std::string(static_cast<std::size_t>(w.width), '.'));
 
-  // 0) Obstacles first: '#'
-  for (int y = 0; y < w.height; ++y)
+  // 0) Obstacles first: '#' (64-cell row windows, one write per blocked cell)
+  for (int y = 0; y < w.height && y < blocked.height(); ++y)
   {
-    for (int x = 0; x < w.width; ++x)
+    const int row_w = std::min(w.width, blocked.width());
+    for (int x0 = 0; x0 < row_w; x0 += 64)
     {
-      const std::size_t idx = static_cast<std::size_t>(y * w.width + x);
-      if (idx < blocked.size() && blocked[idx] != 0)
-      {
-        grid[static_cast<std::size_t>(y)][static_cast<std::size_t>(x)] = '#';
-      }
+      std::uint64_t bits = blocked.bits_from(x0, y);
+      if (row_w - x0 < 64) bits &= (std::uint64_t{1} << (row_w - x0)) - 1;
+      for (; bits != 0; bits &= bits - 1)
+        grid[static_cast<std::size_t>(y)][static_cast<std::size_t>(x0 + std::countr_zero(bits))] = '#';
     }
   }
 
@@ -290,132 +212,252 @@ static std::string render_ascii_map(const rescueops::sim::World& w,
   return out.str();
 }
 
-static void write_json_vec2(std::ostream& out, int x, int y)
+static void write_json_vec2(rescueops::sim::JsonWriter& out, int x, int y)
 {
-  out << "{\"x\": " << x << ", \"y\": " << y << "}";
+  out.raw("{\"x\": ").number(x).raw(", \"y\": ").number(y).put('}');
 }
 
-static void write_path(std::ostream& out, const std::vector<rescueops::sim::Vec2i>& path, bool pretty, int indent)
+static void write_path(rescueops::sim::JsonWriter& out,
+                       const std::vector<rescueops::sim::Vec2i>& path,
+                       bool pretty,
+                       int indent)
 {
   if (path.empty())
   {
-    out << "[]";
+    out.raw("[]");
     return;
   }
-  out << "[";
-  if (pretty) out << "\n";
+  out.put('[');
+  if (pretty) out.put('\n');
   for (std::size_t i = 0; i < path.size(); ++i)
   {
-    if (pretty) out << std::string(static_cast<std::size_t>(indent), ' ');
+    if (pretty) out.spaces(static_cast<std::size_t>(indent));
     write_json_vec2(out, path[i].x, path[i].y);
-    if (i + 1 < path.size()) out << ",";
-    if (pretty) out << "\n";
+    if (i + 1 < path.size()) out.put(',');
+    if (pretty) out.put('\n');
   }
-  if (pretty && indent >= 2) out << std::string(static_cast<std::size_t>(indent - 2), ' ');
-  out << "]";
+  if (pretty && indent >= 2) out.spaces(static_cast<std::size_t>(indent - 2));
+  out.put(']');
 }
 
-static void write_results_json(std::ostream& out,
+static bool write_results_json(std::ostream& stream,
                                const std::string& scenario_path,
                                rescueops::sim::Tick ticks_requested,
                                const rescueops::sim::RunResult& rr,
                                const rescueops::sim::World& world,
                                int obstacles_count,
-                               const std::vector<Target>& targets,
+                               std::size_t components_count,
+                               const std::vector<rescueops::sim::ScenarioTarget>& targets,
                                const std::vector<PlanOut>& plans,
                                bool pretty,
                                bool emit_paths)
 {
-  const char* nl = pretty ? "\n" : "";
-  const char* sp = pretty ? " " : "";
-  auto indent = [&](int n) -> std::string { return pretty ? std::string(static_cast<std::size_t>(n), ' ') : ""; };
+  rescueops::sim::JsonWriter out(stream);
+  const std::string_view nl = pretty ? "\n" : "";
+  const std::string_view sp = pretty ? " " : "";
+  // Newline, then the indent of the next line (pretty only).
+  const auto line = [&](int n) -> rescueops::sim::JsonWriter& {
+    out.raw(nl);
+    return out.spaces(pretty ? static_cast<std::size_t>(n) : 0);
+  };
 
-  out << "{" << nl;
-  out << indent(2) << "\"version\": \"0.3-demo-obstacles\"," << nl;
+  out.put('{');
+  line(2).raw("\"version\": \"0.3-demo-obstacles\",");
 
   // scenario
-  out << indent(2) << "\"scenario\": {" << nl;
-  out << indent(4) << "\"path\": \"" << scenario_path << "\"," << nl;
-  out << indent(4) << "\"seed\": " << rr.seed << "," << nl;
-  out << indent(4) << "\"ticks_requested\": " << ticks_requested << "," << nl;
-  out << indent(4) << "\"ticks_executed\": " << rr.ticks_executed << nl;
-  out << indent(2) << "}," << nl;
+  line(2).raw("\"scenario\": {");
+  line(4).raw("\"path\": ").string(scenario_path).put(',');
+  line(4).raw("\"seed\": ").number(rr.seed).put(',');
+  line(4).raw("\"ticks_requested\": ").number(ticks_requested).put(',');
+  line(4).raw("\"ticks_executed\": ").number(rr.ticks_executed);
+  line(2).raw("},");
 
   // world
-  out << indent(2) << "\"world\": {" << nl;
-  out << indent(4) << "\"width\": " << world.width << "," << nl;
-  out << indent(4) << "\"height\": " << world.height << "," << nl;
-  out << indent(4) << "\"unit_count\": " << world.units.size() << "," << nl;
-  out << indent(4) << "\"obstacles_count\": " << obstacles_count << nl;
-  out << indent(2) << "}," << nl;
+  line(2).raw("\"world\": {");
+  line(4).raw("\"width\": ").number(world.width).put(',');
+  line(4).raw("\"height\": ").number(world.height).put(',');
+  line(4).raw("\"unit_count\": ").number(world.units.size()).put(',');
+  line(4).raw("\"obstacles_count\": ").number(obstacles_count).put(',');
+  line(4).raw("\"components_count\": ").number(components_count);
+  line(2).raw("},");
 
   // targets
-  out << indent(2) << "\"targets\": [" << nl;
+  line(2).raw("\"targets\": [");
   for (std::size_t i = 0; i < targets.size(); ++i)
   {
-    out << indent(4) << "{"
-        << "\"unit\": \"" << targets[i].unit << "\"," << sp
-        << "\"tx\": " << targets[i].tx << "," << sp
-        << "\"ty\": " << targets[i].ty << "}";
-    if (i + 1 < targets.size()) out << ",";
-    out << nl;
+    line(4).raw("{\"unit\": ").string(targets[i].unit).put(',').raw(sp);
+    out.raw("\"tx\": ").number(targets[i].tx).put(',').raw(sp);
+    out.raw("\"ty\": ").number(targets[i].ty).put('}');
+    if (i + 1 < targets.size()) out.put(',');
   }
-  out << indent(2) << "]," << nl;
+  line(2).raw("],");
 
   // units
-  out << indent(2) << "\"units\": [" << nl;
+  line(2).raw("\"units\": [");
   for (std::size_t i = 0; i < world.units.size(); ++i)
   {
     const auto& u = world.units[i];
-    out << indent(4) << "{"
-        << "\"id\": " << u.id << "," << sp
-        << "\"name\": \"" << u.name << "\"," << sp
-        << "\"pos\": ";
+    line(4).raw("{\"id\": ").number(u.id).put(',').raw(sp);
+    out.raw("\"name\": ").string(u.name).put(',').raw(sp);
+    out.raw("\"pos\": ");
     write_json_vec2(out, u.pos.x, u.pos.y);
-    out << "}";
-    if (i + 1 < world.units.size()) out << ",";
-    out << nl;
+    out.put('}');
+    if (i + 1 < world.units.size()) out.put(',');
   }
-  out << indent(2) << "]," << nl;
+  line(2).raw("],");
 
   // plans
-  out << indent(2) << "\"plans\": [" << nl;
+  line(2).raw("\"plans\": [");
   for (std::size_t i = 0; i < plans.size(); ++i)
   {
     const auto& p = plans[i];
     const int steps = (p.found && emit_paths && !p.path.empty()) ? static_cast<int>(p.path.size()) - 1 : 0;
 
-    out << indent(4) << "{" << nl;
-    out << indent(6) << "\"unit\": \"" << p.unit << "\"," << nl;
-    out << indent(6) << "\"start\": ";
+    line(4).put('{');
+    line(6).raw("\"unit\": ").string(p.unit).put(',');
+    line(6).raw("\"start\": ");
     write_json_vec2(out, p.start.x, p.start.y);
-    out << "," << nl;
-    out << indent(6) << "\"goal\": ";
+    out.put(',');
+    line(6).raw("\"goal\": ");
     write_json_vec2(out, p.goal.x, p.goal.y);
-    out << "," << nl;
-    out << indent(6) << "\"found\": " << (p.found ? "true" : "false") << "," << nl;
-    out << indent(6) << "\"cost\": " << p.cost << "," << nl;
-    out << indent(6) << "\"steps\": " << steps;
+    out.put(',');
+    line(6).raw("\"found\": ").boolean(p.found).put(',');
+    line(6).raw("\"cost\": ").number(p.cost).put(',');
+    line(6).raw("\"steps\": ").number(steps);
 
     if (emit_paths)
     {
-      out << "," << nl;
-      out << indent(6) << "\"path\": ";
+      out.put(',');
+      line(6).raw("\"path\": ");
       write_path(out, p.path, pretty, 8);
-      out << nl;
     }
-    else
+
+    line(4).put('}');
+    if (i + 1 < plans.size()) out.put(',');
+  }
+  line(2).put(']');
+  line(0).put('}').raw(nl);
+  return out.flush();
+}
+
+// Target of each unit by name; a unit listed more than once keeps its first target.
+static std::unordered_map<std::string_view, const rescueops::sim::ScenarioTarget*> targets_by_unit(
+  const std::vector<rescueops::sim::ScenarioTarget>& targets)
+{
+  std::unordered_map<std::string_view, const rescueops::sim::ScenarioTarget*> out;
+  out.reserve(targets.size());
+  for (const auto& t : targets) out.emplace(t.unit, &t);
+  return out;
+}
+
+// Monte Carlo batch: RUNS seeds (seed, seed + 1, ...) forked from the loaded engine state.
+// The grid, planner precompute and per-unit goals are built once and shared read-only by the
+// runs; each pool worker plans with its own SearchContext. One JSON line per run goes to `out`
+// (if open) in seed order as runs finish; the summary goes to stdout.
+static int run_monte_carlo(const rescueops::sim::Engine& eng,
+                           const rescueops::planner::Grid& grid,
+                           const std::vector<rescueops::sim::ScenarioTarget>& targets,
+                           rescueops::sim::Tick ticks,
+                           std::size_t runs,
+                           rescueops::planner::PlanConfig plan_cfg,
+                           int cluster_size,
+                           rescueops::sim::ThreadPool& pool,
+                           std::ostream* out)
+{
+  const std::string base = eng.checkpoint();
+  if (base.empty())
+  {
+    std::cerr << "Failed to snapshot the scenario for Monte Carlo runs\n";
+    return 1;
+  }
+
+  const rescueops::planner::BitGrid bits(grid);
+  rescueops::planner::ComponentLabels components;
+  components.build(grid);
+  plan_cfg.bits = &bits;
+  plan_cfg.components = &components;
+
+  // Goal per unit row; rows and names are the same in every run
+  struct Goal
+  {
+    std::size_t row = 0;
+    rescueops::sim::Vec2i at{};
+  };
+  std::vector<Goal> goals;
+  const auto& units = eng.world().units;
+  const auto target_of = targets_by_unit(targets);
+  for (std::size_t i = 0; i < units.size(); ++i)
+  {
+    const auto it = target_of.find(units.name(i));
+    if (it == target_of.end()) continue;
+    const auto& t = *it->second;
+    if (t.tx >= 0 && t.ty >= 0 && t.tx < grid.w && t.ty < grid.h) goals.push_back(Goal{i, {t.tx, t.ty}});
+  }
+
+  rescueops::planner::HierarchicalPlanner hierarchy(cluster_size);
+  if (plan_cfg.algorithm == rescueops::planner::Algorithm::Hpa)
+  {
+    hierarchy.build(grid, pool);
+    plan_cfg.hierarchy = &hierarchy;
+  }
+  // Goals do not move between runs, so one set of flow fields serves them all
+  rescueops::planner::FlowFieldCache flow_fields;
+  if (plan_cfg.algorithm == rescueops::planner::Algorithm::FlowField)
+  {
+    std::vector<rescueops::sim::Vec2i> goal_cells;
+    for (const auto& g : goals) goal_cells.push_back(g.at);
+    // Every run queries each goal again, so a goal k units share is queried k * runs times
+    const std::size_t min_share = (plan_cfg.flow_min_share + runs - 1) / runs;
+    flow_fields.prepare(grid, goal_cells, pool, min_share);
+    plan_cfg.flow_fields = &flow_fields;
+  }
+
+  std::vector<rescueops::planner::SearchContext> contexts(pool.size());
+  const auto measure = [&](const rescueops::sim::Engine& run, unsigned worker, std::span<double> m) {
+    double found = 0, total = 0, worst = 0;
+    for (const auto& g : goals)
     {
-      out << nl;
+      const auto res =
+        rescueops::planner::find_path(plan_cfg, grid, run.world().units.pos(g.row), g.at, contexts[worker]);
+      if (!res) continue;
+      found += 1;
+      total += res->cost;
+      worst = std::max(worst, static_cast<double>(res->cost));
     }
+    m[0] = found;
+    m[1] = total;
+    m[2] = worst;
+  };
+
+  rescueops::sim::MonteCarlo mc({"found", "total_cost", "max_cost"});
+  if (out) out->precision(17);
+  const auto sink = [&](std::size_t run, std::uint64_t seed, std::span<const double> m) {
+    if (!out) return;
+    *out << "{\"run\": " << run << ", \"seed\": " << seed << ", \"found\": " << m[0] << ", \"total_cost\": " << m[1]
+         << ", \"max_cost\": " << m[2] << "}\n";
+  };
 
-    out << indent(4) << "}";
-    if (i + 1 < plans.size()) out << ",";
-    out << nl;
+  rescueops::sim::MonteCarloConfig cfg;
+  cfg.first_seed = eng.seed();
+  cfg.runs = runs;
+  cfg.ticks = ticks;
+  const auto t0 = std::chrono::steady_clock::now();
+  if (!mc.run(base, cfg, pool, measure, sink))
+  {
+    std::cerr << "Monte Carlo runs failed to start\n";
+    return 1;
   }
-  out << indent(2) << "]" << nl;
+  const std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - t0;
 
-  out << "}" << nl;
+  std::cout << "Monte Carlo: " << mc.runs() << " runs, seeds " << cfg.first_seed << ".."
+            << cfg.first_seed + runs - 1 << ", " << ticks << " ticks, " << pool.size() << " threads (" << ms.count()
+            << " ms)\n";
+  for (const auto& s : mc.summary())
+  {
+    std::cout << "  " << s.name << ": mean " << s.mean << " stdev " << s.stdev << " min " << s.min << " p50 " << s.p50
+              << " p90 " << s.p90 << " p99 " << s.p99 << " max " << s.max << "\n";
+  }
+  return 0;
 }
 
 int main(int argc, char** argv)
@@ -427,6 +469,25 @@ int main(int argc, char** argv)
   std::optional<std::uint64_t> seed_override;
   bool pretty = false;
   bool emit_paths = false;
+  auto algorithm = rescueops::planner::Algorithm::AStar;
+  int cluster_size = 16;
+  auto open_list = rescueops::planner::OpenList::BinaryHeap;
+  unsigned threads = 1;
+  auto motion_rng = rescueops::sim::MotionRng::Mt19937;
+  rescueops::sim::Tick checkpoint_every = 0;
+  std::string checkpoint_prefix = "checkpoint_";
+  std::string resume_path;
+  std::size_t monte_carlo_runs = 0;
+  std::string compile_in;
+  std::string compile_out;
+  std::string tiles_in;
+  std::string tiles_out;
+  int tile_size = rescueops::planner::kDefaultTileSize;
+  std::string trajectory_path;
+  rescueops::sim::TrajectoryOptions trajectory_options;
+  trajectory_options.background = true;
+  std::string frame_path;
+  rescueops::sim::Tick frame = 0;
 
   for (int i = 1; i < argc; ++i)
   {
@@ -466,85 +527,317 @@ int main(int argc, char** argv)
       emit_paths = true;
       continue;
     }
+    if (a == "--planner" && i + 1 < argc)
+    {
+      const auto parsed = rescueops::planner::parse_algorithm(argv[++i]);
+      if (!parsed)
+      {
+        std::cerr << "Unknown planner: " << argv[i] << "\n";
+        usage();
+        return 2;
+      }
+      algorithm = *parsed;
+      continue;
+    }
+    if (a == "--open-list" && i + 1 < argc)
+    {
+      const auto parsed = rescueops::planner::parse_open_list(argv[++i]);
+      if (!parsed)
+      {
+        std::cerr << "Unknown open list: " << argv[i] << "\n";
+        usage();
+        return 2;
+      }
+      open_list = *parsed;
+      continue;
+    }
+    if (a == "--threads" && i + 1 < argc)
+    {
+      threads = static_cast<unsigned>(std::stoul(argv[++i]));
+      continue;
+    }
+    if (a == "--rng" && i + 1 < argc)
+    {
+      const auto parsed = rescueops::sim::parse_motion_rng(argv[++i]);
+      if (!parsed)
+      {
+        std::cerr << "Unknown rng: " << argv[i] << "\n";
+        usage();
+        return 2;
+      }
+      motion_rng = *parsed;
+      continue;
+    }
+    if (a == "--checkpoint-every" && i + 1 < argc)
+    {
+      checkpoint_every = static_cast<rescueops::sim::Tick>(std::stoull(argv[++i]));
+      continue;
+    }
+    if (a == "--checkpoint-prefix" && i + 1 < argc)
+    {
+      checkpoint_prefix = argv[++i];
+      continue;
+    }
+    if (a == "--resume" && i + 1 < argc)
+    {
+      resume_path = argv[++i];
+      continue;
+    }
+    if (a == "--monte-carlo" && i + 1 < argc)
+    {
+      monte_carlo_runs = static_cast<std::size_t>(std::stoull(argv[++i]));
+      continue;
+    }
+    if (a == "--cluster-size" && i + 1 < argc)
+    {
+      cluster_size = std::stoi(argv[++i]);
+      continue;
+    }
     if (a == "--ascii" && i + 1 < argc)
     {
       ascii_path = argv[++i];
       continue;
     }
+    if (a == "--compile" && i + 2 < argc)
+    {
+      compile_in = argv[++i];
+      compile_out = argv[++i];
+      continue;
+    }
+    if (a == "--compile-tiles" && i + 2 < argc)
+    {
+      tiles_in = argv[++i];
+      tiles_out = argv[++i];
+      continue;
+    }
+    if (a == "--tile-size" && i + 1 < argc)
+    {
+      tile_size = std::stoi(argv[++i]);
+      continue;
+    }
+    if (a == "--trajectory" && i + 1 < argc)
+    {
+      trajectory_path = argv[++i];
+      continue;
+    }
+    if (a == "--trajectory-chunk" && i + 1 < argc)
+    {
+      trajectory_options.chunk_frames = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+      continue;
+    }
+    if (a == "--trajectory-frame" && i + 2 < argc)
+    {
+      frame_path = argv[++i];
+      frame = static_cast<rescueops::sim::Tick>(std::stoull(argv[++i]));
+      continue;
+    }
 
     std::cerr << "Unknown arg: " << a << "\n";
     usage();
     return 2;
   }
 
-  rescueops::sim::Engine eng;
-  if (!eng.load_scenario(scenario_path))
+  if (!compile_in.empty()) return compile_scenario(compile_in, compile_out);
+  if (!tiles_in.empty()) return compile_tiles(tiles_in, tiles_out, tile_size);
+  if (!frame_path.empty()) return print_trajectory_frame(frame_path, frame);
+  if (!trajectory_path.empty() && monte_carlo_runs > 0)
   {
-    std::cerr << "Failed to load scenario: " << scenario_path << "\n";
+    std::cerr << "--trajectory records a single run and cannot be combined with --monte-carlo\n";
+    return 2;
+  }
+
+  // A compiled image is mapped and read in place; JSON is parsed in one pass. Either way the
+  // targets are views into the loaded scenario.
+  rescueops::sim::Scenario scenario;
+  rescueops::sim::CompiledScenario compiled;
+  std::string scenario_error;
+  const bool loaded = rescueops::sim::is_compiled_scenario(scenario_path)
+                        ? compiled.open(scenario_path, &scenario_error)
+                        : rescueops::sim::load_scenario_file(scenario_path, scenario, &scenario_error);
+  if (!loaded)
+  {
+    std::cerr << "Failed to load scenario: " << scenario_path << " (" << scenario_error << ")\n";
     return 1;
   }
+
+  rescueops::sim::Engine eng;
+  std::vector<rescueops::sim::ScenarioTarget> targets;
+  if (compiled.is_open())
+  {
+    eng.load(compiled);
+    targets.reserve(compiled.target_count());
+    for (std::size_t i = 0; i < compiled.target_count(); ++i) targets.push_back(compiled.target(i));
+  }
+  else
+  {
+    eng.load(scenario);
+    targets = std::move(scenario.targets);
+  }
   if (seed_override) eng.set_seed(*seed_override);
+  eng.set_motion_rng(motion_rng);
 
-  // Parse optional demo fields from scenario text (dependency-free)
-  const std::string scenario_text = read_all_text(scenario_path);
-  const auto targets = parse_targets(scenario_text);
+  // Worker pool shared by the tick update, the precompute and the per-unit queries
+  rescueops::sim::ThreadPool pool(threads);
+  eng.set_thread_pool(&pool);
 
-  // Run simulation core (deterministic scheduler; movement is a roadmap item)
-  const auto rr = eng.run(ticks);
+  // Continue a checkpointed run: the snapshot replaces the scenario's world, seed and RNG mode
+  if (!resume_path.empty() && !eng.load_checkpoint(resume_path))
+  {
+    std::cerr << "Failed to load checkpoint: " << resume_path << "\n";
+    return 1;
+  }
 
   // Build a planning grid from scenario (obstacles are used in A* + ASCII)
   rescueops::planner::Grid grid;
   grid.w = eng.world().width;
   grid.h = eng.world().height;
   grid.blocked.assign(static_cast<std::size_t>(grid.w * grid.h), 0);
+  int obstacles_count = 0;
+  if (!compiled.is_open())
+  {
+    obstacles_count = static_cast<int>(rescueops::sim::rasterize_obstacles(scenario, grid.w, grid.h, grid.blocked));
+  }
+  else if (grid.w == compiled.width() && grid.h == compiled.height())
+  {
+    compiled.unpack_blocked(grid.blocked);
+    obstacles_count = static_cast<int>(compiled.blocked_count());
+  }
+  else
+  {
+    std::cerr << "Checkpoint world size differs from the compiled scenario's\n";
+    return 1;
+  }
+
+  if (monte_carlo_runs > 0)
+  {
+    if (checkpoint_every > 0)
+    {
+      std::cerr << "--checkpoint-every cannot be combined with --monte-carlo\n";
+      return 2;
+    }
+    rescueops::planner::PlanConfig mc_cfg;
+    mc_cfg.algorithm = algorithm;
+    mc_cfg.open_list = open_list;
+    std::ofstream runs_out;
+    if (!out_path.empty())
+    {
+      runs_out.open(out_path, std::ios::binary);
+      if (!runs_out)
+      {
+        std::cerr << "Failed to open output file: " << out_path << "\n";
+        return 3;
+      }
+    }
+    return run_monte_carlo(eng, grid, targets, ticks, monte_carlo_runs, mc_cfg, cluster_size, pool,
+                           runs_out.is_open() ? &runs_out : nullptr);
+  }
+
+  // Positions of every tick go to the trajectory file; chunks are written by a background thread
+  rescueops::sim::TrajectoryRecorder recorder;
+  if (!trajectory_path.empty())
+  {
+    std::string error;
+    if (!recorder.open(trajectory_path, trajectory_options, &error))
+    {
+      std::cerr << "Failed to open trajectory file: " << error << "\n";
+      return 3;
+    }
+    eng.set_trajectory_recorder(&recorder);
+  }
+
+  // Run simulation core (deterministic scheduler), stopping at every checkpoint tick
+  while (checkpoint_every > 0 && eng.tick() < ticks)
+  {
+    const rescueops::sim::Tick stop = std::min(ticks, (eng.tick() / checkpoint_every + 1) * checkpoint_every);
+    eng.run(stop);
+    if (stop % checkpoint_every != 0) break;
+    const std::string path = checkpoint_prefix + std::to_string(stop) + ".bin";
+    if (!eng.save_checkpoint(path))
+    {
+      std::cerr << "Failed to write checkpoint: " << path << "\n";
+      return 1;
+    }
+  }
+  const auto rr = eng.run(ticks);
+  if (recorder.is_open())
+  {
+    eng.set_trajectory_recorder(nullptr);
+    std::string error;
+    if (!recorder.close(&error))
+    {
+      std::cerr << "Failed to write trajectory: " << error << "\n";
+      return 3;
+    }
+    std::cout << "Wrote: " << trajectory_path << " (" << recorder.frames() << " frames, " << recorder.bytes()
+              << " bytes)\n";
+  }
+
+  const rescueops::planner::BitGrid bits(grid);
 
-  const int obstacles_count = apply_obstacles(scenario_text, grid.w, grid.h, grid.blocked);
+  // Connected components of free space: unreachable goals are rejected without searching
+  rescueops::planner::ComponentLabels components;
+  components.build(grid);
 
-  // Plan paths (A*) per-unit
+  // Hierarchical planning precomputes its cluster abstraction once per grid
+  rescueops::planner::HierarchicalPlanner hierarchy(cluster_size);
+  rescueops::planner::PlanConfig plan_cfg;
+  plan_cfg.algorithm = algorithm;
+  plan_cfg.open_list = open_list;
+  plan_cfg.bits = &bits;
+  plan_cfg.components = &components;
+  if (algorithm == rescueops::planner::Algorithm::Hpa)
+  {
+    hierarchy.build(grid, pool);
+    plan_cfg.hierarchy = &hierarchy;
+  }
+
+  // Collect one query per unit with an in-bounds goal; results come back in query order
   std::vector<PlanOut> plans;
   plans.reserve(eng.world().units.size());
+  std::vector<rescueops::planner::PlanQuery> queries;
+  std::vector<std::size_t> query_plan; // queries[i] answers plans[query_plan[i]]
 
+  const auto target_of = targets_by_unit(targets);
   for (const auto& u : eng.world().units)
   {
     PlanOut po;
     po.unit = u.name;
     po.start = u.pos;
 
-    bool has_goal = false;
-    for (const auto& t : targets)
-    {
-      if (t.unit == u.name)
-      {
-        po.goal = {t.tx, t.ty};
-        has_goal = true;
-        break;
-      }
-    }
+    const auto target = target_of.find(u.name);
+    const bool has_goal = target != target_of.end();
+    if (has_goal) po.goal = {target->second->tx, target->second->ty};
 
-    if (!has_goal)
+    if (has_goal && po.goal.x >= 0 && po.goal.y >= 0 && po.goal.x < grid.w && po.goal.y < grid.h)
     {
-      plans.push_back(po);
-      continue;
+      queries.push_back(rescueops::planner::PlanQuery{po.start, po.goal});
+      query_plan.push_back(plans.size());
     }
-
-    if (po.goal.x >= 0 && po.goal.y >= 0 && po.goal.x < grid.w && po.goal.y < grid.h)
-    {
-      auto res = rescueops::planner::astar(grid, po.start, po.goal);
-      if (res)
-      {
-        po.found = true;
-        po.cost = res->cost;
-        if (emit_paths) po.path = res->path;
-      }
-    }
-
     plans.push_back(po);
   }
 
+  const auto plan_t0 = std::chrono::steady_clock::now();
+  rescueops::planner::BatchPlanner batch(pool);
+  const auto results = batch.plan(plan_cfg, grid, queries);
+  const std::size_t nodes_expanded = batch.stats().expanded;
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    if (!results[i]) continue;
+    auto& po = plans[query_plan[i]];
+    po.found = true;
+    po.cost = results[i]->cost;
+    if (emit_paths) po.path = results[i]->path;
+  }
+  const std::chrono::duration<double, std::milli> plan_ms = std::chrono::steady_clock::now() - plan_t0;
+
   // ASCII map (now shows obstacles + optional paths)
-  const std::string ascii = render_ascii_map(eng.world(), targets, plans, grid.blocked, emit_paths);
+  const std::string ascii = render_ascii_map(eng.world(), targets, plans, bits, emit_paths);
   std::cout << ascii << "\n";
   std::cout << "Obstacles loaded: " << obstacles_count << "\n";
+  std::cout << "Components: " << components.component_count() << "\n";
+  std::cout << "Planner: " << rescueops::planner::algorithm_name(algorithm) << "/"
+            << rescueops::planner::open_list_name(open_list) << " (" << nodes_expanded
+            << " nodes expanded, " << plan_ms.count() << " ms)\n";
 
   if (!ascii_path.empty())
   {
@@ -569,7 +862,12 @@ int main(int argc, char** argv)
       return 3;
     }
 
-    write_results_json(out, scenario_path, ticks, rr, eng.world(), obstacles_count, targets, plans, pretty, emit_paths);
+    if (!write_results_json(out, scenario_path, ticks, rr, eng.world(), obstacles_count, components.component_count(),
+                            targets, plans, pretty, emit_paths))
+    {
+      std::cerr << "Failed to write output file: " << out_path << "\n";
+      return 3;
+    }
     std::cout << "Wrote: " << out_path << "\n";
   }
 
@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Minimal, dependency-free timing helpers for the bench_* executables.
+// Each benchmark prints one line: name, iterations, total and per-iteration wall time. Benchmarks
+// fold their results into a printed checksum so the work cannot be optimized away.
+
+namespace bench
+{
+  using Clock = std::chrono::steady_clock;
+
+  inline double elapsed_ms(Clock::time_point t0)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  }
+
+  inline void report(const std::string& name,
+                     std::size_t iterations,
+                     double total_ms,
+                     const std::string& extra = {})
+  {
+    std::printf("%-44s %10zu it %12.3f ms %12.3f us/it  %s\n", name.c_str(), iterations, total_ms,
+                iterations ? total_ms * 1000.0 / static_cast<double>(iterations) : 0.0, extra.c_str());
+  }
+
+} // namespace bench
@@ -0,0 +1,159 @@
+#include "bench_common.hpp"
+
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "planner/bitgrid.hpp"
+#include "planner/paged_grid.hpp"
+#include "planner/plan.hpp"
+
+using rescueops::planner::Algorithm;
+using rescueops::planner::Grid;
+using rescueops::planner::OpenList;
+using rescueops::planner::PlanConfig;
+using rescueops::planner::SearchContext;
+using rescueops::sim::Vec2i;
+
+// Open terrain: scattered single-cell rubble.
+static Grid open_grid(int w, int h, unsigned density_pct, std::uint64_t seed)
+{
+  std::mt19937_64 rng(seed);
+  Grid g;
+  g.w = w;
+  g.h = h;
+  g.blocked.resize(static_cast<std::size_t>(w) * static_cast<std::size_t>(h));
+  for (auto& b : g.blocked) b = (rng() % 100) < density_pct ? 1 : 0;
+  return g;
+}
+
+// Perfect maze (iterative backtracker) on odd coordinates: long corridors, many dead ends.
+static Grid maze_grid(int w, int h, std::uint64_t seed)
+{
+  std::mt19937_64 rng(seed);
+  Grid g;
+  g.w = w;
+  g.h = h;
+  g.blocked.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), 1);
+  const auto at = [&](int x, int y) -> std::uint8_t& { return g.blocked[static_cast<std::size_t>(y) * w + x]; };
+
+  std::vector<Vec2i> stack{{1, 1}};
+  at(1, 1) = 0;
+  const int dirs[4][2] = {{2, 0}, {-2, 0}, {0, 2}, {0, -2}};
+  while (!stack.empty())
+  {
+    const Vec2i c = stack.back();
+    int options[4];
+    int n = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      const int nx = c.x + dirs[i][0];
+      const int ny = c.y + dirs[i][1];
+      if (nx > 0 && ny > 0 && nx < w - 1 && ny < h - 1 && at(nx, ny) != 0) options[n++] = i;
+    }
+    if (n == 0)
+    {
+      stack.pop_back();
+      continue;
+    }
+    const int d = options[rng() % static_cast<unsigned>(n)];
+    at(c.x + dirs[d][0] / 2, c.y + dirs[d][1] / 2) = 0;
+    at(c.x + dirs[d][0], c.y + dirs[d][1]) = 0;
+    stack.push_back(Vec2i{c.x + dirs[d][0], c.y + dirs[d][1]});
+  }
+  return g;
+}
+
+static std::vector<std::pair<Vec2i, Vec2i>> free_pairs(const Grid& g, std::size_t n, std::uint64_t seed)
+{
+  std::mt19937_64 rng(seed);
+  const auto pick = [&] {
+    while (true)
+    {
+      const Vec2i p{static_cast<int>(rng() % static_cast<unsigned>(g.w)),
+                    static_cast<int>(rng() % static_cast<unsigned>(g.h))};
+      if (!g.is_blocked(p.x, p.y)) return p;
+    }
+  };
+  std::vector<std::pair<Vec2i, Vec2i>> out;
+  for (std::size_t i = 0; i < n; ++i) out.emplace_back(pick(), pick());
+  return out;
+}
+
+static void run(const std::string& label, const Grid& g, const std::vector<std::pair<Vec2i, Vec2i>>& queries,
+                Algorithm algo, OpenList open_list)
+{
+  const rescueops::planner::BitGrid bits(g);
+  PlanConfig cfg;
+  cfg.algorithm = algo;
+  cfg.open_list = open_list;
+  cfg.bits = &bits;
+
+  SearchContext ctx;
+  std::size_t expanded = 0;
+  long long checksum = 0;
+  const auto t0 = bench::Clock::now();
+  for (const auto& [s, t] : queries)
+  {
+    const auto res = rescueops::planner::find_path(cfg, g, s, t, ctx);
+    expanded += ctx.stats().expanded;
+    checksum += res ? res->cost : -1;
+  }
+  const double ms = bench::elapsed_ms(t0);
+  bench::report(label + " " + rescueops::planner::algorithm_name(algo) + "/" +
+                  rescueops::planner::open_list_name(open_list),
+                queries.size(), ms,
+                "expanded/query=" + std::to_string(expanded / std::max<std::size_t>(1, queries.size())) +
+                  " checksum=" + std::to_string(checksum));
+}
+
+// Plain A* against a PagedGrid of 128x128 tiles with a given tile cache budget.
+static void run_paged(const std::string& label, const std::string& tiles, const std::vector<std::pair<Vec2i, Vec2i>>& queries,
+                      std::size_t budget)
+{
+  rescueops::planner::PagedGrid paged;
+  if (!paged.open(tiles, budget)) return;
+  SearchContext ctx;
+  std::size_t expanded = 0;
+  long long checksum = 0;
+  const auto t0 = bench::Clock::now();
+  for (const auto& [s, t] : queries)
+  {
+    const auto res = rescueops::planner::astar(paged, s, t, ctx);
+    expanded += ctx.stats().expanded;
+    checksum += res ? res->cost : -1;
+  }
+  const double ms = bench::elapsed_ms(t0);
+  const auto& st = paged.stats();
+  bench::report(label + " paged budget=" + std::to_string(budget / 1024) + "KiB", queries.size(), ms,
+                "expanded/query=" + std::to_string(expanded / std::max<std::size_t>(1, queries.size())) +
+                  " hits=" + std::to_string(st.hits) + " misses=" + std::to_string(st.misses) +
+                  " evictions=" + std::to_string(st.evictions) + " checksum=" + std::to_string(checksum));
+}
+
+int main()
+{
+  const Grid open = open_grid(1024, 1024, 20, 1);
+  const Grid maze = maze_grid(511, 511, 2);
+  const auto open_q = free_pairs(open, 200, 3);
+  const auto maze_q = free_pairs(maze, 200, 4);
+
+  for (const auto algo : {Algorithm::AStar, Algorithm::Jps})
+  {
+    for (const auto ol : {OpenList::BinaryHeap, OpenList::Buckets})
+    {
+      run("open 1024x1024 20%", open, open_q, algo, ol);
+      run("maze 511x511", maze, maze_q, algo, ol);
+    }
+  }
+
+  // 64 tiles of 2 KiB: everything resident, a quarter of them, and two.
+  const std::string tiles = (std::filesystem::temp_directory_path() / "rescueops_bench_planner.tiles").string();
+  if (rescueops::planner::write_tile_file(tiles, open, 128))
+  {
+    for (const std::size_t budget : {std::size_t{128} << 10, std::size_t{32} << 10, std::size_t{4} << 10})
+      run_paged("open 1024x1024 20%", tiles, open_q, budget);
+    std::filesystem::remove(tiles);
+  }
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include "bench_common.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sim/engine.hpp"
+#include "sim/json_writer.hpp"
+#include "sim/trajectory.hpp"
+#include "sim/world.hpp"
+
+using rescueops::sim::JsonWriter;
+using rescueops::sim::Vec2i;
+
+// The plan entries of results.json with --emit-paths: `plans` paths of `length` points each.
+static std::vector<std::vector<Vec2i>> make_paths(std::size_t plans, std::size_t length)
+{
+  std::vector<std::vector<Vec2i>> paths(plans);
+  std::uint64_t h = 1;
+  for (auto& p : paths)
+  {
+    Vec2i c{static_cast<int>(h % 4096), static_cast<int>((h >> 12) % 4096)};
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      h = h * 6364136223846793005ull + 1442695040888963407ull;
+      (h >> 63 ? c.x : c.y) += (h >> 62) & 1 ? 1 : -1;
+      p.push_back(c);
+    }
+  }
+  return paths;
+}
+
+// The former writer: one ostream insertion per token.
+static void write_ostream(std::ostream& out, const std::vector<std::vector<Vec2i>>& paths, bool pretty)
+{
+  for (std::size_t k = 0; k < paths.size(); ++k)
+  {
+    const auto& path = paths[k];
+    out << (pretty ? "    {\n      \"unit\": \"" : "{\"unit\": \"") << "u" << k << "\"," << (pretty ? "\n      " : "")
+        << "\"path\": [";
+    if (pretty) out << "\n";
+    for (std::size_t i = 0; i < path.size(); ++i)
+    {
+      if (pretty) out << std::string(8, ' ');
+      out << "{\"x\": " << path[i].x << ", \"y\": " << path[i].y << "}";
+      if (i + 1 < path.size()) out << ",";
+      if (pretty) out << "\n";
+    }
+    if (pretty) out << std::string(6, ' ');
+    out << "]" << (pretty ? "\n    }" : "}") << (k + 1 < paths.size() ? "," : "") << (pretty ? "\n" : "");
+  }
+}
+
+static void write_buffered(std::ostream& stream, const std::vector<std::vector<Vec2i>>& paths, bool pretty)
+{
+  JsonWriter out(stream);
+  for (std::size_t k = 0; k < paths.size(); ++k)
+  {
+    const auto& path = paths[k];
+    std::string unit = "u";
+    unit += std::to_string(k);
+    out.raw(pretty ? "    {\n      \"unit\": " : "{\"unit\": ").string(unit).put(',');
+    out.raw(pretty ? "\n      " : "").raw("\"path\": [");
+    if (pretty) out.put('\n');
+    for (std::size_t i = 0; i < path.size(); ++i)
+    {
+      if (pretty) out.spaces(8);
+      out.raw("{\"x\": ").number(path[i].x).raw(", \"y\": ").number(path[i].y).put('}');
+      if (i + 1 < path.size()) out.put(',');
+      if (pretty) out.put('\n');
+    }
+    if (pretty) out.spaces(6);
+    out.put(']').raw(pretty ? "\n    }" : "}").raw(k + 1 < paths.size() ? "," : "").raw(pretty ? "\n" : "");
+  }
+}
+
+static void run(const std::vector<std::vector<Vec2i>>& paths, bool pretty, bool buffered, int reps)
+{
+  const auto file = (std::filesystem::temp_directory_path() / "rescueops_bench_results.json").string();
+  double ms = 0;
+  std::uintmax_t bytes = 0;
+  for (int r = 0; r < reps; ++r)
+  {
+    const auto t0 = bench::Clock::now();
+    {
+      std::ofstream out(file, std::ios::binary | std::ios::trunc);
+      buffered ? write_buffered(out, paths, pretty) : write_ostream(out, paths, pretty);
+    }
+    ms += bench::elapsed_ms(t0);
+    bytes = std::filesystem::file_size(file);
+  }
+  std::filesystem::remove(file);
+  bench::report(std::string("plans+paths ") + (pretty ? "pretty " : "compact ") + (buffered ? "JsonWriter" : "ostream"),
+                static_cast<std::size_t>(reps), ms,
+                "MB=" + std::to_string(static_cast<double>(bytes) / 1e6) +
+                  " MB/s=" + std::to_string(static_cast<double>(bytes) * reps / 1000.0 / ms));
+}
+
+// 10k units random-walking on a 4096x4096 map for 1000 ticks, without a recorder, recording
+// on the simulation thread and recording with the background writer; then reading it back.
+static void trajectory(int mode)
+{
+  constexpr std::size_t kUnits = 10'000;
+  constexpr rescueops::sim::Tick kTicks = 1000;
+  rescueops::sim::Scenario s;
+  s.world.width = 4096;
+  s.world.height = 4096;
+  for (std::size_t i = 0; i < kUnits; ++i)
+  {
+    const std::uint64_t h = (i + 1) * 0x9E3779B97F4A7C15ull;
+    s.world.units.push_back(static_cast<std::uint32_t>(i + 1), "u",
+                            Vec2i{static_cast<int>((h >> 20) % 4096), static_cast<int>((h >> 40) % 4096)});
+  }
+  rescueops::sim::Engine eng;
+  eng.load(s);
+  eng.set_motion_rng(rescueops::sim::MotionRng::Philox);
+
+  const auto file = (std::filesystem::temp_directory_path() / "rescueops_bench.rtraj").string();
+  rescueops::sim::TrajectoryRecorder rec;
+  rescueops::sim::TrajectoryOptions options;
+  options.background = mode == 2;
+  if (mode > 0)
+  {
+    rec.open(file, options);
+    eng.set_trajectory_recorder(&rec);
+  }
+  const auto t0 = bench::Clock::now();
+  eng.run(kTicks);
+  if (mode > 0) rec.close();
+  const double ms = bench::elapsed_ms(t0);
+  const char* names[] = {"no recorder", "recorder inline", "recorder background"};
+  std::string extra;
+  if (mode > 0)
+    extra = "bytes/frame=" + std::to_string(rec.bytes() / rec.frames()) +
+            " raw=" + std::to_string(kUnits * 8) + " MB=" + std::to_string(static_cast<double>(rec.bytes()) / 1e6);
+  bench::report(std::string("run 10k units 1000 ticks, ") + names[mode], static_cast<std::size_t>(kTicks), ms, extra);
+  if (mode != 2) return;
+
+  rescueops::sim::TrajectoryReader reader;
+  if (!reader.open(file)) return;
+  std::vector<std::uint32_t> ids;
+  std::vector<int> x, y;
+  long long checksum = 0;
+  auto t1 = bench::Clock::now();
+  for (rescueops::sim::Tick f = 0; f <= kTicks; ++f)
+  {
+    reader.read_frame(f, ids, x, y);
+    checksum += x[f % kUnits];
+  }
+  bench::report("trajectory read every frame in order", static_cast<std::size_t>(kTicks + 1), bench::elapsed_ms(t1),
+                "checksum=" + std::to_string(checksum));
+  t1 = bench::Clock::now();
+  std::uint64_t h = 5;
+  for (int i = 0; i < 200; ++i)
+  {
+    h = h * 6364136223846793005ull + 1442695040888963407ull;
+    reader.read_frame((h >> 33) % (kTicks + 1), ids, x, y);
+    checksum += y[i];
+  }
+  bench::report("trajectory read random frames", 200, bench::elapsed_ms(t1), "checksum=" + std::to_string(checksum));
+  std::filesystem::remove(file);
+}
+
+int main()
+{
+  const auto paths = make_paths(5000, 400);
+  for (const bool pretty : {false, true})
+  {
+    run(paths, pretty, false, 3);
+    run(paths, pretty, true, 3);
+  }
+  for (const int mode : {0, 1, 2}) trajectory(mode);
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "sim/obstacles.hpp"
+#include "sim/scenario.hpp"
+
+using rescueops::sim::Scenario;
+
+// A scenario in the layout the editors write: one key per line, two-space indent.
+static std::string make_scenario(std::size_t units, std::size_t obstacles, int side)
+{
+  std::string s = "{\n \"seed\": 99,\n \"ticks\": 100,\n \"world\": {\n  \"width\": " + std::to_string(side) +
+                  ",\n  \"height\": " + std::to_string(side) + "\n },\n \"units\": [\n";
+  const auto coord = [&](std::uint64_t h) { return std::to_string(h % static_cast<unsigned>(side)); };
+  for (std::size_t i = 0; i < units; ++i)
+  {
+    const std::uint64_t h = i * 0x9E3779B97F4A7C15ull;
+    s += "  {\n   \"name\": \"u" + std::to_string(i) + "\",\n   \"x\": " + coord(h >> 20) + ",\n   \"y\": " +
+         coord(h >> 42) + "\n  }" + (i + 1 < units ? ",\n" : "\n");
+  }
+  s += " ],\n \"targets\": [\n";
+  for (std::size_t i = 0; i < units; ++i)
+  {
+    const std::uint64_t h = (i + 7) * 0xC2B2AE3D27D4EB4Full;
+    s += "  {\n   \"unit\": \"u" + std::to_string(i) + "\",\n   \"tx\": " + coord(h >> 20) + ",\n   \"ty\": " +
+         coord(h >> 42) + "\n  }" + (i + 1 < units ? ",\n" : "\n");
+  }
+  s += " ],\n \"obstacles\": [\n";
+  for (std::size_t i = 0; i < obstacles; ++i)
+  {
+    const std::uint64_t h = (i + 13) * 0x165667B19E3779F9ull;
+    s += "  {\n   \"x\": " + coord(h >> 20) + ",\n   \"y\": " + coord(h >> 42) +
+         (i % 4 == 0 ? ",\n   \"w\": 4,\n   \"h\": 2" : "") + "\n  }" + (i + 1 < obstacles ? ",\n" : "\n");
+  }
+  s += " ]\n}\n";
+  return s;
+}
+
+static void parse(std::size_t units, std::size_t obstacles, int reps)
+{
+  const std::string text = make_scenario(units, obstacles, 2048);
+  std::size_t checksum = 0;
+  double ms = 0;
+  for (int r = 0; r < reps; ++r)
+  {
+    std::string copy = text; // parse_scenario takes ownership; the copy is not timed
+    const auto t0 = bench::Clock::now();
+    Scenario s;
+    if (!parse_scenario(std::move(copy), s)) return;
+    ms += bench::elapsed_ms(t0);
+    checksum += s.world.units.size() + s.targets.size() + s.obstacles.size();
+    for (const auto x : s.world.units.x()) checksum += static_cast<std::size_t>(x);
+  }
+  bench::report("parse units=" + std::to_string(units) + " obstacles=" + std::to_string(obstacles),
+                static_cast<std::size_t>(reps), ms,
+                "MB/s=" + std::to_string(static_cast<double>(text.size()) * reps / 1000.0 / ms) +
+                  " checksum=" + std::to_string(checksum));
+}
+
+// Large footprints on a 8192x8192 map: the former per-cell loop (bounds check and "already
+// blocked?" test per cell) vs the clipped row-span fill.
+static void rasterize(bool spans, int reps)
+{
+  constexpr int kSide = 8192;
+  Scenario s;
+  for (std::size_t i = 0; i < 2000; ++i)
+  {
+    const std::uint64_t h = (i + 3) * 0x9E3779B97F4A7C15ull;
+    s.obstacles.push_back(rescueops::sim::ObstacleRect{static_cast<int>((h >> 20) % kSide) - 64,
+                                                       static_cast<int>((h >> 40) % kSide) - 64,
+                                                       static_cast<int>(16 + (h >> 8) % 240),
+                                                       static_cast<int>(16 + (h >> 50) % 240)});
+  }
+  std::vector<std::uint8_t> blocked(static_cast<std::size_t>(kSide) * kSide);
+  std::size_t count = 0;
+  double ms = 0;
+  for (int r = 0; r < reps; ++r)
+  {
+    std::fill(blocked.begin(), blocked.end(), 0);
+    const auto t0 = bench::Clock::now();
+    if (spans)
+    {
+      count = rescueops::sim::rasterize_obstacles(s, kSide, kSide, blocked);
+    }
+    else
+    {
+      count = 0;
+      for (const auto& o : s.obstacles)
+        for (int yy = 0; yy < o.h; ++yy)
+          for (int xx = 0; xx < o.w; ++xx)
+          {
+            const int x = o.x + xx;
+            const int y = o.y + yy;
+            if (x < 0 || y < 0 || x >= kSide || y >= kSide) continue;
+            auto& cell = blocked[static_cast<std::size_t>(y) * kSide + static_cast<std::size_t>(x)];
+            if (cell == 0)
+            {
+              cell = 1;
+              ++count;
+            }
+          }
+    }
+    ms += bench::elapsed_ms(t0);
+  }
+  bench::report(std::string("rasterize 2000 rects ") + (spans ? "spans" : "per-cell"), static_cast<std::size_t>(reps),
+                ms, "blocked=" + std::to_string(count));
+}
+
+// A 2048x2048 raster with ~40% blocked cells in short runs, written as 1x1 obstacle objects
+// vs as one run-length encoded layer; parse and rasterize.
+static void raster_layer(bool rle)
+{
+  constexpr int kSide = 2048;
+  std::string text = "{\"world\": {\"width\": 2048, \"height\": 2048},\n";
+  text += rle ? "\"obstacle_layers\": [{\"x\": 0, \"y\": 0, \"width\": 2048, \"height\": 2048, \"runs\": ["
+              : "\"obstacles\": [\n";
+  std::uint64_t h = 7;
+  long long pos = 0;
+  bool first = true;
+  for (bool blocked_run = false; pos < static_cast<long long>(kSide) * kSide; blocked_run = !blocked_run)
+  {
+    h = h * 6364136223846793005ull + 1442695040888963407ull;
+    const long long run = static_cast<long long>(1 + (h >> 33) % (blocked_run ? 20 : 30));
+    if (rle)
+    {
+      if (!first) text += ',';
+      text += std::to_string(run);
+      first = false;
+    }
+    else if (blocked_run)
+    {
+      for (long long p = pos; p < pos + run && p < static_cast<long long>(kSide) * kSide; ++p)
+      {
+        if (!first) text += ",\n";
+        text += "{\"x\": " + std::to_string(p % kSide) + ", \"y\": " + std::to_string(p / kSide) + "}";
+        first = false;
+      }
+    }
+    pos += run;
+  }
+  text += rle ? "]}]}\n" : "\n]}\n";
+
+  const double mb = static_cast<double>(text.size()) / 1e6;
+  const auto t0 = bench::Clock::now();
+  Scenario s;
+  if (!parse_scenario(std::move(text), s)) return;
+  std::vector<std::uint8_t> blocked(static_cast<std::size_t>(kSide) * kSide);
+  const auto count = rescueops::sim::rasterize_obstacles(s, kSide, kSide, blocked);
+  const double ms = bench::elapsed_ms(t0);
+  bench::report(std::string("raster 2048^2 as ") + (rle ? "rle layer" : "cell objects"), 1, ms,
+                "MB=" + std::to_string(mb) + " blocked=" + std::to_string(count));
+}
+
+int main()
+{
+  parse(10'000, 20'000, 20);
+  parse(100'000, 200'000, 5);
+  parse(100'000, 1'000'000, 3);
+  rasterize(false, 3);
+  rasterize(true, 3);
+  raster_layer(false);
+  raster_layer(true);
+  return 0;
+}
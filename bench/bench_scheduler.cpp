@@ -0,0 +1,142 @@
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "sim/scheduler.hpp"
+#include "sim/thread_pool.hpp"
+
+using rescueops::sim::EventQueue;
+using rescueops::sim::Scheduler;
+using rescueops::sim::ThreadPool;
+using rescueops::sim::Tick;
+
+static const char* queue_name(EventQueue kind)
+{
+  return kind == EventQueue::TimingWheel ? "wheel" : "heap";
+}
+
+// Schedule `n` events spread over `horizon` ticks, then drain them one tick at a time.
+static void fill_drain(EventQueue kind, std::size_t n, Tick horizon)
+{
+  std::mt19937_64 rng(7);
+  std::vector<Tick> ticks(n);
+  for (auto& t : ticks) t = rng() % horizon;
+
+  Scheduler s(kind);
+  std::uint64_t checksum = 0;
+  const auto t0 = bench::Clock::now();
+  for (std::size_t i = 0; i < n; ++i) s.schedule(ticks[i], [&checksum, i] { checksum = checksum * 31 + i; });
+  const std::size_t peak = s.pending();
+  for (Tick t = 0; t < horizon; ++t) s.run_due(t);
+  const double ms = bench::elapsed_ms(t0);
+  bench::report(std::string("fill+drain ") + queue_name(kind) + " horizon=" + std::to_string(horizon), n, ms,
+                "pending=" + std::to_string(peak) + " checksum=" + std::to_string(checksum));
+}
+
+// Steady state ("hold" model): `pending` events in flight; each one reschedules itself a random
+// 1..max_delay ticks ahead when it fires, until `firings` events have run.
+static void hold(EventQueue kind, std::size_t pending, Tick max_delay, std::size_t firings)
+{
+  Scheduler s(kind);
+  std::mt19937_64 rng(11);
+  Tick now = 0;
+  std::size_t fired = 0;
+  std::uint64_t checksum = 0;
+
+  struct Reschedule
+  {
+    Scheduler* s;
+    std::mt19937_64* rng;
+    const Tick* now;
+    std::size_t* fired;
+    std::uint64_t* checksum;
+    Tick max_delay;
+    std::uint64_t id;
+
+    void operator()() const
+    {
+      ++*fired;
+      *checksum = *checksum * 31 + id;
+      s->schedule(*now + 1 + (*rng)() % max_delay, *this);
+    }
+  };
+
+  for (std::size_t i = 0; i < pending; ++i)
+    s.schedule(1 + rng() % max_delay, Reschedule{&s, &rng, &now, &fired, &checksum, max_delay, i});
+
+  const auto t0 = bench::Clock::now();
+  while (fired < firings) s.run_due(++now);
+  const double ms = bench::elapsed_ms(t0);
+  bench::report(std::string("hold ") + queue_name(kind) + " pending=" + std::to_string(pending) +
+                  " delay<=" + std::to_string(max_delay),
+                fired, ms, "ticks=" + std::to_string(now) + " checksum=" + std::to_string(checksum));
+}
+
+// 5000 per-unit events per tick, each declaring a write on its own unit: with a pool they run
+// as one parallel batch per tick. `threads` = 1 is the serial scheduler.
+static void same_tick_units(unsigned threads, std::size_t units, Tick ticks, int work)
+{
+  Scheduler s(EventQueue::TimingWheel);
+  ThreadPool pool(threads);
+  if (threads > 1) s.set_thread_pool(&pool);
+
+  std::vector<std::uint64_t> state(units, 1);
+  Tick now = 0;
+
+  struct Step
+  {
+    Scheduler* s;
+    std::uint64_t* x;
+    const Tick* now;
+    Tick ticks;
+    int work;
+    std::uint32_t unit;
+
+    void operator()() const
+    {
+      for (int k = 0; k < work; ++k) *x = *x * 6364136223846793005ull + 1442695040888963407ull;
+      if (*now + 1 >= ticks) return;
+      rescueops::sim::EventAccess access;
+      access.write(rescueops::sim::access_key(1, unit));
+      s->schedule(*now + 1, access, *this);
+    }
+  };
+
+  for (std::uint32_t u = 0; u < units; ++u)
+  {
+    rescueops::sim::EventAccess access;
+    access.write(rescueops::sim::access_key(1, u));
+    s.schedule(0, access, Step{&s, &state[u], &now, ticks, work, u});
+  }
+
+  const auto t0 = bench::Clock::now();
+  for (; now < ticks; ++now) s.run_due(now);
+  const double ms = bench::elapsed_ms(t0);
+
+  std::uint64_t checksum = 0;
+  for (auto v : state) checksum = checksum * 31 + v;
+  bench::report("same-tick units threads=" + std::to_string(pool.size()) + " work=" + std::to_string(work),
+                units * static_cast<std::size_t>(ticks), ms,
+                "batches=" + std::to_string(s.parallel_batches()) + " checksum=" + std::to_string(checksum));
+}
+
+int main()
+{
+  for (const auto kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    fill_drain(kind, 2'000'000, 1000);
+    fill_drain(kind, 2'000'000, 100'000);
+    hold(kind, 1'000'000, 500, 4'000'000);
+    hold(kind, 1'000'000, 50'000, 4'000'000);
+  }
+
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads : {1u, 2u, 4u, hw})
+  {
+    same_tick_units(threads, 5000, 200, 200);
+  }
+  return 0;
+}
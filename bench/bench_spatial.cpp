@@ -0,0 +1,121 @@
+#include "bench_common.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "models/motion.hpp"
+#include "sim/spatial_index.hpp"
+
+using rescueops::sim::SpatialIndex;
+using rescueops::sim::Unit;
+using rescueops::sim::UnitTable;
+using rescueops::sim::Vec2i;
+
+// Index maintenance per tick under the Philox random walk, at constant density (one unit per
+// 16 cells), rebuilding from scratch vs updating incrementally. The walk itself is not timed.
+static void maintain(std::size_t units, int cell, bool incremental, int ticks)
+{
+  const int side = static_cast<int>(std::sqrt(static_cast<double>(units) * 16.0));
+  UnitTable table;
+  table.reserve(units);
+  for (std::uint32_t i = 0; i < units; ++i)
+  {
+    const std::uint64_t h = i * 0x9E3779B97F4A7C15ull;
+    table.push_back(i + 1, "u", Vec2i{static_cast<int>((h >> 20) % static_cast<unsigned>(side)),
+                                      static_cast<int>((h >> 42) % static_cast<unsigned>(side))});
+  }
+
+  SpatialIndex index(cell);
+  index.build(table, side, side);
+  double ms = 0;
+  for (int t = 0; t < ticks; ++t)
+  {
+    rescueops::models::random_walk_tick(table.x(), table.y(), table.ids(), 1, static_cast<std::uint64_t>(t), side,
+                                        side);
+    const auto t0 = bench::Clock::now();
+    if (incremental)
+      index.update();
+    else
+      index.build(table, side, side);
+    ms += bench::elapsed_ms(t0);
+  }
+
+  // Checksum from queries, so both variants must agree.
+  std::vector<std::uint32_t> out;
+  std::uint64_t checksum = 0;
+  for (int q = 0; q < 100; ++q)
+  {
+    index.query_radius(Vec2i{(q * 7919) % side, (q * 104729) % side}, 16, out);
+    for (const auto row : out) checksum = checksum * 31 + row;
+  }
+  bench::report(std::string(incremental ? "update " : "rebuild") + " cell=" + std::to_string(cell) +
+                  " units=" + std::to_string(units),
+                static_cast<std::size_t>(ticks), ms,
+                "moves/tick=" + std::to_string(index.moves() / static_cast<std::size_t>(ticks)) +
+                  " checksum=" + std::to_string(checksum));
+}
+
+// Radius queries against the index vs a scan of all units.
+static void queries(std::size_t units, int r, bool indexed)
+{
+  const int side = static_cast<int>(std::sqrt(static_cast<double>(units) * 16.0));
+  UnitTable table;
+  for (std::uint32_t i = 0; i < units; ++i)
+  {
+    const std::uint64_t h = i * 0x9E3779B97F4A7C15ull;
+    table.push_back(i + 1, "u", Vec2i{static_cast<int>((h >> 20) % static_cast<unsigned>(side)),
+                                      static_cast<int>((h >> 42) % static_cast<unsigned>(side))});
+  }
+  SpatialIndex index(8);
+  index.build(table, side, side);
+
+  constexpr int kQueries = 1000;
+  std::vector<std::uint32_t> out;
+  std::uint64_t found = 0;
+  const auto t0 = bench::Clock::now();
+  for (int q = 0; q < kQueries; ++q)
+  {
+    const Vec2i c{(q * 7919) % side, (q * 104729) % side};
+    if (indexed)
+    {
+      index.query_radius(c, r, out);
+    }
+    else
+    {
+      out.clear();
+      const auto xs = table.x();
+      const auto ys = table.y();
+      for (std::uint32_t i = 0; i < table.size(); ++i)
+      {
+        const long long dx = xs[i] - c.x;
+        const long long dy = ys[i] - c.y;
+        if (dx * dx + dy * dy <= static_cast<long long>(r) * r) out.push_back(i);
+      }
+    }
+    found += out.size();
+  }
+  const double ms = bench::elapsed_ms(t0);
+  bench::report(std::string(indexed ? "radius query index" : "radius query scan ") + " units=" +
+                  std::to_string(units) + " r=" + std::to_string(r),
+                kQueries, ms, "found=" + std::to_string(found));
+}
+
+int main()
+{
+  for (const std::size_t units : {10'000u, 100'000u, 1'000'000u})
+  {
+    const int ticks = units >= 1'000'000 ? 20 : 100;
+    for (const int cell : {8, 32})
+    {
+      maintain(units, cell, false, ticks);
+      maintain(units, cell, true, ticks);
+    }
+  }
+  for (const std::size_t units : {10'000u, 1'000'000u})
+  {
+    queries(units, 16, false);
+    queries(units, 16, true);
+  }
+  return 0;
+}
@@ -0,0 +1,179 @@
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sim/engine.hpp"
+#include "sim/thread_pool.hpp"
+
+using rescueops::sim::Vec2i;
+
+// Tick throughput of the unit update loop at 100k units; every report line is per tick.
+
+// The pre-SoA layout: one struct per unit with the name between id and position.
+struct LegacyUnit
+{
+  std::uint32_t id = 0;
+  std::string name;
+  Vec2i pos{};
+};
+
+constexpr int kWidth = 2048;
+constexpr int kHeight = 2048;
+
+static Vec2i start_pos(std::uint32_t i)
+{
+  return Vec2i{static_cast<int>((i * 7919u) % kWidth), static_cast<int>((i * 104729u) % kHeight)};
+}
+
+static std::string unit_name(std::uint32_t i)
+{
+  return "rescue_team_" + std::to_string(i);
+}
+
+static std::uint64_t checksum_of(const std::vector<int>& xs, const std::vector<int>& ys)
+{
+  std::uint64_t h = 0;
+  for (std::size_t i = 0; i < xs.size(); ++i) h = h * 31 + static_cast<std::uint64_t>(xs[i] * kHeight + ys[i]);
+  return h;
+}
+
+// Engine::run's random walk on the legacy array-of-structs layout.
+static void aos_random_walk(std::size_t units, int ticks)
+{
+  std::vector<LegacyUnit> world;
+  for (std::uint32_t i = 0; i < units; ++i) world.push_back(LegacyUnit{i + 1, unit_name(i), start_pos(i)});
+  std::mt19937_64 rng(1);
+
+  const auto t0 = bench::Clock::now();
+  for (int t = 0; t < ticks; ++t)
+  {
+    std::uniform_int_distribution<int> step(-1, 1);
+    for (auto& u : world)
+    {
+      u.pos.x = std::max(0, std::min(kWidth - 1, u.pos.x + step(rng)));
+      u.pos.y = std::max(0, std::min(kHeight - 1, u.pos.y + step(rng)));
+    }
+  }
+  const double ms = bench::elapsed_ms(t0);
+
+  std::vector<int> xs, ys;
+  for (const auto& u : world)
+  {
+    xs.push_back(u.pos.x);
+    ys.push_back(u.pos.y);
+  }
+  bench::report("aos random walk units=" + std::to_string(units), static_cast<std::size_t>(ticks), ms,
+                "checksum=" + std::to_string(checksum_of(xs, ys)));
+}
+
+// The same walk through Engine::run on World's SoA UnitTable, with either step source.
+static void soa_engine_run(std::size_t units, int ticks, rescueops::sim::MotionRng rng)
+{
+  rescueops::sim::Engine eng;
+  eng.set_seed(1);
+  eng.set_motion_rng(rng);
+  eng.world().width = kWidth;
+  eng.world().height = kHeight;
+  eng.world().units.reserve(units);
+  for (std::uint32_t i = 0; i < units; ++i)
+    eng.world().units.push_back(rescueops::sim::Unit{i + 1, unit_name(i), start_pos(i)});
+
+  const auto t0 = bench::Clock::now();
+  eng.run(static_cast<rescueops::sim::Tick>(ticks));
+  const double ms = bench::elapsed_ms(t0);
+
+  const auto& u = eng.world().units;
+  const std::vector<int> xs(u.x().begin(), u.x().end());
+  const std::vector<int> ys(u.y().begin(), u.y().end());
+  bench::report(std::string("soa Engine::run rng=") + rescueops::sim::motion_rng_name(rng) +
+                  " units=" + std::to_string(units), static_cast<std::size_t>(ticks), ms,
+                "checksum=" + std::to_string(checksum_of(xs, ys)));
+}
+
+// Thread scaling of the Philox tick in Engine::run (row chunks; threads=1 is the serial kernel).
+static void philox_scaling(std::size_t units, int ticks, unsigned threads)
+{
+  rescueops::sim::ThreadPool pool(threads);
+  rescueops::sim::Engine eng;
+  eng.set_seed(1);
+  eng.set_motion_rng(rescueops::sim::MotionRng::Philox);
+  eng.set_thread_pool(&pool);
+  eng.world().width = kWidth;
+  eng.world().height = kHeight;
+  eng.world().units.reserve(units);
+  for (std::uint32_t i = 0; i < units; ++i)
+    eng.world().units.push_back(rescueops::sim::Unit{i + 1, unit_name(i), start_pos(i)});
+
+  const auto t0 = bench::Clock::now();
+  eng.run(static_cast<rescueops::sim::Tick>(ticks));
+  const double ms = bench::elapsed_ms(t0);
+
+  const auto& u = eng.world().units;
+  const std::vector<int> xs(u.x().begin(), u.x().end());
+  const std::vector<int> ys(u.y().begin(), u.y().end());
+  bench::report("parallel philox threads=" + std::to_string(pool.size()) + " units=" + std::to_string(units),
+                static_cast<std::size_t>(ticks), ms, "checksum=" + std::to_string(checksum_of(xs, ys)));
+}
+
+// Layout cost alone: a cheap deterministic drift, so memory traffic dominates instead of the RNG.
+static void drift(bool soa, std::size_t units, int ticks)
+{
+  std::vector<LegacyUnit> aos;
+  std::vector<int> xs, ys;
+  for (std::uint32_t i = 0; i < units; ++i)
+  {
+    aos.push_back(LegacyUnit{i + 1, unit_name(i), start_pos(i)});
+    xs.push_back(start_pos(i).x);
+    ys.push_back(start_pos(i).y);
+  }
+
+  const auto t0 = bench::Clock::now();
+  for (int t = 0; t < ticks; ++t)
+  {
+    const int dx = (t & 1) ? 1 : -1;
+    if (soa)
+    {
+      for (std::size_t i = 0; i < units; ++i)
+      {
+        xs[i] = std::max(0, std::min(kWidth - 1, xs[i] + dx));
+        ys[i] = std::max(0, std::min(kHeight - 1, ys[i] - dx));
+      }
+    }
+    else
+    {
+      for (auto& u : aos)
+      {
+        u.pos.x = std::max(0, std::min(kWidth - 1, u.pos.x + dx));
+        u.pos.y = std::max(0, std::min(kHeight - 1, u.pos.y - dx));
+      }
+    }
+  }
+  const double ms = bench::elapsed_ms(t0);
+
+  if (!soa)
+  {
+    for (std::size_t i = 0; i < units; ++i)
+    {
+      xs[i] = aos[i].pos.x;
+      ys[i] = aos[i].pos.y;
+    }
+  }
+  bench::report(std::string(soa ? "soa" : "aos") + " drift units=" + std::to_string(units),
+                static_cast<std::size_t>(ticks), ms, "checksum=" + std::to_string(checksum_of(xs, ys)));
+}
+
+int main()
+{
+  constexpr std::size_t kUnits = 100'000;
+  constexpr int kTicks = 200;
+  aos_random_walk(kUnits, kTicks);
+  soa_engine_run(kUnits, kTicks, rescueops::sim::MotionRng::Mt19937);
+  soa_engine_run(kUnits, kTicks, rescueops::sim::MotionRng::Philox);
+  drift(false, kUnits, kTicks);
+  drift(true, kUnits, kTicks);
+  for (const unsigned threads : {1u, 2u, 4u, 8u, 0u}) philox_scaling(200'000, kTicks, threads);
+  return 0;
+}
@@ -1,4 +1,118 @@
 #include "models/motion.hpp"
+
+#include <algorithm>
+
+#include "sim/philox.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RESCUEOPS_MOTION_AVX2 1
+#endif
+
 namespace rescueops::models
 {
+  namespace
+  {
+    // Maps a uniform 32-bit word to {-1, 0, 1} by multiply-shift (bias below 2^-31).
+    inline int unit_step(std::uint32_t r)
+    {
+      return static_cast<int>((std::uint64_t{r} * 3) >> 32) - 1;
+    }
+
+    void walk_scalar(int* px, int* py, const std::uint32_t* pid, std::size_t begin, std::size_t end,
+                     std::uint64_t seed, std::uint64_t tick, int width, int height)
+    {
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const auto r = sim::counter_random(seed, pid[i], tick, sim::RngStream::Motion);
+        px[i] = std::max(0, std::min(width - 1, px[i] + unit_step(r[0])));
+        py[i] = std::max(0, std::min(height - 1, py[i] + unit_step(r[1])));
+      }
+    }
+
+#ifdef RESCUEOPS_MOTION_AVX2
+    // High and low 32 bits of the eight 32x32-bit products a[k] * b[k].
+    __attribute__((target("avx2"))) inline void mul_hi_lo(__m256i a, __m256i b, __m256i& hi, __m256i& lo)
+    {
+      const __m256i even = _mm256_mul_epu32(a, b);
+      const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+      hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+      lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    }
+
+    // Philox4x32-10 for eight units at once (counter = {id, tick lo, tick hi, stream}), then the
+    // same step and clamp as walk_scalar. Returns the first row left for the scalar tail.
+    __attribute__((target("avx2"))) std::size_t walk_avx2(int* px, int* py, const std::uint32_t* pid, std::size_t n,
+                                                         std::uint64_t seed, std::uint64_t tick, int width, int height)
+    {
+      const __m256i mul0 = _mm256_set1_epi32(static_cast<int>(0xD2511F53u));
+      const __m256i mul1 = _mm256_set1_epi32(static_cast<int>(0xCD9E8D57u));
+      const __m256i three = _mm256_set1_epi32(3);
+      const __m256i one = _mm256_set1_epi32(1);
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i max_x = _mm256_set1_epi32(width - 1);
+      const __m256i max_y = _mm256_set1_epi32(height - 1);
+      const __m256i tick_lo = _mm256_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(tick)));
+      const __m256i tick_hi = _mm256_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(tick >> 32)));
+      const __m256i stream = _mm256_set1_epi32(static_cast<int>(sim::RngStream::Motion));
+      __m256i keys[10][2];
+      std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+      std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+      for (auto& k : keys)
+      {
+        k[0] = _mm256_set1_epi32(static_cast<int>(k0));
+        k[1] = _mm256_set1_epi32(static_cast<int>(k1));
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+      }
+
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8)
+      {
+        __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pid + i));
+        __m256i c1 = tick_lo;
+        __m256i c2 = tick_hi;
+        __m256i c3 = stream;
+        for (const auto& k : keys)
+        {
+          __m256i hi0, lo0, hi1, lo1;
+          mul_hi_lo(c0, mul0, hi0, lo0);
+          mul_hi_lo(c2, mul1, hi1, lo1);
+          c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), k[0]);
+          c1 = lo1;
+          c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), k[1]);
+          c3 = lo0;
+        }
+        __m256i step_x, step_y, unused;
+        mul_hi_lo(c0, three, step_x, unused);
+        mul_hi_lo(c1, three, step_y, unused);
+
+        const auto x_at = reinterpret_cast<__m256i*>(px + i);
+        const auto y_at = reinterpret_cast<__m256i*>(py + i);
+        const __m256i x = _mm256_add_epi32(_mm256_loadu_si256(x_at), _mm256_sub_epi32(step_x, one));
+        const __m256i y = _mm256_add_epi32(_mm256_loadu_si256(y_at), _mm256_sub_epi32(step_y, one));
+        _mm256_storeu_si256(x_at, _mm256_max_epi32(_mm256_min_epi32(x, max_x), zero));
+        _mm256_storeu_si256(y_at, _mm256_max_epi32(_mm256_min_epi32(y, max_y), zero));
+      }
+      return i;
+    }
+
+    bool has_avx2()
+    {
+      static const bool yes = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+      return yes;
+    }
+#endif
+  } // namespace
+
+  void random_walk_tick(std::span<int> xs, std::span<int> ys, std::span<const std::uint32_t> ids, std::uint64_t seed,
+                        std::uint64_t tick, int width, int height)
+  {
+    const std::size_t n = std::min({xs.size(), ys.size(), ids.size()});
+    std::size_t done = 0;
+#ifdef RESCUEOPS_MOTION_AVX2
+    if (has_avx2()) done = walk_avx2(xs.data(), ys.data(), ids.data(), n, seed, tick, width, height);
+#endif
+    walk_scalar(xs.data(), ys.data(), ids.data(), done, n, seed, tick, width, height);
+  }
 } // namespace rescueops::models
@@ -1,8 +1,20 @@
 #pragma once
+#include <cstdint>
+#include <span>
+
 namespace rescueops::models
 {
   struct MotionLimits
   {
     int max_step_per_tick = 1;
   };
+
+  // One tick of the counter-based random walk: unit i moves by a step in {-1, 0, 1} on each axis,
+  // drawn from counter_random(seed, ids[i], tick, RngStream::Motion), and is clamped to
+  // [0, width) x [0, height). Each unit's step depends only on its own id, so any subrange can
+  // be updated independently (in any order, on any thread) with the same result. On x86-64 CPUs
+  // with AVX2 (checked at run time) eight units go through Philox at once; elsewhere, and for
+  // the last few units, a scalar loop gives the same values.
+  void random_walk_tick(std::span<int> xs, std::span<int> ys, std::span<const std::uint32_t> ids, std::uint64_t seed,
+                        std::uint64_t tick, int width, int height);
 } // namespace rescueops::models
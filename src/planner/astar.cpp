@@ -3,18 +3,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <limits>
-#include <queue>
+
+#include "planner/bitgrid.hpp"
+#include "planner/paged_grid.hpp"
 
 namespace rescueops::planner
 {
-  struct Node
-  {
-    int x = 0;
-    int y = 0;
-    int g = 0;
-    int f = 0;
-  };
+  using Node = SearchContext::Node;
 
   struct NodeCmp
   {
@@ -26,42 +21,137 @@ namespace rescueops::planner
     return std::abs(x1 - x2) + std::abs(y1 - y2);
   }
 
-  std::optional<PathResult> astar(const Grid& grid, rescueops::sim::Vec2i start, rescueops::sim::Vec2i goal)
+  void SearchContext::reset_open()
   {
-    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
-    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+    heap_.clear();
+    for (std::size_t i = 0; i < bucket_used_; ++i) buckets_[i].clear();
+    bucket_used_ = 0;
+    bucket_cursor_ = 0;
+    bucket_count_ = 0;
+    stats_ = SearchStats{};
+  }
+
+  void SearchContext::begin(std::size_t cells)
+  {
+    if (records_.size() < cells) records_.resize(cells);
+    reset_open();
+
+    // On wrap-around stale stamps could alias the new generation: wipe once every 2^32 queries.
+    if (++gen_ == 0)
+    {
+      std::fill(records_.begin(), records_.end(), Record{});
+      gen_ = 1;
+    }
+  }
+
+  void SearchContext::begin_sparse()
+  {
+    sparse_.clear();
+    reset_open();
+  }
 
-    const int W = grid.w;
-    const int H = grid.h;
-    const auto idx = [W](int x, int y) { return y * W + x; };
+  void SearchContext::push(const Node& n)
+  {
+    ++stats_.pushed;
+    if (open_list_ == OpenList::BinaryHeap)
+    {
+      heap_.push_back(n);
+      std::push_heap(heap_.begin(), heap_.end(), NodeCmp{});
+      return;
+    }
 
-    std::vector<int> gscore(static_cast<std::size_t>(W * H), std::numeric_limits<int>::max());
-    std::vector<int> parent(static_cast<std::size_t>(W * H), -1);
+    if (bucket_count_ == 0 && bucket_used_ == 0) bucket_base_ = n.f;
+    // f below the cursor can only come from an inconsistent heuristic; file it under the cursor.
+    const std::size_t slot =
+      std::max(bucket_cursor_, static_cast<std::size_t>(std::max(0, n.f - bucket_base_)));
+    if (slot >= buckets_.size()) buckets_.resize(slot + 1);
+    bucket_used_ = std::max(bucket_used_, slot + 1);
+    buckets_[slot].push_back(n);
+    ++bucket_count_;
+  }
 
-    std::priority_queue<Node, std::vector<Node>, NodeCmp> open;
-    const int sidx = idx(start.x, start.y);
-    gscore[static_cast<std::size_t>(sidx)] = 0;
-    open.push(Node{start.x, start.y, 0, manhattan(start.x, start.y, goal.x, goal.y)});
+  bool SearchContext::pop(Node& out)
+  {
+    if (open_list_ == OpenList::BinaryHeap)
+    {
+      if (heap_.empty()) return false;
+      std::pop_heap(heap_.begin(), heap_.end(), NodeCmp{});
+      out = heap_.back();
+      heap_.pop_back();
+      return true;
+    }
+
+    if (bucket_count_ == 0) return false;
+    while (buckets_[bucket_cursor_].empty()) ++bucket_cursor_;
+    out = buckets_[bucket_cursor_].back();
+    buckets_[bucket_cursor_].pop_back();
+    --bucket_count_;
+    return true;
+  }
+
+  // Per-cell g/parent storage for search(): dense generation-stamped records for grids that fit
+  // in memory, a hash map of visited cells for paged grids.
+  struct DenseRecords
+  {
+    using Index = int;
+    SearchContext& ctx;
+
+    int g(Index i) const { return ctx.g(static_cast<std::size_t>(i)); }
+    Index parent(Index i) const { return ctx.parent(static_cast<std::size_t>(i)); }
+    void set(Index i, int g, Index parent) { ctx.set(static_cast<std::size_t>(i), g, parent); }
+  };
+
+  struct SparseRecords
+  {
+    using Index = std::int64_t;
+    SearchContext& ctx;
+
+    int g(Index i) const { return ctx.sparse_g(static_cast<std::uint64_t>(i)); }
+    Index parent(Index i) const { return ctx.sparse_parent(static_cast<std::uint64_t>(i)); }
+    void set(Index i, int g, Index parent) { ctx.sparse_set(static_cast<std::uint64_t>(i), g, parent); }
+  };
+
+  // Shared A* loop; `passable(x, y)` hides how the grid answers bounds + obstacle tests. The
+  // caller starts the query on `ctx` (begin() or begin_sparse()) to match `records`.
+  template <class Records, class Passable>
+  static std::optional<PathResult> search(int W,
+                                          rescueops::sim::Vec2i start,
+                                          rescueops::sim::Vec2i goal,
+                                          SearchContext& ctx,
+                                          Records records,
+                                          const Passable& passable)
+  {
+    using Index = typename Records::Index;
+    const auto idx = [W](int x, int y) { return static_cast<Index>(y) * W + x; };
+
+    auto& stats = ctx.stats();
+
+    const Index sidx = idx(start.x, start.y);
+    records.set(sidx, 0, -1);
+    ctx.push(Node{start.x, start.y, 0, manhattan(start.x, start.y, goal.x, goal.y)});
 
     const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
 
-    while (!open.empty())
+    Node cur;
+    while (ctx.pop(cur))
     {
-      const auto cur = open.top();
-      open.pop();
+      const Index cidx = idx(cur.x, cur.y);
+      // Stale duplicate: a cheaper entry for this cell was already expanded.
+      if (cur.g > records.g(cidx)) continue;
+      ++stats.expanded;
 
       if (cur.x == goal.x && cur.y == goal.y)
       {
         // reconstruct
         PathResult out;
         out.cost = cur.g;
-        int c = idx(cur.x, cur.y);
+        Index c = cidx;
         while (c != -1)
         {
-          int x = c % W;
-          int y = c / W;
+          int x = static_cast<int>(c % W);
+          int y = static_cast<int>(c / W);
           out.path.push_back(rescueops::sim::Vec2i{x, y});
-          c = parent[static_cast<std::size_t>(c)];
+          c = records.parent(c);
         }
         std::reverse(out.path.begin(), out.path.end());
         return out;
@@ -71,22 +161,66 @@ namespace rescueops::planner
       {
         int nx = cur.x + d[0];
         int ny = cur.y + d[1];
-        if (!grid.in_bounds(nx, ny)) continue;
-        if (grid.is_blocked(nx, ny)) continue;
+        if (!passable(nx, ny)) continue;
 
-        const int nidx = idx(nx, ny);
+        const Index nidx = idx(nx, ny);
         const int tentative_g = cur.g + 1;
 
-        if (tentative_g < gscore[static_cast<std::size_t>(nidx)])
+        if (tentative_g < records.g(nidx))
         {
-          gscore[static_cast<std::size_t>(nidx)] = tentative_g;
-          parent[static_cast<std::size_t>(nidx)] = idx(cur.x, cur.y);
+          records.set(nidx, tentative_g, cidx);
           const int h = manhattan(nx, ny, goal.x, goal.y);
-          open.push(Node{nx, ny, tentative_g, tentative_g + h});
+          ctx.push(Node{nx, ny, tentative_g, tentative_g + h});
         }
       }
     }
 
     return std::nullopt;
   }
+
+  std::optional<PathResult> astar(const Grid& grid, rescueops::sim::Vec2i start, rescueops::sim::Vec2i goal)
+  {
+    SearchContext ctx;
+    return astar(grid, start, goal, ctx);
+  }
+
+  std::optional<PathResult> astar(const Grid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx)
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+
+    ctx.begin(static_cast<std::size_t>(grid.w) * static_cast<std::size_t>(grid.h));
+    return search(grid.w, start, goal, ctx, DenseRecords{ctx},
+                  [&grid](int x, int y) { return grid.in_bounds(x, y) && !grid.is_blocked(x, y); });
+  }
+
+  std::optional<PathResult> astar(const BitGrid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx)
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+
+    // The blocked border stops the search at the edges: no bounds test needed.
+    ctx.begin(static_cast<std::size_t>(grid.width()) * static_cast<std::size_t>(grid.height()));
+    return search(grid.width(), start, goal, ctx, DenseRecords{ctx},
+                  [&grid](int x, int y) { return !grid.is_blocked(x, y); });
+  }
+
+  std::optional<PathResult> astar(const PagedGrid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx)
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+
+    ctx.begin_sparse();
+    return search(grid.width(), start, goal, ctx, SparseRecords{ctx},
+                  [&grid](int x, int y) { return grid.in_bounds(x, y) && !grid.is_blocked(x, y); });
+  }
 } // namespace rescueops::planner
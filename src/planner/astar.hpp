@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "sim/world.hpp"
@@ -16,11 +18,136 @@ namespace rescueops::planner
     bool is_blocked(int x, int y) const { return blocked[static_cast<std::size_t>(y) * w + x] != 0; }
   };
 
+  class BitGrid;
+
   struct PathResult
   {
     std::vector<rescueops::sim::Vec2i> path;
     int cost = 0;
   };
 
+  // Per-query counters, reset by SearchContext::begin().
+  struct SearchStats
+  {
+    std::size_t expanded = 0; // nodes popped and expanded
+    std::size_t pushed = 0;   // open-list insertions
+  };
+
+  // Open-list implementations. Both are deterministic for a given query.
+  //  - BinaryHeap: std heap ordered by f.
+  //  - Buckets: monotone bucket queue indexed by f (LIFO inside a bucket, so deeper nodes win
+  //    ties). O(1) push/pop; relies on f never decreasing, which holds for the consistent
+  //    Manhattan heuristic used by every planner here.
+  enum class OpenList
+  {
+    BinaryHeap,
+    Buckets,
+  };
+
+  class PagedGrid;
+
+  // Reusable scratch space for repeated searches.
+  // Per-cell records are generation-stamped: a record only counts as written if its stamp
+  // matches the current query, so starting a new search is O(1) instead of refilling W*H arrays.
+  // Keep one alive per thread and pass it to every query; it grows to the largest grid seen.
+  class SearchContext
+  {
+   public:
+    struct Node
+    {
+      int x = 0;
+      int y = 0;
+      int g = 0;
+      int f = 0;
+    };
+
+    // Start a new query over a grid with `cells` cells.
+    void begin(std::size_t cells);
+
+    bool visited(std::size_t idx) const { return records_[idx].gen == gen_; }
+    int g(std::size_t idx) const { return visited(idx) ? records_[idx].g : kUnreached; }
+    int parent(std::size_t idx) const { return visited(idx) ? records_[idx].parent : -1; }
+
+    void set(std::size_t idx, int g, int parent)
+    {
+      records_[idx] = Record{gen_, g, parent};
+    }
+
+    // Sparse records for grids too large to index densely (PagedGrid): only cells the search
+    // touches are stored, keyed by their 64-bit row-major index. begin_sparse() starts a query.
+    void begin_sparse();
+    int sparse_g(std::uint64_t idx) const
+    {
+      const auto it = sparse_.find(idx);
+      return it == sparse_.end() ? kUnreached : it->second.g;
+    }
+    std::int64_t sparse_parent(std::uint64_t idx) const
+    {
+      const auto it = sparse_.find(idx);
+      return it == sparse_.end() ? -1 : it->second.parent;
+    }
+    void sparse_set(std::uint64_t idx, int g, std::int64_t parent) { sparse_[idx] = SparseRecord{g, parent}; }
+
+    // Selects the open list for subsequent queries (default BinaryHeap).
+    void set_open_list(OpenList kind) { open_list_ = kind; }
+    OpenList open_list() const { return open_list_; }
+
+    // Open list, storage reused across queries.
+    void push(const Node& n);
+    bool pop(Node& out);
+
+    SearchStats& stats() { return stats_; }
+    const SearchStats& stats() const { return stats_; }
+
+    static constexpr int kUnreached = 0x7fffffff;
+
+   private:
+    void reset_open(); // clears the open list and the stats
+
+    struct Record
+    {
+      std::uint32_t gen = 0;
+      int g = 0;
+      int parent = -1;
+    };
+
+    struct SparseRecord
+    {
+      int g = 0;
+      std::int64_t parent = -1;
+    };
+
+    std::vector<Record> records_;
+    std::unordered_map<std::uint64_t, SparseRecord> sparse_;
+    OpenList open_list_ = OpenList::BinaryHeap;
+    std::vector<Node> heap_;
+    std::vector<std::vector<Node>> buckets_; // index f - bucket_base_
+    std::size_t bucket_cursor_ = 0;
+    std::size_t bucket_used_ = 0; // buckets touched this query
+    std::size_t bucket_count_ = 0;
+    int bucket_base_ = 0;
+    SearchStats stats_;
+    std::uint32_t gen_ = 0;
+  };
+
   std::optional<PathResult> astar(const Grid& grid, rescueops::sim::Vec2i start, rescueops::sim::Vec2i goal);
+
+  // Same as above, reusing `ctx` across calls (no per-query W*H allocation).
+  std::optional<PathResult> astar(const Grid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx);
+
+  // Bit-packed variant: identical search order and result, without per-neighbour bounds checks.
+  std::optional<PathResult> astar(const BitGrid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx);
+
+  // Paged variant: identical search order and result. Tiles are paged in as the search reaches
+  // them, and per-cell state is kept only for visited cells, so neither scales with W*H.
+  std::optional<PathResult> astar(const PagedGrid& grid,
+                                  rescueops::sim::Vec2i start,
+                                  rescueops::sim::Vec2i goal,
+                                  SearchContext& ctx);
 } // namespace rescueops::planner
@@ -0,0 +1,44 @@
+#include "planner/batch.hpp"
+
+namespace rescueops::planner
+{
+  BatchPlanner::BatchPlanner(rescueops::sim::ThreadPool& pool)
+    : pool_(pool), contexts_(pool.size()), worker_stats_(pool.size())
+  {
+  }
+
+  std::vector<std::optional<PathResult>> BatchPlanner::plan(const PlanConfig& cfg,
+                                                            const Grid& grid,
+                                                            std::span<const PlanQuery> queries)
+  {
+    std::vector<std::optional<PathResult>> out(queries.size());
+    for (auto& s : worker_stats_) s = SearchStats{};
+
+    PlanConfig run_cfg = cfg;
+    std::size_t field_cells = 0;
+    if (cfg.algorithm == Algorithm::FlowField && !cfg.flow_fields)
+    {
+      std::vector<rescueops::sim::Vec2i> goals;
+      goals.reserve(queries.size());
+      for (const auto& q : queries) goals.push_back(q.goal);
+      field_cells = flow_fields_.prepare(grid, goals, pool_, cfg.flow_min_share);
+      run_cfg.flow_fields = &flow_fields_;
+    }
+
+    pool_.parallel_for(queries.size(), [&](std::size_t i, unsigned worker) {
+      auto& ctx = contexts_[worker];
+      out[i] = find_path(run_cfg, grid, queries[i].start, queries[i].goal, ctx);
+      worker_stats_[worker].expanded += ctx.stats().expanded;
+      worker_stats_[worker].pushed += ctx.stats().pushed;
+    });
+
+    stats_ = SearchStats{};
+    stats_.expanded = field_cells;
+    for (const auto& s : worker_stats_)
+    {
+      stats_.expanded += s.expanded;
+      stats_.pushed += s.pushed;
+    }
+    return out;
+  }
+} // namespace rescueops::planner
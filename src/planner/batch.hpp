@@ -0,0 +1,46 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "planner/flow_field.hpp"
+#include "planner/plan.hpp"
+#include "sim/thread_pool.hpp"
+
+namespace rescueops::planner
+{
+  struct PlanQuery
+  {
+    rescueops::sim::Vec2i start{};
+    rescueops::sim::Vec2i goal{};
+  };
+
+  // Runs independent point-to-point queries against one immutable grid on a thread pool.
+  // Each pool worker owns a SearchContext (kept across batches), and result i always answers
+  // query i, so the output does not depend on the thread count or on scheduling.
+  // With Algorithm::FlowField (and no cache in the config) queries are grouped by goal: one
+  // distance field per goal shared by at least PlanConfig::flow_min_share queries is built in
+  // parallel and kept for later batches (within the cache's byte budget); other queries use A*.
+  class BatchPlanner
+  {
+   public:
+    explicit BatchPlanner(rescueops::sim::ThreadPool& pool);
+
+    std::vector<std::optional<PathResult>> plan(const PlanConfig& cfg,
+                                                const Grid& grid,
+                                                std::span<const PlanQuery> queries);
+
+    // Summed over the last plan() call; flow-field BFS cells count as expanded.
+    const SearchStats& stats() const { return stats_; }
+
+    // Fields cached by FlowField batches; notify it (or clear it) when the grid changes.
+    FlowFieldCache& flow_fields() { return flow_fields_; }
+
+   private:
+    rescueops::sim::ThreadPool& pool_;
+    std::vector<SearchContext> contexts_; // one per worker
+    std::vector<SearchStats> worker_stats_;
+    SearchStats stats_;
+    FlowFieldCache flow_fields_;
+  };
+} // namespace rescueops::planner
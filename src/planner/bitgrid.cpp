@@ -0,0 +1,140 @@
+#include "planner/bitgrid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace rescueops::planner
+{
+  namespace
+  {
+    constexpr std::uint64_t kAll = ~std::uint64_t{0};
+
+    // Bits [lo, hi) of a word set, 0 <= lo <= hi <= 64.
+    std::uint64_t span_mask(int lo, int hi)
+    {
+      if (lo >= hi) return 0;
+      const std::uint64_t upto = hi >= 64 ? kAll : ((std::uint64_t{1} << hi) - 1);
+      return upto & (kAll << lo);
+    }
+  } // namespace
+
+  BitGrid::BitGrid(int w, int h) : w_(std::max(0, w)), h_(std::max(0, h))
+  {
+    stride_ = (static_cast<std::size_t>(w_) + 2 + 63) / 64;
+    bits_.assign(stride_ * static_cast<std::size_t>(h_ + 2), 0);
+
+    // Sentinels: top/bottom rows, left/right columns and the slack bits past the right column.
+    std::fill(bits_.begin(), bits_.begin() + static_cast<std::ptrdiff_t>(stride_), kAll);
+    std::fill(bits_.end() - static_cast<std::ptrdiff_t>(stride_), bits_.end(), kAll);
+    const int right = w_ + 1;
+    for (int y = 0; y < h_; ++y)
+    {
+      std::uint64_t* r = row(y);
+      r[0] |= 1u;
+      r[right >> 6] |= kAll << (right & 63);
+      for (std::size_t i = static_cast<std::size_t>(right >> 6) + 1; i < stride_; ++i) r[i] = kAll;
+    }
+  }
+
+  BitGrid::BitGrid(const Grid& g) : BitGrid(g.w, g.h)
+  {
+    for (int y = 0; y < h_; ++y)
+    {
+      const std::uint8_t* src = g.blocked.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(w_);
+      std::uint64_t* r = row(y);
+      for (int x = 0; x < w_; ++x)
+      {
+        const int p = x + 1;
+        r[p >> 6] |= static_cast<std::uint64_t>(src[x] != 0) << (p & 63);
+      }
+    }
+  }
+
+  Grid BitGrid::to_grid() const
+  {
+    Grid g;
+    g.w = w_;
+    g.h = h_;
+    g.blocked.assign(static_cast<std::size_t>(w_) * static_cast<std::size_t>(h_), 0);
+    for (int y = 0; y < h_; ++y)
+      for (int x = 0; x < w_; ++x)
+        g.blocked[static_cast<std::size_t>(y) * static_cast<std::size_t>(w_) + static_cast<std::size_t>(x)] =
+          is_blocked(x, y) ? 1 : 0;
+    return g;
+  }
+
+  void BitGrid::set_blocked(int x, int y, bool blocked)
+  {
+    if (!in_bounds(x, y)) return;
+    const int p = x + 1;
+    auto& word = row(y)[p >> 6];
+    const std::uint64_t bit = std::uint64_t{1} << (p & 63);
+    word = blocked ? (word | bit) : (word & ~bit);
+  }
+
+  void BitGrid::fill_rect(int x, int y, int w, int h)
+  {
+    const int x0 = std::max(0, x);
+    const int y0 = std::max(0, y);
+    const int x1 = std::min(w_, x + std::max(0, w));
+    const int y1 = std::min(h_, y + std::max(0, h));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const int p0 = x0 + 1;
+    const int p1 = x1 + 1; // exclusive
+    for (int yy = y0; yy < y1; ++yy)
+    {
+      std::uint64_t* r = row(yy);
+      const int w0 = p0 >> 6;
+      const int w1 = (p1 - 1) >> 6;
+      if (w0 == w1)
+      {
+        r[w0] |= span_mask(p0 & 63, ((p1 - 1) & 63) + 1);
+        continue;
+      }
+      r[w0] |= span_mask(p0 & 63, 64);
+      for (int i = w0 + 1; i < w1; ++i) r[i] = kAll;
+      r[w1] |= span_mask(0, ((p1 - 1) & 63) + 1);
+    }
+  }
+
+  std::size_t BitGrid::count_blocked() const
+  {
+    std::size_t n = 0;
+    for (int y = 0; y < h_; ++y)
+    {
+      const std::uint64_t* r = row(y);
+      for (std::size_t i = 0; i < stride_; ++i)
+      {
+        // Interior is padded columns [1, w]; mask away the border and slack bits.
+        const int lo = static_cast<int>(i * 64);
+        const std::uint64_t m = span_mask(std::max(0, 1 - lo), std::min(64, w_ + 1 - lo));
+        n += static_cast<std::size_t>(std::popcount(r[i] & m));
+      }
+    }
+    return n;
+  }
+
+  std::uint64_t BitGrid::window(int y, int p) const
+  {
+    if (p < 0) return p <= -64 ? kAll : ((window(y, 0) << -p) | span_mask(0, -p));
+
+    const std::uint64_t* r = row(y);
+    const auto wi = static_cast<std::size_t>(p >> 6);
+    const int off = p & 63;
+    if (wi >= stride_) return kAll;
+    std::uint64_t v = r[wi] >> off;
+    if (off != 0) v |= (wi + 1 < stride_ ? r[wi + 1] : kAll) << (64 - off);
+    return v;
+  }
+
+  std::uint64_t BitGrid::bits_from(int x, int y) const
+  {
+    return window(y, x + 1);
+  }
+
+  std::uint64_t BitGrid::bits_until(int x, int y) const
+  {
+    return window(y, x + 1 - 63);
+  }
+} // namespace rescueops::planner
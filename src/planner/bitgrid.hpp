@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  // Compact obstacle grid: 1 bit per cell (1 = blocked) with a one-cell blocked border.
+  // The border makes is_blocked() valid for x in [-1, w] and y in [-1, h], so searches can drop
+  // their bounds checks; rows are stored as 64-bit words so runs can be scanned 64 cells at a time.
+  class BitGrid
+  {
+   public:
+    BitGrid() = default;
+    BitGrid(int w, int h);           // all cells free
+    explicit BitGrid(const Grid& g); // pack a byte grid
+
+    Grid to_grid() const;
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    bool in_bounds(int x, int y) const { return x >= 0 && y >= 0 && x < w_ && y < h_; }
+
+    bool is_blocked(int x, int y) const
+    {
+      const int p = x + 1;
+      return ((row(y)[p >> 6] >> (p & 63)) & 1u) != 0;
+    }
+
+    void set_blocked(int x, int y, bool blocked);
+
+    // Block the rectangle [x, x+w) x [y, y+h), clipped to the grid; whole words where possible.
+    void fill_rect(int x, int y, int w, int h);
+
+    std::size_t count_blocked() const; // popcount over the interior
+
+    // 64-cell windows of row y (y in [-1, h]); cells outside the padded row read as blocked.
+    // bits_from: bit i = blocked(x + i, y).  bits_until: bit 63 - i = blocked(x - i, y).
+    std::uint64_t bits_from(int x, int y) const;
+    std::uint64_t bits_until(int x, int y) const;
+
+    std::size_t words_per_row() const { return stride_; }
+    std::size_t memory_bytes() const { return bits_.size() * sizeof(std::uint64_t); }
+
+   private:
+    const std::uint64_t* row(int y) const { return bits_.data() + static_cast<std::size_t>(y + 1) * stride_; }
+    std::uint64_t* row(int y) { return bits_.data() + static_cast<std::size_t>(y + 1) * stride_; }
+
+    // Window starting at padded column p (may be negative or past the row end).
+    std::uint64_t window(int y, int p) const;
+
+    int w_ = 0;
+    int h_ = 0;
+    std::size_t stride_ = 0; // words per padded row (w + 2 columns)
+    std::vector<std::uint64_t> bits_;
+  };
+} // namespace rescueops::planner
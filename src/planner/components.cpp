@@ -0,0 +1,233 @@
+#include "planner/components.hpp"
+
+#include <algorithm>
+
+namespace rescueops::planner
+{
+  using rescueops::sim::Vec2i;
+
+  namespace
+  {
+    constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  } // namespace
+
+  std::uint32_t ComponentLabels::new_label()
+  {
+    ++live_;
+    if (!free_labels_.empty())
+    {
+      const std::uint32_t l = free_labels_.back();
+      free_labels_.pop_back();
+      return l;
+    }
+    sizes_.push_back(0);
+    return static_cast<std::uint32_t>(sizes_.size() - 1);
+  }
+
+  void ComponentLabels::release(std::uint32_t label)
+  {
+    sizes_[label] = 0;
+    free_labels_.push_back(label);
+    --live_;
+  }
+
+  std::size_t ComponentLabels::flood(const Grid& grid, int seed, std::uint32_t from, std::uint32_t to)
+  {
+    queue_.clear();
+    queue_.push_back(seed);
+    labels_[static_cast<std::size_t>(seed)] = to;
+    for (std::size_t head = 0; head < queue_.size(); ++head)
+    {
+      const int c = queue_[head];
+      const int x = c % w_;
+      const int y = c / w_;
+      for (const auto& d : kDirs)
+      {
+        const int nx = x + d[0];
+        const int ny = y + d[1];
+        if (!grid.in_bounds(nx, ny)) continue;
+        const int n = ny * w_ + nx;
+        if (labels_[static_cast<std::size_t>(n)] != from) continue;
+        labels_[static_cast<std::size_t>(n)] = to;
+        queue_.push_back(n);
+      }
+    }
+    return queue_.size();
+  }
+
+  void ComponentLabels::build(const Grid& grid)
+  {
+    w_ = grid.w;
+    h_ = grid.h;
+    const std::size_t cells = static_cast<std::size_t>(w_) * static_cast<std::size_t>(h_);
+    labels_.assign(cells, kBlocked);
+    visited_.assign(cells, 0);
+    stamp_ = 0;
+    sizes_.assign(1, 0); // label 0 is reserved for blocked cells
+    free_labels_.clear();
+    live_ = 0;
+
+    // Free cells start as a sentinel "unlabelled" value, then get flooded in scan order.
+    constexpr std::uint32_t kUnlabelled = 0xffffffffu;
+    for (std::size_t i = 0; i < cells; ++i)
+      if (grid.blocked[i] == 0) labels_[i] = kUnlabelled;
+
+    for (std::size_t i = 0; i < cells; ++i)
+    {
+      if (labels_[i] != kUnlabelled) continue;
+      const std::uint32_t l = new_label();
+      sizes_[l] = flood(grid, static_cast<int>(i), kUnlabelled, l);
+    }
+  }
+
+  bool ComponentLabels::connected(Vec2i a, Vec2i b) const
+  {
+    if (a.x < 0 || a.y < 0 || a.x >= w_ || a.y >= h_) return false;
+    if (b.x < 0 || b.y < 0 || b.x >= w_ || b.y >= h_) return false;
+    const std::uint32_t la = label(a.x, a.y);
+    return la != kBlocked && la == label(b.x, b.y);
+  }
+
+  void ComponentLabels::on_unblocked(const Grid& grid, int cell)
+  {
+    // Neighbouring components all join; keep the largest label, relabel the rest.
+    std::uint32_t keep = kBlocked;
+    std::uint32_t others[4];
+    int seeds[4];
+    int n = 0;
+    const int x = cell % w_;
+    const int y = cell / w_;
+    for (const auto& d : kDirs)
+    {
+      const int nx = x + d[0];
+      const int ny = y + d[1];
+      if (!grid.in_bounds(nx, ny)) continue;
+      const std::uint32_t l = label(nx, ny);
+      if (l == kBlocked || l == keep || std::find(others, others + n, l) != others + n) continue;
+      if (keep == kBlocked || sizes_[l] > sizes_[keep])
+      {
+        if (keep != kBlocked)
+        {
+          others[n] = keep;
+          seeds[n++] = -1; // resolved below
+        }
+        keep = l;
+      }
+      else
+      {
+        others[n] = l;
+        seeds[n++] = ny * w_ + nx;
+      }
+    }
+
+    if (keep == kBlocked) keep = new_label();
+    labels_[static_cast<std::size_t>(cell)] = keep;
+    sizes_[keep] += 1;
+
+    for (int i = 0; i < n; ++i)
+    {
+      // A label demoted after it was first seen still needs a seed cell next to `cell`.
+      int seed = seeds[i];
+      if (seed < 0)
+      {
+        for (const auto& d : kDirs)
+        {
+          const int nx = x + d[0];
+          const int ny = y + d[1];
+          if (grid.in_bounds(nx, ny) && label(nx, ny) == others[i]) seed = ny * w_ + nx;
+        }
+      }
+      sizes_[keep] += flood(grid, seed, others[i], keep);
+      release(others[i]);
+    }
+  }
+
+  void ComponentLabels::on_blocked(const Grid& grid, int cell)
+  {
+    const std::uint32_t old = labels_[static_cast<std::size_t>(cell)];
+    labels_[static_cast<std::size_t>(cell)] = kBlocked;
+    if (--sizes_[old] == 0)
+    {
+      release(old);
+      return;
+    }
+
+    // Former neighbours that may now be disconnected from each other.
+    int seeds[4];
+    int n = 0;
+    const int x = cell % w_;
+    const int y = cell / w_;
+    for (const auto& d : kDirs)
+    {
+      const int nx = x + d[0];
+      const int ny = y + d[1];
+      if (grid.in_bounds(nx, ny) && label(nx, ny) == old) seeds[n++] = ny * w_ + nx;
+    }
+    if (n <= 1) return;
+
+    // Probe from one seed until every other seed is reached (the usual, local case: nothing
+    // split). If the probe runs dry first, what it visited is a detached piece: give it a label.
+    std::size_t pending = static_cast<std::size_t>(n);
+    while (pending > 1)
+    {
+      if (++stamp_ == 0)
+      {
+        std::fill(visited_.begin(), visited_.end(), 0);
+        stamp_ = 1;
+      }
+      const auto seen = [&](int c) { return visited_[static_cast<std::size_t>(c)] == stamp_; };
+
+      queue_.clear();
+      queue_.push_back(seeds[0]);
+      visited_[static_cast<std::size_t>(seeds[0])] = stamp_;
+      std::size_t found = 1;
+      for (std::size_t head = 0; head < queue_.size() && found < pending; ++head)
+      {
+        const int c = queue_[head];
+        for (const auto& d : kDirs)
+        {
+          const int nx = c % w_ + d[0];
+          const int ny = c / w_ + d[1];
+          if (!grid.in_bounds(nx, ny)) continue;
+          const int nc = ny * w_ + nx;
+          if (label(nx, ny) != old || seen(nc)) continue;
+          visited_[static_cast<std::size_t>(nc)] = stamp_;
+          queue_.push_back(nc);
+          if (std::find(seeds + 1, seeds + pending, nc) != seeds + pending) ++found;
+        }
+      }
+      if (found == pending) break;
+
+      const std::uint32_t fresh = new_label();
+      for (int c : queue_) labels_[static_cast<std::size_t>(c)] = fresh;
+      sizes_[fresh] = queue_.size();
+      sizes_[old] -= queue_.size();
+
+      // Drop the seeds that belonged to the detached piece.
+      std::size_t kept = 0;
+      for (std::size_t i = 0; i < pending; ++i)
+        if (!seen(seeds[i])) seeds[kept++] = seeds[i];
+      pending = kept;
+    }
+  }
+
+  void ComponentLabels::update(const Grid& grid, std::span<const Vec2i> changed)
+  {
+    if (grid.w != w_ || grid.h != h_)
+    {
+      build(grid);
+      return;
+    }
+
+    for (const auto& p : changed)
+    {
+      if (!grid.in_bounds(p.x, p.y)) continue;
+      const int cell = p.y * w_ + p.x;
+      const bool blocked_now = grid.blocked[static_cast<std::size_t>(cell)] != 0;
+      const bool blocked_before = labels_[static_cast<std::size_t>(cell)] == kBlocked;
+      if (blocked_now == blocked_before) continue;
+      if (blocked_now) on_blocked(grid, cell);
+      else on_unblocked(grid, cell);
+    }
+  }
+} // namespace rescueops::planner
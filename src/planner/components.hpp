@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  // 4-connected component labels over the free cells of a Grid.
+  // Planners check connected() first, so a goal walled off from the start fails in O(1) instead of
+  // after flooding everything reachable. Labels are maintained incrementally: unblocking a cell
+  // merges its neighbours' components (the smaller ones are relabelled), blocking one re-floods
+  // around the cell until its former neighbours meet again (or a detached piece is found).
+  class ComponentLabels
+  {
+   public:
+    static constexpr std::uint32_t kBlocked = 0;
+
+    void build(const Grid& grid);
+
+    // Cells whose blocked flag changed; `grid` must already hold the new values.
+    void update(const Grid& grid, std::span<const rescueops::sim::Vec2i> changed);
+
+    std::uint32_t label(int x, int y) const
+    {
+      return labels_[static_cast<std::size_t>(y) * static_cast<std::size_t>(w_) + static_cast<std::size_t>(x)];
+    }
+
+    bool connected(rescueops::sim::Vec2i a, rescueops::sim::Vec2i b) const;
+
+    std::size_t component_count() const { return live_; }
+
+   private:
+    std::uint32_t new_label();
+    void release(std::uint32_t label);
+    // Flood the region of cells currently labelled `from` that contains `seed` with `to`.
+    std::size_t flood(const Grid& grid, int seed, std::uint32_t from, std::uint32_t to);
+
+    void on_unblocked(const Grid& grid, int cell);
+    void on_blocked(const Grid& grid, int cell);
+
+    int w_ = 0;
+    int h_ = 0;
+    std::vector<std::uint32_t> labels_;
+    std::vector<std::size_t> sizes_; // by label; 0 = unused
+    std::vector<std::uint32_t> free_labels_;
+    std::size_t live_ = 0;
+    std::vector<int> queue_;
+    std::vector<std::uint32_t> visited_; // stamped by on_blocked() probes
+    std::uint32_t stamp_ = 0;
+  };
+} // namespace rescueops::planner
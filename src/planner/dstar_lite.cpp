@@ -0,0 +1,240 @@
+#include "planner/dstar_lite.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace rescueops::planner
+{
+  using rescueops::sim::Vec2i;
+
+  namespace
+  {
+    constexpr int kInf = 1 << 29; // headroom for cost + km additions
+
+    constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    int saturating_add(int a, int b)
+    {
+      return (a >= kInf || b >= kInf) ? kInf : std::min(kInf, a + b);
+    }
+  } // namespace
+
+  int DStarLite::heuristic(int cell) const
+  {
+    return std::abs(cell % w_ - start_ % w_) + std::abs(cell / w_ - start_ / w_);
+  }
+
+  int DStarLite::edge_cost(const Grid& grid, int from, int to) const
+  {
+    if (grid.blocked[static_cast<std::size_t>(from)] != 0 || grid.blocked[static_cast<std::size_t>(to)] != 0)
+      return kInf;
+    return 1;
+  }
+
+  DStarLite::Key DStarLite::calculate_key(int cell) const
+  {
+    const int m = std::min(g_[static_cast<std::size_t>(cell)], rhs_[static_cast<std::size_t>(cell)]);
+    return Key{saturating_add(saturating_add(m, heuristic(cell)), km_), m};
+  }
+
+  void DStarLite::push(int cell, Key key)
+  {
+    const auto c = static_cast<std::size_t>(cell);
+    if (!in_open_[c]) ++open_count_;
+    in_open_[c] = 1;
+    open_key_[c] = key;
+    heap_.push_back(Entry{key, cell});
+    ++stats_.pushed;
+    std::push_heap(heap_.begin(), heap_.end(), EntryCmp{});
+
+    // Keep lazily-deleted garbage bounded.
+    if (heap_.size() > 4 * open_count_ + 1024)
+    {
+      heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+                                 [&](const Entry& e) {
+                                   const auto ec = static_cast<std::size_t>(e.cell);
+                                   return !in_open_[ec] || !(open_key_[ec] == e.key);
+                                 }),
+                  heap_.end());
+      std::make_heap(heap_.begin(), heap_.end(), EntryCmp{});
+    }
+  }
+
+  bool DStarLite::top(Entry& out)
+  {
+    while (!heap_.empty())
+    {
+      const auto& e = heap_.front();
+      const auto c = static_cast<std::size_t>(e.cell);
+      if (in_open_[c] && open_key_[c] == e.key)
+      {
+        out = e;
+        return true;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), EntryCmp{});
+      heap_.pop_back();
+    }
+    return false;
+  }
+
+  void DStarLite::reset(const Grid& grid, Vec2i start, Vec2i goal)
+  {
+    w_ = grid.w;
+    h_ = grid.h;
+    const auto cells = static_cast<std::size_t>(w_) * static_cast<std::size_t>(h_);
+    g_.assign(cells, kInf);
+    rhs_.assign(cells, kInf);
+    open_key_.assign(cells, Key{});
+    in_open_.assign(cells, 0);
+    heap_.clear();
+    open_count_ = 0;
+    km_ = 0;
+
+    start_ = grid.in_bounds(start.x, start.y) ? start.y * w_ + start.x : -1;
+    goal_ = grid.in_bounds(goal.x, goal.y) ? goal.y * w_ + goal.x : -1;
+    last_ = start_;
+    if (start_ < 0 || goal_ < 0) return;
+
+    rhs_[static_cast<std::size_t>(goal_)] = 0;
+    push(goal_, calculate_key(goal_));
+  }
+
+  void DStarLite::update_vertex(const Grid& grid, int cell)
+  {
+    const auto c = static_cast<std::size_t>(cell);
+    if (cell != goal_)
+    {
+      int best = kInf;
+      const int x = cell % w_;
+      const int y = cell / w_;
+      for (const auto& d : kDirs)
+      {
+        const int nx = x + d[0];
+        const int ny = y + d[1];
+        if (!grid.in_bounds(nx, ny)) continue;
+        const int n = ny * w_ + nx;
+        best = std::min(best, saturating_add(edge_cost(grid, cell, n), g_[static_cast<std::size_t>(n)]));
+      }
+      rhs_[c] = best;
+    }
+
+    if (in_open_[c])
+    {
+      in_open_[c] = 0;
+      --open_count_;
+    }
+    if (g_[c] != rhs_[c]) push(cell, calculate_key(cell));
+  }
+
+  void DStarLite::compute_shortest_path(const Grid& grid)
+  {
+    const auto s = static_cast<std::size_t>(start_);
+    Entry u;
+    while (top(u) && (u.key < calculate_key(start_) || rhs_[s] != g_[s]))
+    {
+      const auto c = static_cast<std::size_t>(u.cell);
+      const Key k_new = calculate_key(u.cell);
+      if (u.key < k_new)
+      {
+        push(u.cell, k_new);
+        continue;
+      }
+
+      ++stats_.expanded;
+      in_open_[c] = 0;
+      --open_count_;
+
+      const int x = u.cell % w_;
+      const int y = u.cell / w_;
+      if (g_[c] > rhs_[c])
+      {
+        g_[c] = rhs_[c];
+      }
+      else
+      {
+        g_[c] = kInf;
+        update_vertex(grid, u.cell);
+      }
+      for (const auto& d : kDirs)
+      {
+        const int nx = x + d[0];
+        const int ny = y + d[1];
+        if (grid.in_bounds(nx, ny)) update_vertex(grid, ny * w_ + nx);
+      }
+    }
+  }
+
+  void DStarLite::notify_changed(const Grid& grid, std::span<const Vec2i> changed)
+  {
+    if (start_ < 0 || goal_ < 0) return;
+
+    // Standard D* Lite key modifier: keys already queued stay valid lower bounds.
+    km_ += std::abs(last_ % w_ - start_ % w_) + std::abs(last_ / w_ - start_ / w_);
+    last_ = start_;
+
+    for (const auto& p : changed)
+    {
+      if (!grid.in_bounds(p.x, p.y)) continue;
+      update_vertex(grid, p.y * w_ + p.x);
+      for (const auto& d : kDirs)
+      {
+        const int nx = p.x + d[0];
+        const int ny = p.y + d[1];
+        if (grid.in_bounds(nx, ny)) update_vertex(grid, ny * w_ + nx);
+      }
+    }
+  }
+
+  void DStarLite::move_start(Vec2i start)
+  {
+    if (start.x < 0 || start.y < 0 || start.x >= w_ || start.y >= h_) return;
+    start_ = start.y * w_ + start.x;
+  }
+
+  std::optional<PathResult> DStarLite::find_path(const Grid& grid)
+  {
+    stats_ = SearchStats{};
+    if (start_ < 0 || goal_ < 0 || grid.w != w_ || grid.h != h_) return std::nullopt;
+    if (grid.blocked[static_cast<std::size_t>(start_)] != 0 || grid.blocked[static_cast<std::size_t>(goal_)] != 0)
+      return std::nullopt;
+
+    if (last_ != start_)
+    {
+      km_ += std::abs(last_ % w_ - start_ % w_) + std::abs(last_ / w_ - start_ / w_);
+      last_ = start_;
+    }
+    compute_shortest_path(grid);
+
+    const int total = g_[static_cast<std::size_t>(start_)];
+    if (total >= kInf) return std::nullopt;
+
+    // Walk down the g gradient; fixed neighbour order keeps ties deterministic.
+    PathResult out;
+    out.cost = total;
+    int cur = start_;
+    out.path.push_back(Vec2i{cur % w_, cur / w_});
+    while (cur != goal_ && static_cast<int>(out.path.size()) <= total)
+    {
+      int next = -1;
+      int best = kInf;
+      for (const auto& d : kDirs)
+      {
+        const int nx = cur % w_ + d[0];
+        const int ny = cur / w_ + d[1];
+        if (!grid.in_bounds(nx, ny)) continue;
+        const int n = ny * w_ + nx;
+        const int via = saturating_add(edge_cost(grid, cur, n), g_[static_cast<std::size_t>(n)]);
+        if (via < best)
+        {
+          best = via;
+          next = n;
+        }
+      }
+      if (next < 0) return std::nullopt;
+      cur = next;
+      out.path.push_back(Vec2i{cur % w_, cur / w_});
+    }
+    if (cur != goal_) return std::nullopt;
+    return out;
+  }
+} // namespace rescueops::planner
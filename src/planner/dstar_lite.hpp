@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  // Incremental replanning with D* Lite (Koenig & Likhachev) on a 4-connected uniform-cost Grid.
+  // The search runs backwards from the goal and keeps its g/rhs values between calls, so after
+  // cells change (or the unit advances) only the inconsistent part of the tree is repaired.
+  // Like HierarchicalPlanner it holds no reference to the grid: pass the same one to every call.
+  class DStarLite
+  {
+   public:
+    // Forget previous state and plan from `start` to `goal` on `grid`.
+    void reset(const Grid& grid, rescueops::sim::Vec2i start, rescueops::sim::Vec2i goal);
+
+    // Cells whose blocked flag changed; `grid` must already hold the new values.
+    void notify_changed(const Grid& grid, std::span<const rescueops::sim::Vec2i> changed);
+
+    // The unit advanced (typically along the last returned path); the search tree is kept.
+    void move_start(rescueops::sim::Vec2i start);
+
+    // Repair the search as needed and return the current shortest path start -> goal.
+    std::optional<PathResult> find_path(const Grid& grid);
+
+    // Counters for the last find_path() call.
+    const SearchStats& stats() const { return stats_; }
+
+   private:
+    struct Key
+    {
+      int k1 = 0;
+      int k2 = 0;
+      bool operator<(const Key& o) const { return k1 != o.k1 ? k1 < o.k1 : k2 < o.k2; }
+      bool operator==(const Key& o) const { return k1 == o.k1 && k2 == o.k2; }
+    };
+
+    struct Entry
+    {
+      Key key;
+      int cell = 0;
+    };
+
+    struct EntryCmp
+    {
+      bool operator()(const Entry& a, const Entry& b) const
+      {
+        if (!(a.key == b.key)) return b.key < a.key;
+        return a.cell > b.cell; // min-heap; ties broken by cell index for determinism
+      }
+    };
+
+    Key calculate_key(int cell) const;
+    int heuristic(int cell) const;
+    int edge_cost(const Grid& grid, int from, int to) const;
+    void update_vertex(const Grid& grid, int cell);
+    void compute_shortest_path(const Grid& grid);
+
+    void push(int cell, Key key);
+    bool top(Entry& out);
+
+    int w_ = 0;
+    int h_ = 0;
+    int start_ = 0;
+    int goal_ = 0;
+    int last_ = 0; // start at the time of the last key adjustment
+    int km_ = 0;
+
+    std::vector<int> g_;
+    std::vector<int> rhs_;
+    std::vector<Key> open_key_;
+    std::vector<std::uint8_t> in_open_;
+    std::vector<Entry> heap_; // lazy: stale entries are skipped on top()
+    std::size_t open_count_ = 0;
+
+    SearchStats stats_;
+  };
+} // namespace rescueops::planner
@@ -0,0 +1,255 @@
+#include "planner/flow_field.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "sim/thread_pool.hpp"
+
+namespace rescueops::planner
+{
+  using rescueops::sim::Vec2i;
+
+  namespace
+  {
+    constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    // BFS out of `goal` into `dist` (already filled with `unreached`); `queue` ends up holding the
+    // reached cells. Returns false if some cell lies further than `max_dist` steps away.
+    template <typename D>
+    bool flood(const Grid& grid, Vec2i goal, D unreached, int max_dist, std::vector<D>& dist, std::vector<int>& queue)
+    {
+      const int w = grid.w;
+      queue.clear();
+      queue.push_back(goal.y * w + goal.x);
+      dist[static_cast<std::size_t>(queue.back())] = 0;
+      for (std::size_t head = 0; head < queue.size(); ++head)
+      {
+        const int c = queue[head];
+        const int x = c % w;
+        const int y = c / w;
+        const int d = static_cast<int>(dist[static_cast<std::size_t>(c)]) + 1;
+        for (const auto& dir : kDirs)
+        {
+          const int nx = x + dir[0];
+          const int ny = y + dir[1];
+          if (!grid.in_bounds(nx, ny) || grid.is_blocked(nx, ny)) continue;
+          auto& nd = dist[static_cast<std::size_t>(ny * w + nx)];
+          if (nd != unreached) continue;
+          if (d > max_dist) return false;
+          nd = static_cast<D>(d);
+          queue.push_back(ny * w + nx);
+        }
+      }
+      return true;
+    }
+  } // namespace
+
+  std::size_t FlowField::build(const Grid& grid, Vec2i goal)
+  {
+    w_ = grid.w;
+    h_ = grid.h;
+    goal_ = goal;
+    wide_ = false;
+    far_.clear();
+    const std::size_t cells = static_cast<std::size_t>(w_) * static_cast<std::size_t>(h_);
+    near_.assign(cells, kUnreachableNear);
+    if (!grid.in_bounds(goal.x, goal.y) || grid.is_blocked(goal.x, goal.y)) return 0;
+
+    std::vector<int> queue;
+    queue.reserve(cells);
+    if (flood(grid, goal, kUnreachableNear, kUnreachableNear - 1, near_, queue)) return queue.size();
+
+    // Too far for 16 bits: start over with 32-bit distances.
+    near_.clear();
+    near_.shrink_to_fit();
+    wide_ = true;
+    far_.assign(cells, kUnreachable);
+    flood(grid, goal, kUnreachable, std::numeric_limits<int>::max(), far_, queue);
+    return queue.size();
+  }
+
+  int FlowField::distance(Vec2i p) const
+  {
+    if (p.x < 0 || p.y < 0 || p.x >= w_ || p.y >= h_) return kUnreachable;
+    const auto i = static_cast<std::size_t>(p.y * w_ + p.x);
+    if (wide_) return far_[i];
+    return near_[i] == kUnreachableNear ? kUnreachable : near_[i];
+  }
+
+  std::optional<Vec2i> FlowField::next_step(Vec2i p) const
+  {
+    const int d = distance(p);
+    if (d <= 0) return std::nullopt; // unreachable, or already at the goal
+    for (const auto& dir : kDirs)
+    {
+      const Vec2i n{p.x + dir[0], p.y + dir[1]};
+      if (distance(n) == d - 1) return n;
+    }
+    return std::nullopt;
+  }
+
+  std::optional<PathResult> FlowField::path_from(Vec2i start) const
+  {
+    const int d = distance(start);
+    if (d == kUnreachable) return std::nullopt;
+
+    PathResult out;
+    out.cost = d;
+    out.path.reserve(static_cast<std::size_t>(d) + 1);
+    out.path.push_back(start);
+    for (auto step = next_step(start); step; step = next_step(*step)) out.path.push_back(*step);
+    return out;
+  }
+
+  const FlowField* FlowFieldCache::find(Vec2i goal) const
+  {
+    const auto it = fields_.find(key(goal));
+    return it == fields_.end() ? nullptr : it->second.field.get();
+  }
+
+  void FlowFieldCache::reset_for(const Grid& grid)
+  {
+    if (w_ == grid.w && h_ == grid.h) return;
+    clear();
+    w_ = grid.w;
+    h_ = grid.h;
+  }
+
+  FlowFieldCache::Entry& FlowFieldCache::insert(int k)
+  {
+    auto& e = fields_[k];
+    e.field = std::make_unique<FlowField>();
+    lru_.push_front(k);
+    e.lru = lru_.begin();
+    e.used = epoch_;
+    return e;
+  }
+
+  void FlowFieldCache::touch(Entry& e)
+  {
+    lru_.splice(lru_.begin(), lru_, e.lru);
+    e.used = epoch_;
+  }
+
+  FlowFieldCache::Fields::iterator FlowFieldCache::erase(Fields::iterator it)
+  {
+    bytes_ -= it->second.field->memory_bytes();
+    lru_.erase(it->second.lru);
+    return fields_.erase(it);
+  }
+
+  bool FlowFieldCache::make_room(std::size_t need)
+  {
+    while (bytes_ + need > budget_ && !lru_.empty())
+    {
+      const auto it = fields_.find(lru_.back());
+      if (it->second.used == epoch_) return false;
+      erase(it);
+    }
+    return bytes_ + need <= budget_;
+  }
+
+  void FlowFieldCache::set_budget_bytes(std::size_t bytes)
+  {
+    budget_ = bytes;
+    ++epoch_; // nothing is in use between calls
+    make_room(0);
+  }
+
+  void FlowFieldCache::clear()
+  {
+    fields_.clear();
+    lru_.clear();
+    bytes_ = 0;
+  }
+
+  const FlowField& FlowFieldCache::get(const Grid& grid, Vec2i goal)
+  {
+    reset_for(grid);
+    ++epoch_;
+    const auto it = fields_.find(key(goal));
+    if (it != fields_.end())
+    {
+      touch(it->second);
+      return *it->second.field;
+    }
+    make_room(static_cast<std::size_t>(grid.w) * static_cast<std::size_t>(grid.h) * sizeof(std::uint16_t));
+    auto& e = insert(key(goal));
+    e.field->build(grid, goal);
+    bytes_ += e.field->memory_bytes();
+    return *e.field;
+  }
+
+  std::size_t FlowFieldCache::prepare(const Grid& grid,
+                                      std::span<const Vec2i> goals,
+                                      rescueops::sim::ThreadPool& pool,
+                                      std::size_t min_share)
+  {
+    reset_for(grid);
+    ++epoch_;
+
+    // Queries per goal; the most shared goals claim the budget first.
+    std::map<int, std::pair<Vec2i, std::size_t>> counts;
+    for (const auto& g : goals)
+    {
+      if (!grid.in_bounds(g.x, g.y)) continue;
+      auto& c = counts[key(g)];
+      c.first = g;
+      ++c.second;
+    }
+    std::vector<std::pair<Vec2i, std::size_t>> shared;
+    for (const auto& [k, c] : counts)
+    {
+      if (c.second < std::max<std::size_t>(min_share, 1)) continue;
+      const auto it = fields_.find(k);
+      if (it != fields_.end())
+        touch(it->second); // claim cached fields before evicting for new ones
+      else
+        shared.push_back(c);
+    }
+    std::stable_sort(shared.begin(), shared.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    // Register the fields that fit serially (map insertion, eviction), then run the BFS passes
+    // in parallel. Each is charged at 16 bits per cell until its build says otherwise.
+    const std::size_t estimate = static_cast<std::size_t>(grid.w) * static_cast<std::size_t>(grid.h) * sizeof(std::uint16_t);
+    std::vector<std::pair<FlowField*, Vec2i>> missing;
+    for (const auto& c : shared)
+    {
+      if (!make_room(estimate)) break;
+      missing.emplace_back(insert(key(c.first)).field.get(), c.first);
+      bytes_ += estimate;
+    }
+
+    std::vector<std::size_t> visited(missing.size(), 0);
+    pool.parallel_for(missing.size(), [&](std::size_t i, unsigned) {
+      visited[i] = missing[i].first->build(grid, missing[i].second);
+    });
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+      total += visited[i];
+      bytes_ = bytes_ - estimate + missing[i].first->memory_bytes();
+    }
+    return total;
+  }
+
+  void FlowFieldCache::notify_changed(std::span<const Vec2i> changed)
+  {
+    for (auto it = fields_.begin(); it != fields_.end();)
+    {
+      const FlowField& field = *it->second.field;
+      bool affected = false;
+      for (const auto& p : changed)
+      {
+        if (field.distance(p) != FlowField::kUnreachable) affected = true;
+        for (const auto& dir : kDirs)
+          if (field.distance(Vec2i{p.x + dir[0], p.y + dir[1]}) != FlowField::kUnreachable) affected = true;
+        if (affected) break;
+      }
+      it = affected ? erase(it) : std::next(it);
+    }
+  }
+} // namespace rescueops::planner
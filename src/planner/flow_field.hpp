@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::sim
+{
+  class ThreadPool;
+} // namespace rescueops::sim
+
+namespace rescueops::planner
+{
+  // Distance-to-goal field over a Grid, from one BFS out of the goal (unit costs).
+  // Any number of units heading to the same goal then read their next step in O(1) by walking
+  // downhill; following it gives a shortest path (ties broken in fixed neighbour order).
+  // Distances are stored in 16 bits, or in 32 bits if some reachable cell is more than 65534
+  // steps from the goal (a long maze).
+  class FlowField
+  {
+   public:
+    static constexpr int kUnreachable = -1;
+
+    // Returns the number of cells reached.
+    std::size_t build(const Grid& grid, rescueops::sim::Vec2i goal);
+
+    rescueops::sim::Vec2i goal() const { return goal_; }
+    int distance(rescueops::sim::Vec2i p) const;
+    std::optional<rescueops::sim::Vec2i> next_step(rescueops::sim::Vec2i p) const;
+    std::optional<PathResult> path_from(rescueops::sim::Vec2i start) const;
+
+    // Bytes held by the distance array.
+    std::size_t memory_bytes() const { return near_.size() * sizeof(std::uint16_t) + far_.size() * sizeof(int); }
+
+   private:
+    static constexpr std::uint16_t kUnreachableNear = 0xFFFF;
+
+    int w_ = 0;
+    int h_ = 0;
+    rescueops::sim::Vec2i goal_{};
+    bool wide_ = false;
+    std::vector<std::uint16_t> near_; // distances while they fit in 16 bits
+    std::vector<int> far_;            // used instead when they do not
+  };
+
+  // Flow fields keyed by goal cell, kept until the grid changes and bounded by a byte budget:
+  // building past it evicts the least recently used fields. get() and prepare() update recency;
+  // find() does not, so planners on several threads can read the cache while nothing builds.
+  class FlowFieldCache
+  {
+   public:
+    static constexpr std::size_t kDefaultBudgetBytes = std::size_t{256} << 20;
+    // Field for `goal`, or nullptr if it has not been built.
+    const FlowField* find(rescueops::sim::Vec2i goal) const;
+
+    // Field for `goal`, built on first use (even if it alone exceeds the budget).
+    const FlowField& get(const Grid& grid, rescueops::sim::Vec2i goal);
+
+    // `goals` holds one entry per query. Builds the missing field of every goal that appears at
+    // least `min_share` times (one BFS per distinct goal, on `pool`); a goal only a few queries
+    // use is cheaper to plan with A* than to flood the whole grid for. Fields of this call's
+    // goals are not evicted by it; once the budget is full of them, the remaining goals (least
+    // shared first) get no field. Returns the number of cells visited by the new BFS runs.
+    std::size_t prepare(const Grid& grid,
+                        std::span<const rescueops::sim::Vec2i> goals,
+                        rescueops::sim::ThreadPool& pool,
+                        std::size_t min_share = 1);
+
+    // Call after toggling `changed` cells. Drops the fields they could affect: those that reached
+    // the cell or one of its neighbours. Other fields stay valid.
+    void notify_changed(std::span<const rescueops::sim::Vec2i> changed);
+
+    // Evicts least recently used fields until the cache fits `bytes`.
+    void set_budget_bytes(std::size_t bytes);
+    std::size_t budget_bytes() const { return budget_; }
+    std::size_t bytes() const { return bytes_; }
+
+    void clear();
+    std::size_t size() const { return fields_.size(); }
+
+   private:
+    struct Entry
+    {
+      std::unique_ptr<FlowField> field;
+      std::list<int>::iterator lru;
+      std::uint64_t used = 0; // epoch of the last get() / prepare() that needed it
+    };
+    using Fields = std::map<int, Entry>;
+
+    int key(rescueops::sim::Vec2i goal) const { return goal.y * w_ + goal.x; }
+    void reset_for(const Grid& grid);
+    Entry& insert(int k);
+    void touch(Entry& e);
+    Fields::iterator erase(Fields::iterator it);
+    // Evicts from the LRU end until `need` more bytes fit, stopping at a field of the current
+    // epoch. Returns whether they fit.
+    bool make_room(std::size_t need);
+
+    int w_ = 0;
+    int h_ = 0;
+    Fields fields_;
+    std::list<int> lru_; // keys, most recently used first
+    std::size_t budget_ = kDefaultBudgetBytes;
+    std::size_t bytes_ = 0;
+    std::uint64_t epoch_ = 0;
+  };
+} // namespace rescueops::planner
@@ -0,0 +1,344 @@
+#include "planner/hpa.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "sim/thread_pool.hpp"
+
+namespace rescueops::planner
+{
+  using rescueops::sim::Vec2i;
+  using Node = SearchContext::Node;
+
+  namespace
+  {
+    int manhattan(int x1, int y1, int x2, int y2)
+    {
+      return std::abs(x1 - x2) + std::abs(y1 - y2);
+    }
+
+    constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    // Breadth-first search restricted to the rectangle [x0,x1) x [y0,y1).
+    // `dist` (and `parent`, if given) are indexed by rect-local cell; -1 = unreached.
+    // Parents are grid cell indices.
+    void rect_bfs(const Grid& grid, int x0, int y0, int x1, int y1, int src, std::vector<int>& dist,
+                  std::vector<int>* parent)
+    {
+      const int rw = x1 - x0;
+      const auto local = [&](int x, int y) { return static_cast<std::size_t>((y - y0) * rw + (x - x0)); };
+
+      dist.assign(static_cast<std::size_t>(rw * (y1 - y0)), -1);
+      if (parent) parent->assign(dist.size(), -1);
+
+      std::vector<int> queue;
+      queue.reserve(dist.size());
+      queue.push_back(src);
+      dist[local(src % grid.w, src / grid.w)] = 0;
+
+      for (std::size_t head = 0; head < queue.size(); ++head)
+      {
+        const int c = queue[head];
+        const int cx = c % grid.w;
+        const int cy = c / grid.w;
+        const int cd = dist[local(cx, cy)];
+        for (const auto& d : kDirs)
+        {
+          const int nx = cx + d[0];
+          const int ny = cy + d[1];
+          if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1) continue;
+          if (grid.is_blocked(nx, ny)) continue;
+          auto& nd = dist[local(nx, ny)];
+          if (nd != -1) continue;
+          nd = cd + 1;
+          if (parent) (*parent)[local(nx, ny)] = c;
+          queue.push_back(ny * grid.w + nx);
+        }
+      }
+    }
+
+    // Transition placement per maximal run of passable pairs: one in the middle of short runs,
+    // one at each end of long ones.
+    template <class Emit>
+    void place_transitions(int r0, int r1, Emit&& emit)
+    {
+      const int len = r1 - r0 + 1;
+      if (len < 6)
+      {
+        emit(r0 + len / 2);
+        return;
+      }
+      emit(r0);
+      emit(r1);
+    }
+  } // namespace
+
+  HierarchicalPlanner::HierarchicalPlanner(int cluster_size) : cs_(std::max(2, cluster_size)) {}
+
+  std::size_t HierarchicalPlanner::entrance_count() const
+  {
+    std::size_t n = 0;
+    for (const auto& c : clusters_) n += c.entrances.size();
+    return n;
+  }
+
+  int HierarchicalPlanner::entrance_slot(const Cluster& c, int cell) const
+  {
+    const auto it = std::lower_bound(c.entrances.begin(), c.entrances.end(), cell);
+    if (it == c.entrances.end() || *it != cell) return -1;
+    return static_cast<int>(it - c.entrances.begin());
+  }
+
+  void HierarchicalPlanner::compute_borders(const Grid& grid, int cluster)
+  {
+    auto& c = clusters_[static_cast<std::size_t>(cluster)];
+    const int W = grid.w;
+    c.right.clear();
+    c.bottom.clear();
+
+    if (c.x1 < w_)
+    {
+      const int xa = c.x1 - 1;
+      const int xb = c.x1;
+      int run = -1;
+      for (int y = c.y0; y <= c.y1; ++y)
+      {
+        const bool open = y < c.y1 && !grid.is_blocked(xa, y) && !grid.is_blocked(xb, y);
+        if (open && run < 0) run = y;
+        if (!open && run >= 0)
+        {
+          place_transitions(run, y - 1, [&](int ty) { c.right.push_back(Transition{ty * W + xa, ty * W + xb}); });
+          run = -1;
+        }
+      }
+    }
+
+    if (c.y1 < h_)
+    {
+      const int ya = c.y1 - 1;
+      const int yb = c.y1;
+      int run = -1;
+      for (int x = c.x0; x <= c.x1; ++x)
+      {
+        const bool open = x < c.x1 && !grid.is_blocked(x, ya) && !grid.is_blocked(x, yb);
+        if (open && run < 0) run = x;
+        if (!open && run >= 0)
+        {
+          place_transitions(run, x - 1, [&](int tx) { c.bottom.push_back(Transition{ya * W + tx, yb * W + tx}); });
+          run = -1;
+        }
+      }
+    }
+  }
+
+  void HierarchicalPlanner::compute_entrances(const Grid& grid, int cluster)
+  {
+    auto& c = clusters_[static_cast<std::size_t>(cluster)];
+    const int cx = cluster % cw_;
+    const int cy = cluster / cw_;
+
+    c.entrances.clear();
+    for (const auto& t : c.right) c.entrances.push_back(t.a);
+    for (const auto& t : c.bottom) c.entrances.push_back(t.a);
+    if (cx > 0)
+      for (const auto& t : clusters_[static_cast<std::size_t>(cluster - 1)].right) c.entrances.push_back(t.b);
+    if (cy > 0)
+      for (const auto& t : clusters_[static_cast<std::size_t>(cluster - cw_)].bottom) c.entrances.push_back(t.b);
+    std::sort(c.entrances.begin(), c.entrances.end());
+    c.entrances.erase(std::unique(c.entrances.begin(), c.entrances.end()), c.entrances.end());
+
+    const std::size_t n = c.entrances.size();
+    const int rw = c.x1 - c.x0;
+    c.dist.assign(n * n, -1);
+    std::vector<int> dist;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      rect_bfs(grid, c.x0, c.y0, c.x1, c.y1, c.entrances[i], dist, nullptr);
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        const int e = c.entrances[j];
+        c.dist[i * n + j] = dist[static_cast<std::size_t>((e / grid.w - c.y0) * rw + (e % grid.w - c.x0))];
+      }
+    }
+  }
+
+  void HierarchicalPlanner::build(const Grid& grid, unsigned threads)
+  {
+    rescueops::sim::ThreadPool pool(threads);
+    build(grid, pool);
+  }
+
+  void HierarchicalPlanner::build(const Grid& grid, rescueops::sim::ThreadPool& pool)
+  {
+    w_ = grid.w;
+    h_ = grid.h;
+    cw_ = (w_ + cs_ - 1) / cs_;
+    ch_ = (h_ + cs_ - 1) / cs_;
+
+    clusters_.assign(static_cast<std::size_t>(cw_ * ch_), Cluster{});
+    for (int cy = 0; cy < ch_; ++cy)
+    {
+      for (int cx = 0; cx < cw_; ++cx)
+      {
+        auto& c = clusters_[static_cast<std::size_t>(cy * cw_ + cx)];
+        c.x0 = cx * cs_;
+        c.y0 = cy * cs_;
+        c.x1 = std::min(w_, c.x0 + cs_);
+        c.y1 = std::min(h_, c.y0 + cs_);
+      }
+    }
+
+    // Entrances read the neighbours' borders, so all borders go first.
+    pool.parallel_for(clusters_.size(),
+                      [&](std::size_t i, unsigned) { compute_borders(grid, static_cast<int>(i)); });
+    pool.parallel_for(clusters_.size(),
+                      [&](std::size_t i, unsigned) { compute_entrances(grid, static_cast<int>(i)); });
+  }
+
+  void HierarchicalPlanner::update(const Grid& grid, std::span<const Vec2i> changed)
+  {
+    if (grid.w != w_ || grid.h != h_)
+    {
+      build(grid);
+      return;
+    }
+
+    std::vector<int> dirty;
+    for (const auto& p : changed)
+    {
+      if (!grid.in_bounds(p.x, p.y)) continue;
+      const int k = cluster_of(p.x, p.y);
+      const auto& c = clusters_[static_cast<std::size_t>(k)];
+      dirty.push_back(k);
+      if (p.x == c.x0 && c.x0 > 0) dirty.push_back(k - 1);
+      if (p.x == c.x1 - 1 && c.x1 < w_) dirty.push_back(k + 1);
+      if (p.y == c.y0 && c.y0 > 0) dirty.push_back(k - cw_);
+      if (p.y == c.y1 - 1 && c.y1 < h_) dirty.push_back(k + cw_);
+    }
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    // A changed cell on a shared edge marks both sides dirty, so every border it touches is
+    // recomputed by its owner before entrances are rebuilt.
+    for (int k : dirty) compute_borders(grid, k);
+    for (int k : dirty) compute_entrances(grid, k);
+  }
+
+  std::optional<PathResult> HierarchicalPlanner::find_path(const Grid& grid,
+                                                           Vec2i start,
+                                                           Vec2i goal,
+                                                           SearchContext& ctx) const
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+    if (grid.w != w_ || grid.h != h_ || clusters_.empty()) return std::nullopt;
+
+    const int W = grid.w;
+    const int scell = start.y * W + start.x;
+    const int gcell = goal.y * W + goal.x;
+    const int sk = cluster_of(start.x, start.y);
+    const int gk = cluster_of(goal.x, goal.y);
+    const auto& sc = clusters_[static_cast<std::size_t>(sk)];
+    const auto& gc = clusters_[static_cast<std::size_t>(gk)];
+    const auto local = [W](const Cluster& c, int cell) {
+      return static_cast<std::size_t>((cell / W - c.y0) * (c.x1 - c.x0) + (cell % W - c.x0));
+    };
+
+    // Temporary edges from start / to goal inside their own clusters.
+    std::vector<int> sdist;
+    std::vector<int> gdist;
+    rect_bfs(grid, sc.x0, sc.y0, sc.x1, sc.y1, scell, sdist, nullptr);
+    rect_bfs(grid, gc.x0, gc.y0, gc.x1, gc.y1, gcell, gdist, nullptr);
+
+    ctx.begin(static_cast<std::size_t>(W) * static_cast<std::size_t>(grid.h));
+    auto& stats = ctx.stats();
+
+    ctx.set(static_cast<std::size_t>(scell), 0, -1);
+    ctx.push(Node{start.x, start.y, 0, manhattan(start.x, start.y, goal.x, goal.y)});
+
+    Node cur;
+    while (ctx.pop(cur))
+    {
+      const int cidx = cur.y * W + cur.x;
+      if (cur.g > ctx.g(static_cast<std::size_t>(cidx))) continue;
+      ++stats.expanded;
+
+      if (cidx == gcell) break;
+
+      const auto relax = [&](int to, int cost) {
+        const int tentative_g = cur.g + cost;
+        if (tentative_g >= ctx.g(static_cast<std::size_t>(to))) return;
+        ctx.set(static_cast<std::size_t>(to), tentative_g, cidx);
+        const int tx = to % W;
+        const int ty = to / W;
+        ctx.push(Node{tx, ty, tentative_g, tentative_g + manhattan(tx, ty, goal.x, goal.y)});
+      };
+
+      if (cidx == scell)
+      {
+        for (int e : sc.entrances)
+        {
+          const int d = sdist[local(sc, e)];
+          if (d > 0) relax(e, d);
+        }
+        if (sk == gk && sdist[local(sc, gcell)] >= 0) relax(gcell, sdist[local(sc, gcell)]);
+      }
+
+      const int k = cluster_of(cur.x, cur.y);
+      const auto& c = clusters_[static_cast<std::size_t>(k)];
+      const int slot = entrance_slot(c, cidx);
+      if (slot < 0) continue;
+
+      const std::size_t n = c.entrances.size();
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        const int d = c.dist[static_cast<std::size_t>(slot) * n + j];
+        if (d > 0) relax(c.entrances[j], d);
+      }
+
+      // Any passable neighbour across the cluster edge that is itself an entrance.
+      for (const auto& d : kDirs)
+      {
+        const int nx = cur.x + d[0];
+        const int ny = cur.y + d[1];
+        if (!grid.in_bounds(nx, ny) || grid.is_blocked(nx, ny)) continue;
+        const int nk = cluster_of(nx, ny);
+        if (nk == k) continue;
+        if (entrance_slot(clusters_[static_cast<std::size_t>(nk)], ny * W + nx) >= 0) relax(ny * W + nx, 1);
+      }
+
+      if (k == gk && gdist[local(gc, cidx)] >= 0) relax(gcell, gdist[local(gc, cidx)]);
+    }
+
+    if (!ctx.visited(static_cast<std::size_t>(gcell))) return std::nullopt;
+
+    std::vector<int> abstract;
+    for (int c = gcell; c != -1; c = ctx.parent(static_cast<std::size_t>(c))) abstract.push_back(c);
+    std::reverse(abstract.begin(), abstract.end());
+
+    // Refine: adjacent nodes are joined directly, others by a BFS inside their shared cluster.
+    PathResult out;
+    out.cost = ctx.g(static_cast<std::size_t>(gcell));
+    out.path.push_back(start);
+    std::vector<int> dist;
+    std::vector<int> parent;
+    std::vector<int> segment;
+    for (std::size_t i = 1; i < abstract.size(); ++i)
+    {
+      const int u = abstract[i - 1];
+      const int v = abstract[i];
+      if (manhattan(u % W, u / W, v % W, v / W) == 1)
+      {
+        out.path.push_back(Vec2i{v % W, v / W});
+        continue;
+      }
+
+      const auto& c = clusters_[static_cast<std::size_t>(cluster_of(u % W, u / W))];
+      rect_bfs(grid, c.x0, c.y0, c.x1, c.y1, u, dist, &parent);
+      segment.clear();
+      for (int p = v; p != u; p = parent[local(c, p)]) segment.push_back(p);
+      for (auto it = segment.rbegin(); it != segment.rend(); ++it) out.path.push_back(Vec2i{*it % W, *it / W});
+    }
+    return out;
+  }
+} // namespace rescueops::planner
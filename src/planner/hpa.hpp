@@ -0,0 +1,80 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::sim
+{
+  class ThreadPool;
+} // namespace rescueops::sim
+
+namespace rescueops::planner
+{
+  // Hierarchical path-finding (HPA*) over a Grid.
+  // The grid is partitioned into square clusters. For every border between two clusters, each
+  // maximal run of passable cell pairs gets one or two transitions; transition cells become abstract
+  // nodes, and exact intra-cluster distances between them are precomputed. A query connects start
+  // and goal to their cluster's entrances, searches the small abstract graph, then refines each
+  // abstract edge with a cluster-local search.
+  //
+  // Paths are near-optimal (cost can exceed astar() slightly), and a path is found iff one exists.
+  // The planner holds no reference to the grid: pass the same grid to every call, and call update()
+  // after changing cells.
+  class HierarchicalPlanner
+  {
+   public:
+    explicit HierarchicalPlanner(int cluster_size = 16);
+
+    // Full precompute. Clusters are independent, so the work is split over `threads` workers
+    // (0 = hardware concurrency).
+    void build(const Grid& grid, unsigned threads = 1);
+    void build(const Grid& grid, rescueops::sim::ThreadPool& pool);
+
+    // Recompute only clusters affected by `changed` cells (already written into `grid`): the
+    // cluster holding each cell and, for cells on a cluster edge, the neighbour across that edge.
+    void update(const Grid& grid, std::span<const rescueops::sim::Vec2i> changed);
+
+    std::optional<PathResult> find_path(const Grid& grid,
+                                        rescueops::sim::Vec2i start,
+                                        rescueops::sim::Vec2i goal,
+                                        SearchContext& ctx) const;
+
+    int cluster_size() const { return cs_; }
+    std::size_t cluster_count() const { return clusters_.size(); }
+    std::size_t entrance_count() const;
+
+   private:
+    struct Transition
+    {
+      int a = 0; // cell index in the owning cluster
+      int b = 0; // cell index in the right/bottom neighbour
+    };
+
+    struct Cluster
+    {
+      int x0 = 0;
+      int y0 = 0;
+      int x1 = 0; // exclusive
+      int y1 = 0; // exclusive
+      std::vector<Transition> right;  // border with cluster (cx + 1, cy)
+      std::vector<Transition> bottom; // border with cluster (cx, cy + 1)
+      std::vector<int> entrances;     // sorted cell indices
+      std::vector<int> dist;          // entrances.size()^2, -1 = unreachable inside the cluster
+    };
+
+    int cluster_of(int x, int y) const { return (y / cs_) * cw_ + (x / cs_); }
+    int entrance_slot(const Cluster& c, int cell) const;
+
+    void compute_borders(const Grid& grid, int cluster);
+    void compute_entrances(const Grid& grid, int cluster);
+
+    int cs_ = 16;
+    int w_ = 0;
+    int h_ = 0;
+    int cw_ = 0; // clusters per row
+    int ch_ = 0; // clusters per column
+    std::vector<Cluster> clusters_;
+  };
+} // namespace rescueops::planner
@@ -0,0 +1,233 @@
+#include "planner/jps.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+
+#include "planner/bitgrid.hpp"
+
+namespace rescueops::planner
+{
+  using rescueops::sim::Vec2i;
+  using Node = SearchContext::Node;
+
+  namespace
+  {
+    int manhattan(int x1, int y1, int x2, int y2)
+    {
+      return std::abs(x1 - x2) + std::abs(y1 - y2);
+    }
+
+    int sign(int v)
+    {
+      return (v > 0) - (v < 0);
+    }
+
+    // Canonical 4-connected ordering: horizontal runs only stop at forced neighbours; vertical runs
+    // additionally stop wherever a horizontal run from that cell would find a jump point.
+    template <class G>
+    struct Jumper
+    {
+      const G& grid;
+      Vec2i goal;
+
+      bool free(int x, int y) const { return grid.in_bounds(x, y) && !grid.is_blocked(x, y); }
+
+      std::optional<Vec2i> horizontal(int x, int y, int dx) const
+      {
+        while (true)
+        {
+          x += dx;
+          if (!free(x, y)) return std::nullopt;
+          if (x == goal.x && y == goal.y) return Vec2i{x, y};
+          if ((free(x, y - 1) && !free(x - dx, y - 1)) || (free(x, y + 1) && !free(x - dx, y + 1)))
+            return Vec2i{x, y};
+        }
+      }
+
+      std::optional<Vec2i> vertical(int x, int y, int dy) const
+      {
+        while (true)
+        {
+          y += dy;
+          if (!free(x, y)) return std::nullopt;
+          if (x == goal.x && y == goal.y) return Vec2i{x, y};
+          if ((free(x - 1, y) && !free(x - 1, y - dy)) || (free(x + 1, y) && !free(x + 1, y - dy)))
+            return Vec2i{x, y};
+          if (horizontal(x, y, 1) || horizontal(x, y, -1)) return Vec2i{x, y};
+        }
+      }
+
+      std::optional<Vec2i> jump(int x, int y, int dx, int dy) const
+      {
+        return dx != 0 ? horizontal(x, y, dx) : vertical(x, y, dy);
+      }
+    };
+
+    // Bit-packed rows: horizontal runs test 63 cells per step. A cell is forced when the cell
+    // above (below) it is free while the one behind that is blocked; with bit i <-> cell i that is
+    // `row & ~(row >> 1)` in scan direction. The border sentinel guarantees every run terminates.
+    template <>
+    struct Jumper<BitGrid>
+    {
+      static constexpr std::uint64_t kLow63 = ~std::uint64_t{0} >> 1;
+      static constexpr std::uint64_t kHigh63 = ~std::uint64_t{0} << 1;
+
+      const BitGrid& grid;
+      Vec2i goal;
+
+      bool free(int x, int y) const { return !grid.is_blocked(x, y); }
+
+      std::optional<Vec2i> horizontal(int x, int y, int dx) const
+      {
+        if (dx > 0)
+        {
+          for (int x0 = x + 1;; x0 += 63)
+          {
+            const std::uint64_t up = grid.bits_from(x0 - 1, y - 1);
+            const std::uint64_t down = grid.bits_from(x0 - 1, y + 1);
+            const std::uint64_t forced = ((up & ~(up >> 1)) | (down & ~(down >> 1))) & kLow63;
+            int stop = forced ? std::countr_zero(forced) : 63;
+            if (goal.y == y && goal.x >= x0 && goal.x - x0 < stop) stop = goal.x - x0;
+
+            const std::uint64_t blocked = grid.bits_from(x0, y) & kLow63;
+            if (blocked && std::countr_zero(blocked) <= stop) return std::nullopt;
+            if (stop < 63) return Vec2i{x0 + stop, y};
+          }
+        }
+
+        for (int x0 = x - 1;; x0 -= 63)
+        {
+          const std::uint64_t up = grid.bits_until(x0 + 1, y - 1);
+          const std::uint64_t down = grid.bits_until(x0 + 1, y + 1);
+          const std::uint64_t forced = ((up & ~(up << 1)) | (down & ~(down << 1))) & kHigh63;
+          int stop = forced ? std::countl_zero(forced) : 63;
+          if (goal.y == y && goal.x <= x0 && x0 - goal.x < stop) stop = x0 - goal.x;
+
+          const std::uint64_t blocked = grid.bits_until(x0, y) & kHigh63;
+          if (blocked && std::countl_zero(blocked) <= stop) return std::nullopt;
+          if (stop < 63) return Vec2i{x0 - stop, y};
+        }
+      }
+
+      std::optional<Vec2i> vertical(int x, int y, int dy) const
+      {
+        while (true)
+        {
+          y += dy;
+          if (!free(x, y)) return std::nullopt;
+          if (x == goal.x && y == goal.y) return Vec2i{x, y};
+          if ((free(x - 1, y) && !free(x - 1, y - dy)) || (free(x + 1, y) && !free(x + 1, y - dy)))
+            return Vec2i{x, y};
+          if (horizontal(x, y, 1) || horizontal(x, y, -1)) return Vec2i{x, y};
+        }
+      }
+
+      std::optional<Vec2i> jump(int x, int y, int dx, int dy) const
+      {
+        return dx != 0 ? horizontal(x, y, dx) : vertical(x, y, dy);
+      }
+    };
+
+    template <class G>
+    std::optional<PathResult> search(const G& grid, int W, int H, Vec2i start, Vec2i goal, SearchContext& ctx)
+    {
+      const auto idx = [W](int x, int y) { return y * W + x; };
+
+      ctx.begin(static_cast<std::size_t>(W) * static_cast<std::size_t>(H));
+      auto& stats = ctx.stats();
+      const Jumper<G> jumper{grid, goal};
+
+      ctx.set(static_cast<std::size_t>(idx(start.x, start.y)), 0, -1);
+      ctx.push(Node{start.x, start.y, 0, manhattan(start.x, start.y, goal.x, goal.y)});
+
+      Node cur;
+      while (ctx.pop(cur))
+      {
+        const int cidx = idx(cur.x, cur.y);
+        if (cur.g > ctx.g(static_cast<std::size_t>(cidx))) continue;
+        ++stats.expanded;
+
+        if (cur.x == goal.x && cur.y == goal.y)
+        {
+          // Reconstruct: consecutive jump points are joined by straight runs.
+          PathResult out;
+          out.cost = cur.g;
+          int c = cidx;
+          while (c != -1)
+          {
+            const int p = ctx.parent(static_cast<std::size_t>(c));
+            Vec2i at{c % W, c / W};
+            out.path.push_back(at);
+            if (p != -1)
+            {
+              const Vec2i to{p % W, p / W};
+              const int sx = sign(to.x - at.x);
+              const int sy = sign(to.y - at.y);
+              for (int n = manhattan(at.x, at.y, to.x, to.y); n > 1; --n)
+              {
+                at.x += sx;
+                at.y += sy;
+                out.path.push_back(at);
+              }
+            }
+            c = p;
+          }
+          std::reverse(out.path.begin(), out.path.end());
+          return out;
+        }
+
+        // Successor directions: all four at the start, otherwise straight on plus the two turns.
+        Vec2i dirs[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        int ndirs = 4;
+        const int pidx = ctx.parent(static_cast<std::size_t>(cidx));
+        if (pidx != -1)
+        {
+          const Vec2i d{sign(cur.x - pidx % W), sign(cur.y - pidx / W)};
+          ndirs = 3;
+          dirs[0] = d;
+          dirs[1] = d.x != 0 ? Vec2i{0, 1} : Vec2i{1, 0};
+          dirs[2] = d.x != 0 ? Vec2i{0, -1} : Vec2i{-1, 0};
+        }
+
+        for (int i = 0; i < ndirs; ++i)
+        {
+          const auto jp = jumper.jump(cur.x, cur.y, dirs[i].x, dirs[i].y);
+          if (!jp) continue;
+
+          const int nidx = idx(jp->x, jp->y);
+          const int tentative_g = cur.g + manhattan(cur.x, cur.y, jp->x, jp->y);
+          if (tentative_g < ctx.g(static_cast<std::size_t>(nidx)))
+          {
+            ctx.set(static_cast<std::size_t>(nidx), tentative_g, cidx);
+            const int h = manhattan(jp->x, jp->y, goal.x, goal.y);
+            ctx.push(Node{jp->x, jp->y, tentative_g, tentative_g + h});
+          }
+        }
+      }
+
+      return std::nullopt;
+    }
+  } // namespace
+
+  std::optional<PathResult> jps(const Grid& grid, Vec2i start, Vec2i goal)
+  {
+    SearchContext ctx;
+    return jps(grid, start, goal, ctx);
+  }
+
+  std::optional<PathResult> jps(const Grid& grid, Vec2i start, Vec2i goal, SearchContext& ctx)
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+    return search(grid, grid.w, grid.h, start, goal, ctx);
+  }
+
+  std::optional<PathResult> jps(const BitGrid& grid, Vec2i start, Vec2i goal, SearchContext& ctx)
+  {
+    if (!grid.in_bounds(start.x, start.y) || !grid.in_bounds(goal.x, goal.y)) return std::nullopt;
+    if (grid.is_blocked(start.x, start.y) || grid.is_blocked(goal.x, goal.y)) return std::nullopt;
+    return search(grid, grid.width(), grid.height(), start, goal, ctx);
+  }
+} // namespace rescueops::planner
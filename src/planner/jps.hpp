@@ -0,0 +1,24 @@
+#pragma once
+#include <optional>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  // Jump Point Search for 4-connected, uniform-cost grids.
+  // Expands only jump points (cells with forced neighbours, or the goal) instead of every cell on
+  // symmetric paths. Returns the same cost as astar(); the returned path is expanded cell-by-cell,
+  // but among equal-cost paths it may pick a different one.
+  std::optional<PathResult> jps(const Grid& grid, rescueops::sim::Vec2i start, rescueops::sim::Vec2i goal);
+
+  std::optional<PathResult> jps(const Grid& grid,
+                                rescueops::sim::Vec2i start,
+                                rescueops::sim::Vec2i goal,
+                                SearchContext& ctx);
+
+  // Bit-packed variant: same jump points and result; horizontal runs are scanned a word at a time.
+  std::optional<PathResult> jps(const BitGrid& grid,
+                                rescueops::sim::Vec2i start,
+                                rescueops::sim::Vec2i goal,
+                                SearchContext& ctx);
+} // namespace rescueops::planner
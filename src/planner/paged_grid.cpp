@@ -0,0 +1,265 @@
+#include "planner/paged_grid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string_view>
+
+#include "sim/binary_io.hpp"
+
+namespace rescueops::planner
+{
+  namespace
+  {
+    constexpr std::string_view kMagic = "RSOPTILE";
+    constexpr std::size_t kHeaderBytes = 64;
+    constexpr std::uint64_t kAllFree = 0;
+    constexpr std::uint64_t kAllBlocked = 1;
+
+    bool fail(std::string* error, const std::string& what)
+    {
+      if (error) *error = what;
+      return false;
+    }
+
+    bool valid_tile_size(int tile_size)
+    {
+      return tile_size >= 64 && tile_size <= (1 << 16) && std::has_single_bit(static_cast<unsigned>(tile_size));
+    }
+  } // namespace
+
+  bool write_tile_file(const std::string& path,
+                       int width,
+                       int height,
+                       int tile_size,
+                       const TileBandFill& fill_band,
+                       std::string* error)
+  {
+    if (width < 0 || height < 0) return fail(error, "negative grid size");
+    if (!valid_tile_size(tile_size)) return fail(error, "tile size must be a power of two in [64, 65536]");
+
+    const auto w = static_cast<std::size_t>(width);
+    const auto ts = static_cast<std::size_t>(tile_size);
+    const std::size_t tiles_x = (w + ts - 1) / ts;
+    const std::size_t tiles_y = (static_cast<std::size_t>(height) + ts - 1) / ts;
+    const std::size_t words_per_row = ts / 64;
+    const std::size_t tile_bytes = ts * words_per_row * 8;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return fail(error, "cannot write " + path);
+
+    // Header and tile table are written last; reserve their space first.
+    const std::size_t table_bytes = tiles_x * tiles_y * 8;
+    std::uint64_t pos = kHeaderBytes + table_bytes;
+    out.write(std::string(static_cast<std::size_t>(pos), '\0').data(), static_cast<std::streamsize>(pos));
+
+    std::vector<std::uint64_t> table(tiles_x * tiles_y, kAllFree);
+    std::vector<std::uint8_t> band(ts * w);
+    sim::BinaryWriter tile;
+    std::uint64_t blocked_cells = 0;
+    for (std::size_t by = 0; by < tiles_y; ++by)
+    {
+      const int y0 = static_cast<int>(by * ts);
+      const int rows = std::min(tile_size, height - y0);
+      std::fill(band.begin(), band.end(), 0);
+      fill_band(y0, rows, std::span<std::uint8_t>(band.data(), static_cast<std::size_t>(rows) * w));
+
+      for (std::size_t bx = 0; bx < tiles_x; ++bx)
+      {
+        const std::size_t x0 = bx * ts;
+        const std::size_t cols = std::min(ts, w - x0);
+        tile = sim::BinaryWriter{};
+        std::uint64_t in_tile = 0;
+        for (std::size_t ty = 0; ty < ts; ++ty)
+        {
+          const std::uint8_t* row = ty < static_cast<std::size_t>(rows) ? band.data() + ty * w + x0 : nullptr;
+          for (std::size_t i = 0; i < words_per_row; ++i)
+          {
+            std::uint64_t word = 0;
+            const std::size_t begin = i * 64;
+            const std::size_t end = row ? std::min(cols, begin + 64) : begin;
+            for (std::size_t b = begin; b < end; ++b) word |= static_cast<std::uint64_t>(row[b] != 0) << (b - begin);
+            in_tile += static_cast<std::uint64_t>(std::popcount(word));
+            tile.u64(word);
+          }
+        }
+        blocked_cells += in_tile;
+
+        auto& entry = table[by * tiles_x + bx];
+        if (in_tile == 0) continue;
+        if (in_tile == static_cast<std::uint64_t>(rows) * cols)
+        {
+          entry = kAllBlocked;
+          continue;
+        }
+        entry = pos;
+        out.write(tile.data().data(), static_cast<std::streamsize>(tile_bytes));
+        pos += tile_bytes;
+      }
+    }
+
+    sim::BinaryWriter header;
+    header.bytes(kMagic);
+    header.u32(kTileFileVersion);
+    header.u32(static_cast<std::uint32_t>(tile_size));
+    header.i32(width);
+    header.i32(height);
+    header.u64(tiles_x);
+    header.u64(tiles_y);
+    header.u64(blocked_cells);
+    header.u64(pos);
+    header.u64(0);
+    for (const auto offset : table) header.u64(offset);
+    out.seekp(0);
+    out.write(header.data().data(), static_cast<std::streamsize>(header.size()));
+    if (!out) return fail(error, "cannot write " + path);
+    return true;
+  }
+
+  bool write_tile_file(const std::string& path, const Grid& grid, int tile_size, std::string* error)
+  {
+    if (grid.blocked.size() != static_cast<std::size_t>(std::max(0, grid.w)) * static_cast<std::size_t>(std::max(0, grid.h)))
+      return fail(error, "grid size does not match its cells");
+    const auto w = static_cast<std::size_t>(grid.w);
+    return write_tile_file(
+      path, grid.w, grid.h, tile_size,
+      [&](int y0, int rows, std::span<std::uint8_t> band) {
+        std::memcpy(band.data(), grid.blocked.data() + static_cast<std::size_t>(y0) * w, static_cast<std::size_t>(rows) * w);
+      },
+      error);
+  }
+
+  bool PagedGrid::open(const std::string& path, std::size_t memory_budget_bytes, std::string* error)
+  {
+    *this = PagedGrid{};
+    if constexpr (std::endian::native != std::endian::little) return fail(error, "tile files need a little-endian host");
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail(error, "cannot open " + path);
+    in.seekg(0, std::ios::end);
+    const auto file_bytes = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    std::string head(kHeaderBytes, '\0');
+    in.read(head.data(), static_cast<std::streamsize>(head.size()));
+    if (!in) return fail(error, "not a tile file (too short)");
+    sim::BinaryReader r(head);
+    if (r.bytes(kMagic.size()) != kMagic) return fail(error, "not a tile file (bad magic)");
+    const auto version = r.u32();
+    if (version != kTileFileVersion) return fail(error, "unsupported tile file version " + std::to_string(version));
+    const auto tile_size = static_cast<int>(r.u32());
+    const auto width = r.i32();
+    const auto height = r.i32();
+    const auto tiles_x = r.u64();
+    const auto tiles_y = r.u64();
+    const auto blocked_cells = r.u64();
+    const auto recorded_bytes = r.u64();
+    if (recorded_bytes != file_bytes) return fail(error, "file size does not match the header");
+    if (!valid_tile_size(tile_size) || width < 0 || height < 0)
+      return fail(error, "inconsistent header");
+    const auto ts = static_cast<std::uint64_t>(tile_size);
+    if (tiles_x != (static_cast<std::uint64_t>(width) + ts - 1) / ts ||
+        tiles_y != (static_cast<std::uint64_t>(height) + ts - 1) / ts)
+      return fail(error, "inconsistent header");
+
+    const std::uint64_t tiles = tiles_x * tiles_y;
+    if (tiles > (file_bytes - kHeaderBytes) / 8) return fail(error, "truncated tile table");
+    std::string table(static_cast<std::size_t>(tiles * 8), '\0');
+    in.read(table.data(), static_cast<std::streamsize>(table.size()));
+    if (!in) return fail(error, "truncated tile table");
+
+    // Every data offset must lie inside the file, past the table, so loads cannot fail later.
+    const std::uint64_t tile_bytes = ts * ts / 8;
+    const std::uint64_t data_begin = kHeaderBytes + tiles * 8;
+    sim::BinaryReader tr(table);
+    std::vector<std::uint64_t> offsets(static_cast<std::size_t>(tiles));
+    std::size_t data_tiles = 0;
+    for (auto& offset : offsets)
+    {
+      offset = tr.u64();
+      if (offset <= kAllBlocked) continue;
+      if (offset < data_begin || offset > file_bytes || tile_bytes > file_bytes - offset)
+        return fail(error, "tile data out of bounds");
+      ++data_tiles;
+    }
+
+    w_ = width;
+    h_ = height;
+    tile_size_ = tile_size;
+    tile_shift_ = std::countr_zero(static_cast<unsigned>(tile_size));
+    tile_mask_ = tile_size - 1;
+    tiles_x_ = static_cast<std::size_t>(tiles_x);
+    words_per_row_ = static_cast<std::size_t>(ts / 64);
+    tile_words_ = static_cast<std::size_t>(tile_bytes / 8);
+    blocked_count_ = static_cast<std::size_t>(blocked_cells);
+    offsets_ = std::move(offsets);
+
+    const std::size_t capacity =
+      std::max<std::size_t>(1, std::min<std::size_t>(memory_budget_bytes / static_cast<std::size_t>(tile_bytes), data_tiles));
+    slot_of_.assign(offsets_.size(), kNoSlot);
+    slot_owner_.assign(capacity, 0);
+    prev_.assign(capacity, kNoSlot);
+    next_.assign(capacity, kNoSlot);
+    data_.reserve(capacity * tile_words_);
+    file_ = std::move(in);
+    return true;
+  }
+
+  void PagedGrid::unlink(std::uint32_t slot) const
+  {
+    const std::uint32_t p = prev_[slot];
+    const std::uint32_t n = next_[slot];
+    (p == kNoSlot ? head_ : next_[p]) = n;
+    (n == kNoSlot ? tail_ : prev_[n]) = p;
+  }
+
+  void PagedGrid::push_front(std::uint32_t slot) const
+  {
+    prev_[slot] = kNoSlot;
+    next_[slot] = head_;
+    (head_ == kNoSlot ? tail_ : prev_[head_]) = slot;
+    head_ = slot;
+  }
+
+  const std::uint64_t* PagedGrid::tile_words(std::size_t t) const
+  {
+    std::uint32_t slot = slot_of_[t];
+    if (slot != kNoSlot)
+    {
+      ++stats_.hits;
+      if (slot != head_)
+      {
+        unlink(slot);
+        push_front(slot);
+      }
+    }
+    else
+    {
+      ++stats_.misses;
+      if (stats_.resident_tiles < slot_owner_.size())
+      {
+        slot = static_cast<std::uint32_t>(stats_.resident_tiles++);
+        data_.resize(data_.size() + tile_words_); // within the reserved capacity: no reallocation
+      }
+      else
+      {
+        slot = tail_;
+        unlink(slot);
+        slot_of_[slot_owner_[slot]] = kNoSlot;
+        ++stats_.evictions;
+      }
+      slot_of_[t] = slot;
+      slot_owner_[slot] = t;
+      push_front(slot);
+
+      std::uint64_t* words = data_.data() + static_cast<std::size_t>(slot) * tile_words_;
+      file_.clear();
+      file_.seekg(static_cast<std::streamoff>(offsets_[t]));
+      file_.read(reinterpret_cast<char*>(words), static_cast<std::streamsize>(tile_words_ * 8));
+      if (!file_) std::fill(words, words + tile_words_, ~std::uint64_t{0});
+    }
+    last_tile_ = t;
+    last_words_ = data_.data() + static_cast<std::size_t>(slot) * tile_words_;
+    return last_words_;
+  }
+} // namespace rescueops::planner
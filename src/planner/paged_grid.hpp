@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  // Tile file ("rescue_cli --compile-tiles in.json out.tiles"): an obstacle grid cut into square
+  // tiles of tile_size x tile_size cells, so a reader can load only the tiles it needs.
+  //
+  // Little-endian. A 64-byte header:
+  //   0  "RSOPTILE"            8  u32 version           12 u32 tile size
+  //   16 i32 width             20 i32 height            24 u64 tiles x     32 u64 tiles y
+  //   40 u64 blocked cells     48 u64 file bytes        56 u64 reserved
+  // then one u64 per tile in row-major tile order: 0 if every cell of the tile is free, 1 if
+  // every cell is blocked, otherwise the file offset of the tile's data. Tile data is tile_size
+  // rows of tile_size / 64 u64 words; bit x % 64 of word x / 64 is cell (x, y) of the tile.
+  // The tile size is a power of two in [64, 65536]. Cells of edge tiles that lie outside the grid
+  // are stored as free.
+  inline constexpr std::uint32_t kTileFileVersion = 1;
+  inline constexpr int kDefaultTileSize = 256;
+
+  // Fills `band` (rows [y0, y0 + rows) of the grid, width bytes per row, zeroed) with the
+  // blocked cells of those rows, nonzero = blocked.
+  using TileBandFill = std::function<void(int y0, int rows, std::span<std::uint8_t> band)>;
+
+  // Writes a tile file one band of tile_size rows at a time, so only tile_size * width bytes of
+  // the grid are held in memory at once.
+  bool write_tile_file(const std::string& path,
+                       int width,
+                       int height,
+                       int tile_size,
+                       const TileBandFill& fill_band,
+                       std::string* error = nullptr);
+
+  // Same, from a grid already in memory.
+  bool write_tile_file(const std::string& path, const Grid& grid, int tile_size, std::string* error = nullptr);
+
+  // Tile cache counters since open() or the last reset_stats(). Only tiles with data count;
+  // all-free and all-blocked tiles are answered from the tile table.
+  struct TileCacheStats
+  {
+    std::size_t hits = 0;      // cell queries served by a resident tile
+    std::size_t misses = 0;    // tile loads from the file
+    std::size_t evictions = 0; // resident tiles dropped to stay within the budget
+    std::size_t resident_tiles = 0;
+  };
+
+  // Obstacle grid backed by a tile file. Tiles are read on first use and kept in an LRU cache of
+  // at most memory_budget_bytes of tile data (at least one tile). The tile table (8 bytes per
+  // tile) and a slot index (4 bytes per tile) stay resident.
+  //
+  // is_blocked() has the same meaning as on Grid and BitGrid, so A* and obstacle queries run on
+  // it unchanged. Queries update the cache, so a PagedGrid must not be shared between threads;
+  // open one per thread instead. A tile that cannot be read back reads as blocked. Move-only.
+  class PagedGrid
+  {
+   public:
+    bool open(const std::string& path, std::size_t memory_budget_bytes, std::string* error = nullptr);
+    bool is_open() const { return file_.is_open(); }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+    int tile_size() const { return tile_size_; }
+    std::size_t blocked_count() const { return blocked_count_; }
+    std::size_t tile_capacity() const { return slot_owner_.size(); }
+
+    bool in_bounds(int x, int y) const { return x >= 0 && y >= 0 && x < w_ && y < h_; }
+
+    bool is_blocked(int x, int y) const
+    {
+      const std::size_t t = static_cast<std::size_t>(y >> tile_shift_) * tiles_x_ +
+                            static_cast<std::size_t>(x >> tile_shift_);
+      const std::uint64_t* words;
+      if (t == last_tile_)
+      {
+        ++stats_.hits;
+        words = last_words_;
+      }
+      else
+      {
+        const std::uint64_t offset = offsets_[t];
+        if (offset <= 1) return offset == 1;
+        words = tile_words(t);
+      }
+      const int tx = x & tile_mask_;
+      const int ty = y & tile_mask_;
+      return ((words[static_cast<std::size_t>(ty) * words_per_row_ + static_cast<std::size_t>(tx >> 6)] >> (tx & 63)) &
+              1u) != 0;
+    }
+
+    const TileCacheStats& stats() const { return stats_; }
+    void reset_stats()
+    {
+      stats_.hits = 0;
+      stats_.misses = 0;
+      stats_.evictions = 0;
+    }
+
+   private:
+    static constexpr std::uint32_t kNoSlot = 0xffffffffu;
+
+    // Words of data tile t, loading it (and evicting the least recently used tile) if needed.
+    const std::uint64_t* tile_words(std::size_t t) const;
+    void unlink(std::uint32_t slot) const;
+    void push_front(std::uint32_t slot) const;
+
+    int w_ = 0;
+    int h_ = 0;
+    int tile_size_ = 0;
+    int tile_shift_ = 0;
+    int tile_mask_ = 0;
+    std::size_t tiles_x_ = 0;
+    std::size_t words_per_row_ = 0; // per tile row
+    std::size_t tile_words_ = 0;    // per tile
+    std::size_t blocked_count_ = 0;
+    std::vector<std::uint64_t> offsets_;
+
+    // Cache state; mutated by const queries.
+    mutable std::ifstream file_;
+    mutable std::vector<std::uint32_t> slot_of_;    // per tile, kNoSlot if not resident
+    mutable std::vector<std::size_t> slot_owner_;   // per slot, the tile it holds
+    mutable std::vector<std::uint32_t> prev_, next_; // LRU list over slots, most recent first
+    mutable std::uint32_t head_ = kNoSlot;
+    mutable std::uint32_t tail_ = kNoSlot;
+    mutable std::vector<std::uint64_t> data_; // slot s holds words [s * tile_words_, (s + 1) * tile_words_)
+    mutable std::size_t last_tile_ = static_cast<std::size_t>(-1);
+    mutable const std::uint64_t* last_words_ = nullptr;
+    mutable TileCacheStats stats_;
+  };
+} // namespace rescueops::planner
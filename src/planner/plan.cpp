@@ -0,0 +1,89 @@
+#include "planner/plan.hpp"
+
+#include "planner/bitgrid.hpp"
+#include "planner/components.hpp"
+#include "planner/flow_field.hpp"
+#include "planner/hpa.hpp"
+#include "planner/jps.hpp"
+
+namespace rescueops::planner
+{
+  std::optional<Algorithm> parse_algorithm(std::string_view name)
+  {
+    if (name == "astar") return Algorithm::AStar;
+    if (name == "jps") return Algorithm::Jps;
+    if (name == "hpa") return Algorithm::Hpa;
+    if (name == "flow") return Algorithm::FlowField;
+    return std::nullopt;
+  }
+
+  const char* algorithm_name(Algorithm algo)
+  {
+    switch (algo)
+    {
+    case Algorithm::AStar:
+      return "astar";
+    case Algorithm::Jps:
+      return "jps";
+    case Algorithm::Hpa:
+      return "hpa";
+    case Algorithm::FlowField:
+      return "flow";
+    }
+    return "unknown";
+  }
+
+  std::optional<OpenList> parse_open_list(std::string_view name)
+  {
+    if (name == "heap") return OpenList::BinaryHeap;
+    if (name == "buckets") return OpenList::Buckets;
+    return std::nullopt;
+  }
+
+  const char* open_list_name(OpenList kind)
+  {
+    switch (kind)
+    {
+    case OpenList::BinaryHeap:
+      return "heap";
+    case OpenList::Buckets:
+      return "buckets";
+    }
+    return "unknown";
+  }
+
+  std::optional<PathResult> find_path(const PlanConfig& cfg,
+                                      const Grid& grid,
+                                      rescueops::sim::Vec2i start,
+                                      rescueops::sim::Vec2i goal,
+                                      SearchContext& ctx)
+  {
+    ctx.set_open_list(cfg.open_list);
+    if (cfg.components && !cfg.components->connected(start, goal))
+    {
+      ctx.stats() = SearchStats{};
+      return std::nullopt;
+    }
+
+    switch (cfg.algorithm)
+    {
+    case Algorithm::AStar:
+      if (cfg.bits) return astar(*cfg.bits, start, goal, ctx);
+      return astar(grid, start, goal, ctx);
+    case Algorithm::Jps:
+      if (cfg.bits) return jps(*cfg.bits, start, goal, ctx);
+      return jps(grid, start, goal, ctx);
+    case Algorithm::Hpa:
+      if (cfg.hierarchy) return cfg.hierarchy->find_path(grid, start, goal, ctx);
+      return astar(grid, start, goal, ctx);
+    case Algorithm::FlowField:
+      if (const FlowField* field = cfg.flow_fields ? cfg.flow_fields->find(goal) : nullptr)
+      {
+        ctx.stats() = SearchStats{}; // the BFS cost was paid once when the field was built
+        return field->path_from(start);
+      }
+      return astar(grid, start, goal, ctx);
+    }
+    return std::nullopt;
+  }
+} // namespace rescueops::planner
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "planner/astar.hpp"
+
+namespace rescueops::planner
+{
+  class BitGrid;
+  class ComponentLabels;
+  class FlowFieldCache;
+  class HierarchicalPlanner;
+
+  // Point-to-point search algorithms selectable at runtime (e.g. from rescue_cli --planner).
+  enum class Algorithm
+  {
+    AStar,
+    Jps,
+    Hpa,
+    FlowField,
+  };
+
+  std::optional<Algorithm> parse_algorithm(std::string_view name);
+  const char* algorithm_name(Algorithm algo);
+
+  std::optional<OpenList> parse_open_list(std::string_view name); // "heap" | "buckets"
+  const char* open_list_name(OpenList kind);
+
+  struct PlanConfig
+  {
+    Algorithm algorithm = Algorithm::AStar;
+    OpenList open_list = OpenList::BinaryHeap;
+    // Prebuilt abstraction for Algorithm::Hpa; without one, Hpa falls back to astar().
+    const HierarchicalPlanner* hierarchy = nullptr;
+    // Bit-packed copy of the grid; when set, AStar and Jps run on it (same results, fewer checks).
+    const BitGrid* bits = nullptr;
+    // Connected-component labels; when set, disconnected start/goal fail before any search.
+    const ComponentLabels* components = nullptr;
+    // Distance fields for Algorithm::FlowField; goals without a cached field fall back to astar().
+    // BatchPlanner fills this in itself, building one field per distinct goal in the batch.
+    const FlowFieldCache* flow_fields = nullptr;
+    // BatchPlanner builds fields only for goals at least this many queries of the batch share.
+    std::size_t flow_min_share = 2;
+  };
+
+  std::optional<PathResult> find_path(const PlanConfig& cfg,
+                                      const Grid& grid,
+                                      rescueops::sim::Vec2i start,
+                                      rescueops::sim::Vec2i goal,
+                                      SearchContext& ctx);
+} // namespace rescueops::planner
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rescueops::sim
+{
+  // Appends fixed-width little-endian values to a byte string, independent of host byte order.
+  class BinaryWriter
+  {
+   public:
+    void u8(std::uint8_t v) { buf_.push_back(static_cast<char>(v)); }
+    void u32(std::uint32_t v) { put(v, 4); }
+    void u64(std::uint64_t v) { put(v, 8); }
+    void i32(std::int32_t v) { put(static_cast<std::uint32_t>(v), 4); }
+    void bytes(std::string_view s) { buf_.append(s); }
+    // u32 length, then the bytes.
+    void str(std::string_view s)
+    {
+      u32(static_cast<std::uint32_t>(s.size()));
+      bytes(s);
+    }
+
+    std::size_t size() const { return buf_.size(); }
+    const std::string& data() const { return buf_; }
+    std::string take() { return std::move(buf_); }
+
+   private:
+    void put(std::uint64_t v, int n)
+    {
+      char b[8];
+      for (int i = 0; i < n; ++i) b[i] = static_cast<char>((v >> (8 * i)) & 0xffu);
+      buf_.append(b, static_cast<std::size_t>(n));
+    }
+
+    std::string buf_;
+  };
+
+  // Reads what BinaryWriter wrote. Reading past the end yields zeros and clears ok(), so a
+  // caller can decode a whole record and check once.
+  class BinaryReader
+  {
+   public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    std::uint8_t u8() { return static_cast<std::uint8_t>(get(1)); }
+    std::uint32_t u32() { return static_cast<std::uint32_t>(get(4)); }
+    std::uint64_t u64() { return get(8); }
+    std::int32_t i32() { return static_cast<std::int32_t>(static_cast<std::uint32_t>(get(4))); }
+    std::string_view bytes(std::size_t n)
+    {
+      if (!take(n)) return {};
+      return data_.substr(pos_ - n, n);
+    }
+    std::string_view str() { return bytes(u32()); }
+
+    bool ok() const { return ok_; }
+    std::size_t position() const { return pos_; }
+    std::size_t remaining() const { return data_.size() - pos_; }
+
+   private:
+    bool take(std::size_t n)
+    {
+      if (!ok_ || n > remaining())
+      {
+        ok_ = false;
+        return false;
+      }
+      pos_ += n;
+      return true;
+    }
+
+    std::uint64_t get(int n)
+    {
+      if (!take(static_cast<std::size_t>(n))) return 0;
+      std::uint64_t v = 0;
+      const char* p = data_.data() + (pos_ - static_cast<std::size_t>(n));
+      for (int i = 0; i < n; ++i) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+      return v;
+    }
+
+    std::string_view data_;
+    std::size_t pos_ = 0;
+    bool ok_ = true;
+  };
+
+  // 64-bit FNV-1a, for snapshot integrity checks.
+  inline std::uint64_t fnv1a64(std::string_view s)
+  {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (const char c : s)
+    {
+      h ^= static_cast<unsigned char>(c);
+      h *= 0x100000001b3ull;
+    }
+    return h;
+  }
+} // namespace rescueops::sim
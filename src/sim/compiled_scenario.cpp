@@ -0,0 +1,268 @@
+#include "sim/compiled_scenario.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "sim/binary_io.hpp"
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    constexpr std::string_view kMagic = "RSOPSCEN";
+    constexpr std::size_t kHeaderBytes = 256;
+    constexpr std::size_t kSectionAlign = 64;
+    constexpr std::size_t kSections = static_cast<std::size_t>(CompiledSection::Count);
+
+    bool fail(std::string* error, const std::string& what)
+    {
+      if (error) *error = what;
+      return false;
+    }
+
+    void pad_to(BinaryWriter& w, std::size_t base, std::size_t align)
+    {
+      while ((base + w.size()) % align != 0) w.u8(0);
+    }
+  } // namespace
+
+  bool write_compiled_scenario(const std::string& path,
+                               const Scenario& scenario,
+                               std::span<const std::uint8_t> blocked,
+                               std::string* error)
+  {
+    const World& world = scenario.world;
+    const auto w = static_cast<std::size_t>(std::max(0, world.width));
+    const auto h = static_cast<std::size_t>(std::max(0, world.height));
+    if (blocked.size() != w * h) return fail(error, "blocked grid does not match the world size");
+
+    // Unit names keep their table indices; names only targets use are appended.
+    StringTable names = world.units.names();
+    const std::size_t unit_names = names.size();
+    std::vector<std::uint32_t> target_names;
+    target_names.reserve(scenario.targets.size());
+    for (const auto& t : scenario.targets) target_names.push_back(names.intern(t.unit));
+
+    BinaryWriter body;
+    std::array<std::pair<std::uint64_t, std::uint64_t>, kSections> table{};
+    const auto begin = [&](CompiledSection s) {
+      pad_to(body, kHeaderBytes, kSectionAlign);
+      table[static_cast<std::size_t>(s)].first = kHeaderBytes + body.size();
+    };
+    const auto end = [&](CompiledSection s) {
+      auto& e = table[static_cast<std::size_t>(s)];
+      e.second = kHeaderBytes + body.size() - e.first;
+    };
+    const auto u32_column = [&](CompiledSection s, auto&& values) {
+      begin(s);
+      for (const auto v : values) body.u32(static_cast<std::uint32_t>(v));
+      end(s);
+    };
+
+    const auto& units = world.units;
+    u32_column(CompiledSection::UnitIds, units.ids());
+    u32_column(CompiledSection::UnitX, units.x());
+    u32_column(CompiledSection::UnitY, units.y());
+    u32_column(CompiledSection::UnitNames, units.name_indices());
+
+    begin(CompiledSection::NameOffsets);
+    std::uint32_t chars = 0;
+    body.u32(0);
+    for (std::uint32_t i = 0; i < names.size(); ++i)
+    {
+      chars += static_cast<std::uint32_t>(names.at(i).size());
+      body.u32(chars);
+    }
+    end(CompiledSection::NameOffsets);
+    begin(CompiledSection::NameChars);
+    for (std::uint32_t i = 0; i < names.size(); ++i) body.bytes(names.at(i));
+    end(CompiledSection::NameChars);
+
+    u32_column(CompiledSection::TargetNames, target_names);
+    begin(CompiledSection::TargetX);
+    for (const auto& t : scenario.targets) body.i32(t.tx);
+    end(CompiledSection::TargetX);
+    begin(CompiledSection::TargetY);
+    for (const auto& t : scenario.targets) body.i32(t.ty);
+    end(CompiledSection::TargetY);
+
+    begin(CompiledSection::Blocked);
+    std::uint64_t blocked_cells = 0;
+    const std::size_t words = (w + 63) / 64;
+    for (std::size_t y = 0; y < h; ++y)
+    {
+      const std::uint8_t* row = blocked.data() + y * w;
+      for (std::size_t i = 0; i < words; ++i)
+      {
+        std::uint64_t word = 0;
+        const std::size_t n = std::min<std::size_t>(64, w - i * 64);
+        for (std::size_t b = 0; b < n; ++b) word |= static_cast<std::uint64_t>(row[i * 64 + b] != 0) << b;
+        blocked_cells += static_cast<std::uint64_t>(std::popcount(word));
+        body.u64(word);
+      }
+    }
+    end(CompiledSection::Blocked);
+
+    BinaryWriter header;
+    header.bytes(kMagic);
+    header.u32(kCompiledScenarioVersion);
+    header.u32(static_cast<std::uint32_t>(kHeaderBytes));
+    header.u64(scenario.seed);
+    header.u64(scenario.ticks);
+    header.i32(world.width);
+    header.i32(world.height);
+    header.u64(units.size());
+    header.u64(scenario.targets.size());
+    header.u64(names.size());
+    header.u64(unit_names);
+    header.u64(blocked_cells);
+    header.u64(kHeaderBytes + body.size());
+    header.u64(0);
+    for (const auto& [offset, bytes] : table)
+    {
+      header.u64(offset);
+      header.u64(bytes);
+    }
+    pad_to(header, 0, kHeaderBytes);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return fail(error, "cannot write " + path);
+    out.write(header.data().data(), static_cast<std::streamsize>(header.size()));
+    out.write(body.data().data(), static_cast<std::streamsize>(body.size()));
+    if (!out) return fail(error, "cannot write " + path);
+    return true;
+  }
+
+  bool is_compiled_scenario(const std::string& path)
+  {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::string_view(magic, sizeof(magic)) == kMagic;
+  }
+
+  bool CompiledScenario::open(const std::string& path, std::string* error)
+  {
+    *this = CompiledScenario{};
+    if constexpr (std::endian::native != std::endian::little)
+      return fail(error, "compiled scenarios need a little-endian host");
+
+    MappedFile file;
+    if (!file.open(path)) return fail(error, "cannot map " + path);
+    if (file.size() < kHeaderBytes) return fail(error, "not a compiled scenario (too short)");
+
+    BinaryReader r(file.view().substr(0, kHeaderBytes));
+    if (r.bytes(kMagic.size()) != kMagic) return fail(error, "not a compiled scenario (bad magic)");
+    const auto version = r.u32();
+    if (version != kCompiledScenarioVersion)
+      return fail(error, "unsupported compiled scenario version " + std::to_string(version));
+    if (r.u32() != kHeaderBytes) return fail(error, "unexpected header size");
+
+    const auto seed = r.u64();
+    const auto ticks = r.u64();
+    const auto width = r.i32();
+    const auto height = r.i32();
+    const auto units = r.u64();
+    const auto targets = r.u64();
+    const auto names = r.u64();
+    const auto unit_names = r.u64();
+    const auto blocked_cells = r.u64();
+    const auto file_bytes = r.u64();
+    r.u64(); // reserved
+    Extent extents[kSections];
+    for (auto& e : extents)
+    {
+      e.offset = static_cast<std::size_t>(r.u64());
+      e.bytes = static_cast<std::size_t>(r.u64());
+    }
+    if (!r.ok()) return fail(error, "truncated header");
+    if (file_bytes != file.size()) return fail(error, "file size does not match the header");
+    if (width < 0 || height < 0 || unit_names > names || names >= 0xffffffffull || units > file.size() ||
+        targets > file.size())
+      return fail(error, "inconsistent header");
+
+    // Every section must be aligned, inside the file and exactly as large as its counts imply.
+    const auto wpr = (static_cast<std::uint64_t>(width) + 63) / 64;
+    const std::uint64_t expected[kSections] = {units * 4,       units * 4,   units * 4,   units * 4,
+                                               (names + 1) * 4, 0,           targets * 4, targets * 4,
+                                               targets * 4,     wpr * static_cast<std::uint64_t>(height) * 8};
+    for (std::size_t s = 0; s < kSections; ++s)
+    {
+      const Extent& e = extents[s];
+      if (e.offset % kSectionAlign != 0 || e.offset < kHeaderBytes || e.offset > file.size() ||
+          e.bytes > file.size() - e.offset)
+        return fail(error, "section " + std::to_string(s) + " out of bounds");
+      if (s != static_cast<std::size_t>(CompiledSection::NameChars) && e.bytes != expected[s])
+        return fail(error, "section " + std::to_string(s) + " has the wrong size");
+    }
+
+    file_ = std::move(file);
+    std::copy(std::begin(extents), std::end(extents), std::begin(sections_));
+    name_count_ = static_cast<std::size_t>(names);
+    unit_name_count_ = static_cast<std::size_t>(unit_names);
+
+    // Indices are checked once here so the accessors can trust them.
+    const auto offsets = section<std::uint32_t>(CompiledSection::NameOffsets);
+    const auto invalid = [&](const std::string& what) {
+      *this = CompiledScenario{};
+      return fail(error, what);
+    };
+    if (offsets[0] != 0 || offsets.back() != sections_[static_cast<std::size_t>(CompiledSection::NameChars)].bytes ||
+        !std::is_sorted(offsets.begin(), offsets.end()))
+      return invalid("corrupt string table");
+    for (const auto i : unit_name_indices())
+      if (i >= unit_name_count_) return invalid("unit name index out of range");
+    for (const auto i : section<std::uint32_t>(CompiledSection::TargetNames))
+      if (i >= name_count_) return invalid("target name index out of range");
+
+    seed_ = seed;
+    ticks_ = ticks;
+    width_ = width;
+    height_ = height;
+    blocked_count_ = static_cast<std::size_t>(blocked_cells);
+    return true;
+  }
+
+  std::string_view CompiledScenario::name(std::size_t i) const
+  {
+    const auto offsets = section<std::uint32_t>(CompiledSection::NameOffsets);
+    const auto chars = sections_[static_cast<std::size_t>(CompiledSection::NameChars)].offset;
+    return std::string_view(file_.data() + chars + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  ScenarioTarget CompiledScenario::target(std::size_t i) const
+  {
+    return ScenarioTarget{name(section<std::uint32_t>(CompiledSection::TargetNames)[i]),
+                          section<int>(CompiledSection::TargetX)[i], section<int>(CompiledSection::TargetY)[i]};
+  }
+
+  void CompiledScenario::unpack_blocked(std::span<std::uint8_t> out) const
+  {
+    // Eight cells at a time: byte i of kSpread[b] is bit i of b.
+    static const auto kSpread = [] {
+      std::array<std::uint64_t, 256> t{};
+      for (std::size_t b = 0; b < 256; ++b)
+        for (std::size_t i = 0; i < 8; ++i) t[b] |= static_cast<std::uint64_t>((b >> i) & 1u) << (8 * i);
+      return t;
+    }();
+
+    const auto w = static_cast<std::size_t>(width_);
+    const auto words = blocked_words();
+    const std::size_t wpr = words_per_row();
+    for (std::size_t y = 0; y < static_cast<std::size_t>(height_); ++y)
+    {
+      std::uint8_t* row = out.data() + y * w;
+      for (std::size_t x = 0; x < w; x += 8)
+      {
+        const std::uint64_t word = words[y * wpr + x / 64];
+        const std::uint64_t cells = kSpread[(word >> (x & 63)) & 0xffu];
+        std::memcpy(row + x, &cells, std::min<std::size_t>(8, w - x)); // little-endian: byte i = cell x + i
+      }
+    }
+  }
+} // namespace rescueops::sim
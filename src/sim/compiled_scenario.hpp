@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "sim/mapped_file.hpp"
+#include "sim/scenario.hpp"
+
+namespace rescueops::sim
+{
+  // Binary scenario image ("rescue_cli --compile in.json out.rsc"): a scenario with its obstacles
+  // already rasterized, laid out so it can be used straight from a memory mapping.
+  //
+  // Little-endian. A 256-byte header, then sections that each start on a 64-byte boundary:
+  //   0  "RSOPSCEN"            8  u32 version           12 u32 header bytes (256)
+  //   16 u64 seed              24 u64 ticks             32 i32 width      36 i32 height
+  //   40 u64 units             48 u64 targets           56 u64 names      64 u64 unit names
+  //   72 u64 blocked cells     80 u64 file bytes        88 u64 reserved
+  //   96 section table: CompiledSection::Count entries of {u64 offset, u64 bytes}
+  // Unit columns are ids u32, x i32, y i32 and name index u32. The string table holds the
+  // `unit names` names of the unit table first, then any other names used by targets, as
+  // u32 offsets (names + 1 of them) into a block of characters. Targets are columns of name
+  // index u32, tx i32 and ty i32. The blocked grid has `height` rows of (width + 63) / 64 u64
+  // words; bit x % 64 of word x / 64 is cell (x, y).
+  enum class CompiledSection : std::uint32_t
+  {
+    UnitIds,
+    UnitX,
+    UnitY,
+    UnitNames,
+    NameOffsets,
+    NameChars,
+    TargetNames,
+    TargetX,
+    TargetY,
+    Blocked,
+    Count,
+  };
+
+  inline constexpr std::uint32_t kCompiledScenarioVersion = 1;
+
+  // Writes the image for `scenario`. `blocked` is the rasterized obstacle grid, one byte per
+  // cell in row-major order (world.width * world.height, nonzero = blocked).
+  bool write_compiled_scenario(const std::string& path,
+                               const Scenario& scenario,
+                               std::span<const std::uint8_t> blocked,
+                               std::string* error = nullptr);
+
+  // True if the file starts with the image magic (cheap check to pick the loader).
+  bool is_compiled_scenario(const std::string& path);
+
+  // A mapped scenario image. open() checks the header and the bounds of every section and
+  // index once; the accessors then read the mapping in place, without copying.
+  class CompiledScenario
+  {
+   public:
+    bool open(const std::string& path, std::string* error = nullptr);
+    bool is_open() const { return file_.is_open(); }
+
+    std::uint64_t seed() const { return seed_; }
+    std::uint64_t ticks() const { return ticks_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    std::span<const std::uint32_t> unit_ids() const { return section<std::uint32_t>(CompiledSection::UnitIds); }
+    std::span<const int> unit_x() const { return section<int>(CompiledSection::UnitX); }
+    std::span<const int> unit_y() const { return section<int>(CompiledSection::UnitY); }
+    std::span<const std::uint32_t> unit_name_indices() const
+    {
+      return section<std::uint32_t>(CompiledSection::UnitNames);
+    }
+
+    std::size_t name_count() const { return name_count_; }
+    std::size_t unit_name_count() const { return unit_name_count_; } // names [0, n) belong to units
+    std::string_view name(std::size_t i) const;
+
+    std::size_t target_count() const { return section<std::uint32_t>(CompiledSection::TargetNames).size(); }
+    ScenarioTarget target(std::size_t i) const; // unit is a view into the mapping
+
+    // Rasterized obstacles, `height` rows of words_per_row() words.
+    std::span<const std::uint64_t> blocked_words() const { return section<std::uint64_t>(CompiledSection::Blocked); }
+    std::size_t words_per_row() const { return (static_cast<std::size_t>(width_) + 63) / 64; }
+    std::size_t blocked_count() const { return blocked_count_; }
+    bool is_blocked(int x, int y) const
+    {
+      return ((blocked_words()[static_cast<std::size_t>(y) * words_per_row() + static_cast<std::size_t>(x >> 6)] >>
+               (x & 63)) & 1u) != 0;
+    }
+    // Expands the grid to one byte per cell (0 free, 1 blocked); `out` holds width * height.
+    void unpack_blocked(std::span<std::uint8_t> out) const;
+
+   private:
+    struct Extent
+    {
+      std::size_t offset = 0;
+      std::size_t bytes = 0;
+    };
+
+    template <class T>
+    std::span<const T> section(CompiledSection s) const
+    {
+      const Extent& e = sections_[static_cast<std::size_t>(s)];
+      return std::span<const T>(reinterpret_cast<const T*>(file_.data() + e.offset), e.bytes / sizeof(T));
+    }
+
+    MappedFile file_;
+    std::uint64_t seed_ = 0;
+    std::uint64_t ticks_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    std::size_t name_count_ = 0;
+    std::size_t unit_name_count_ = 0;
+    std::size_t blocked_count_ = 0;
+    Extent sections_[static_cast<std::size_t>(CompiledSection::Count)]{};
+  };
+} // namespace rescueops::sim
@@ -1,10 +1,34 @@
 #include "sim/engine.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
+#include "models/motion.hpp"
+#include "sim/binary_io.hpp"
+#include "sim/thread_pool.hpp"
+#include "sim/trajectory.hpp"
+
 namespace rescueops::sim
 {
+  namespace
+  {
+    // Units per work item of the parallel Philox walk (a multiple of the kernel's 8 lanes).
+    constexpr std::size_t kWalkChunkRows = 8192;
+  } // namespace
+
+  std::optional<MotionRng> parse_motion_rng(std::string_view name)
+  {
+    if (name == "mt19937") return MotionRng::Mt19937;
+    if (name == "philox") return MotionRng::Philox;
+    return std::nullopt;
+  }
+
+  const char* motion_rng_name(MotionRng rng)
+  {
+    return rng == MotionRng::Philox ? "philox" : "mt19937";
+  }
+
   Engine::Engine()
   {
     set_seed(42);
@@ -16,137 +40,74 @@ namespace rescueops::sim
     rng_.seed(seed_);
   }
 
-  int Engine::extract_int_field(const std::string& text, const std::string& key, int fallback)
+  void Engine::set_thread_pool(ThreadPool* pool)
   {
-    // naive key finder: looks for "key" : <number>
-    const std::string needle = "\"" + key + "\"";
-    auto pos = text.find(needle);
-    if (pos == std::string::npos) return fallback;
-
-    pos = text.find(':', pos);
-    if (pos == std::string::npos) return fallback;
-    ++pos;
-
-    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) ++pos;
-
-    bool neg = false;
-    if (pos < text.size() && text[pos] == '-')
-    {
-      neg = true;
-      ++pos;
-    }
-
-    long long value = 0;
-    bool any = false;
-    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
-    {
-      any = true;
-      value = value * 10 + (text[pos] - '0');
-      ++pos;
-    }
-    if (!any) return fallback;
-    if (neg) value = -value;
-    return static_cast<int>(value);
+    pool_ = pool;
+    scheduler_.set_thread_pool(pool);
   }
 
-  std::uint64_t Engine::extract_u64_field(const std::string& text, const std::string& key, std::uint64_t fallback)
+  void Engine::enable_spatial_index(int cell_size)
   {
-    const std::string needle = "\"" + key + "\"";
-    auto pos = text.find(needle);
-    if (pos == std::string::npos) return fallback;
-
-    pos = text.find(':', pos);
-    if (pos == std::string::npos) return fallback;
-    ++pos;
-
-    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) ++pos;
-
-    std::uint64_t value = 0;
-    bool any = false;
-    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
-    {
-      any = true;
-      value = value * 10 + static_cast<std::uint64_t>(text[pos] - '0');
-      ++pos;
-    }
-    return any ? value : fallback;
+    index_enabled_ = cell_size > 0;
+    if (!index_enabled_) return;
+    index_ = SpatialIndex(cell_size);
+    index_.build(world_.units, world_.width, world_.height);
   }
 
-  void Engine::extract_units_minimal(const std::string& text)
+  bool Engine::load_scenario(const std::string& path)
   {
-    // Very minimal: scans for objects like {"name":"U1","x":1,"y":2}
-    // Not a full JSON parser; good enough for starter scenarios.
-    world_.units.clear();
-
-    std::size_t pos = 0;
-    std::uint32_t next_id = 1;
-    while (true)
-    {
-      auto obj = text.find("{", pos);
-      if (obj == std::string::npos) break;
-      auto end = text.find("}", obj);
-      if (end == std::string::npos) break;
-
-      auto chunk = text.substr(obj, end - obj + 1);
-
-      // Only accept objects that contain "name" and "x" and "y"
-      if (chunk.find("\"name\"") != std::string::npos && chunk.find("\"x\"") != std::string::npos &&
-          chunk.find("\"y\"") != std::string::npos)
-      {
-        Unit u;
-        u.id = next_id++;
+    Scenario scenario;
+    if (!load_scenario_file(path, scenario)) return false;
+    load(scenario);
+    return true;
+  }
 
-        // name
-        auto npos = chunk.find("\"name\"");
-        if (npos != std::string::npos)
-        {
-          auto colon = chunk.find(':', npos);
-          if (colon != std::string::npos)
-          {
-            auto q1 = chunk.find('"', colon + 1);
-            auto q2 = (q1 != std::string::npos) ? chunk.find('"', q1 + 1) : std::string::npos;
-            if (q1 != std::string::npos && q2 != std::string::npos)
-            {
-              u.name = chunk.substr(q1 + 1, q2 - q1 - 1);
-            }
-          }
-        }
-        if (u.name.empty()) u.name = "unit_" + std::to_string(u.id);
+  void Engine::load(const Scenario& scenario)
+  {
+    set_seed(scenario.seed);
+    world_ = scenario.world;
 
-        u.pos.x = extract_int_field(chunk, "x", 0);
-        u.pos.y = extract_int_field(chunk, "y", 0);
+    // A new scenario starts a new timeline.
+    disarm();
+    tick_ = 0;
+    if (index_enabled_) index_.build(world_.units, world_.width, world_.height);
+  }
 
-        world_.units.push_back(u);
-      }
+  void Engine::load(const CompiledScenario& scenario)
+  {
+    set_seed(scenario.seed());
+    world_.width = scenario.width();
+    world_.height = scenario.height();
+    std::vector<std::string_view> names(scenario.unit_name_count());
+    for (std::size_t i = 0; i < names.size(); ++i) names[i] = scenario.name(i);
+    world_.units.assign(scenario.unit_ids(), scenario.unit_x(), scenario.unit_y(), scenario.unit_name_indices(),
+                        names);
 
-      pos = end + 1;
-    }
+    disarm();
+    tick_ = 0;
+    if (index_enabled_) index_.build(world_.units, world_.width, world_.height);
+  }
 
-    if (world_.units.empty())
+  void Engine::arm(BuiltinEvent kind, Tick period, Tick phase)
+  {
+    // First occurrence not before the current tick, keeping the phase.
+    const Tick first = phase >= tick_ ? phase : phase + (tick_ - phase + period - 1) / period * period;
+    EventHandle handle;
+    switch (kind)
     {
-      // default unit if none provided
-      world_.units.push_back(Unit{1, "alpha", Vec2i{1, 1}});
+    case BuiltinEvent::Heartbeat:
+      handle = scheduler_.schedule_every(period, first, [] {
+        // deterministic no-op for now; later: metrics snapshots, comms updates, etc.
+      });
+      break;
     }
+    recurring_.push_back(Recurring{kind, period, phase, handle});
   }
 
-  bool Engine::load_scenario(const std::string& path)
+  void Engine::disarm()
   {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) return false;
-
-    std::ostringstream ss;
-    ss << in.rdbuf();
-    const auto text = ss.str();
-
-    // Scenario fields
-    const auto seed = extract_u64_field(text, "seed", 42);
-    set_seed(seed);
-
-    world_.width = extract_int_field(text, "width", 32);
-    world_.height = extract_int_field(text, "height", 18);
-
-    extract_units_minimal(text);
-    return true;
+    for (const auto& r : recurring_) scheduler_.cancel(r.handle);
+    recurring_.clear();
   }
 
   RunResult Engine::run(Tick ticks)
@@ -155,32 +116,195 @@ namespace rescueops::sim
     rr.seed = seed_;
 
     // Example of scheduled recurring event: a heartbeat that runs each 50 ticks.
-    for (Tick t = 0; t <= ticks; t += 50)
-    {
-      scheduler_.schedule(t, [this, t] {
-        // deterministic no-op for now; later: metrics snapshots, comms updates, etc.
-        (void)t;
-      });
-    }
+    // One re-armed event instead of one closure per occurrence; same firing order.
+    if (recurring_.empty()) arm(BuiltinEvent::Heartbeat, 50, 0);
+
+    const bool parallel_walk =
+      motion_rng_ == MotionRng::Philox && pool_ && pool_->size() > 1 && world_.units.size() > kWalkChunkRows;
+    // Units or the world may have been edited since the last run.
+    if (index_enabled_) index_.build(world_.units, world_.width, world_.height);
+    if (recorder_) recorder_->record(tick_, world_.units);
 
-    for (Tick t = 0; t < ticks; ++t)
+    for (; tick_ < ticks; ++tick_)
     {
+      const Tick t = tick_;
       scheduler_.run_due(t);
 
       // Trivial motion model: random walk (deterministic due to seed).
       // (Later replace with motion + planner outputs)
-      if (!world_.units.empty())
+      if (parallel_walk)
+      {
+        // Each unit's step depends only on its own id: row chunks update independently.
+        const auto xs = world_.units.x();
+        const auto ys = world_.units.y();
+        const auto ids = world_.units.ids();
+        const std::size_t n = ids.size();
+        pool_->parallel_for((n + kWalkChunkRows - 1) / kWalkChunkRows, [&](std::size_t c, unsigned) {
+          const std::size_t begin = c * kWalkChunkRows;
+          const std::size_t len = std::min(kWalkChunkRows, n - begin);
+          models::random_walk_tick(xs.subspan(begin, len), ys.subspan(begin, len), ids.subspan(begin, len), seed_, t,
+                                   world_.width, world_.height);
+        });
+      }
+      else if (motion_rng_ == MotionRng::Philox)
+      {
+        models::random_walk_tick(world_.units.x(), world_.units.y(), world_.units.ids(), seed_, t, world_.width,
+                                 world_.height);
+      }
+      else if (!world_.units.empty())
       {
         std::uniform_int_distribution<int> step(-1, 1);
-        for (auto& u : world_.units)
+        const auto xs = world_.units.x();
+        const auto ys = world_.units.y();
+        for (std::size_t i = 0; i < xs.size(); ++i)
         {
-          u.pos.x = std::max(0, std::min(world_.width - 1, u.pos.x + step(rng_)));
-          u.pos.y = std::max(0, std::min(world_.height - 1, u.pos.y + step(rng_)));
+          xs[i] = std::max(0, std::min(world_.width - 1, xs[i] + step(rng_)));
+          ys[i] = std::max(0, std::min(world_.height - 1, ys[i] + step(rng_)));
         }
       }
-      rr.ticks_executed = t + 1;
+      if (index_enabled_) index_.update();
+      if (recorder_) recorder_->record(t + 1, world_.units);
     }
+    rr.ticks_executed = tick_;
     return rr;
   }
 
+  // Snapshot layout (all integers little-endian):
+  //   "RSOPSNAP" u32 version
+  //   u64 seed, u64 tick, u8 motion_rng, i32 width, i32 height
+  //   str mt19937_64 state (the standard's textual form, portable across implementations)
+  //   u32 n, n x {u32 kind, u64 period, u64 phase}    recurring engine events
+  //   u32 n, n x str                                   unit name table
+  //   u64 n, u32 ids[n], u32 name_index[n], i32 x[n], i32 y[n]
+  //   u64 FNV-1a of everything above
+  namespace
+  {
+    constexpr std::string_view kSnapshotMagic = "RSOPSNAP";
+    constexpr std::uint32_t kSnapshotVersion = 1;
+  } // namespace
+
+  std::string Engine::checkpoint() const
+  {
+    if (!only_builtins_pending()) return {};
+
+    BinaryWriter w;
+    w.bytes(kSnapshotMagic);
+    w.u32(kSnapshotVersion);
+    w.u64(seed_);
+    w.u64(tick_);
+    w.u8(static_cast<std::uint8_t>(motion_rng_));
+    w.i32(world_.width);
+    w.i32(world_.height);
+
+    std::ostringstream rng_state;
+    rng_state << rng_;
+    w.str(rng_state.str());
+
+    w.u32(static_cast<std::uint32_t>(recurring_.size()));
+    for (const auto& r : recurring_)
+    {
+      w.u32(static_cast<std::uint32_t>(r.kind));
+      w.u64(r.period);
+      w.u64(r.phase);
+    }
+
+    const auto& units = world_.units;
+    w.u32(static_cast<std::uint32_t>(units.names().size()));
+    for (std::uint32_t i = 0; i < units.names().size(); ++i) w.str(units.names().at(i));
+    w.u64(units.size());
+    for (const auto v : units.ids()) w.u32(v);
+    for (const auto v : units.name_indices()) w.u32(v);
+    for (const auto v : units.x()) w.i32(v);
+    for (const auto v : units.y()) w.i32(v);
+
+    w.u64(fnv1a64(w.data()));
+    return w.take();
+  }
+
+  bool Engine::save_checkpoint(const std::string& path) const
+  {
+    const std::string data = checkpoint();
+    if (data.empty()) return false;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+  }
+
+  bool Engine::restore(std::string_view snapshot)
+  {
+    if (!only_builtins_pending() || snapshot.size() < kSnapshotMagic.size() + 8) return false;
+    const std::string_view body = snapshot.substr(0, snapshot.size() - 8);
+    BinaryReader tail(snapshot.substr(body.size()));
+    if (tail.u64() != fnv1a64(body)) return false;
+
+    BinaryReader r(body);
+    if (r.bytes(kSnapshotMagic.size()) != kSnapshotMagic || r.u32() != kSnapshotVersion) return false;
+    const std::uint64_t seed = r.u64();
+    const Tick tick = r.u64();
+    const std::uint8_t motion = r.u8();
+    World world;
+    world.width = r.i32();
+    world.height = r.i32();
+    if (motion > static_cast<std::uint8_t>(MotionRng::Philox)) return false;
+
+    std::mt19937_64 rng;
+    std::istringstream rng_state{std::string(r.str())};
+    rng_state >> rng;
+    if (!rng_state) return false;
+
+    // Counts are checked against the bytes left before allocating, so a corrupt count cannot
+    // blow up memory: a recurring event takes 20 bytes, a name at least its 4-byte length.
+    const std::uint32_t recurring_count = r.u32();
+    if (!r.ok() || recurring_count > r.remaining() / 20) return false;
+    std::vector<Recurring> recurring(recurring_count);
+    for (auto& e : recurring)
+    {
+      e.kind = static_cast<BuiltinEvent>(r.u32());
+      e.period = r.u64();
+      e.phase = r.u64();
+      if (e.kind != BuiltinEvent::Heartbeat || e.period == 0) return false;
+    }
+
+    const std::uint32_t name_count = r.u32();
+    if (!r.ok() || name_count > r.remaining() / 4) return false;
+    std::vector<std::string_view> names(name_count);
+    for (auto& n : names) n = r.str();
+    const std::uint64_t count = r.u64();
+    // Four 4-byte columns.
+    if (!r.ok() || count > r.remaining() / 16) return false;
+    const auto n = static_cast<std::size_t>(count);
+    std::vector<std::uint32_t> ids(n), name_index(n);
+    std::vector<int> xs(n), ys(n);
+    for (auto& v : ids) v = r.u32();
+    for (auto& v : name_index) v = r.u32();
+    for (auto& v : xs) v = r.i32();
+    for (auto& v : ys) v = r.i32();
+    if (!r.ok() || r.remaining() != 0) return false;
+
+    for (const auto k : name_index)
+      if (k >= names.size()) return false;
+    world.units.assign(ids, xs, ys, name_index, names);
+
+    // Everything decoded: commit.
+    disarm();
+    seed_ = seed;
+    tick_ = tick;
+    motion_rng_ = static_cast<MotionRng>(motion);
+    rng_ = rng;
+    world_ = std::move(world);
+    for (const auto& e : recurring) arm(e.kind, e.period, e.phase);
+    if (index_enabled_) index_.build(world_.units, world_.width, world_.height);
+    return true;
+  }
+
+  bool Engine::load_checkpoint(const std::string& path)
+  {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return restore(ss.str());
+  }
+
 } // namespace rescueops::sim
@@ -1,13 +1,33 @@
 #pragma once
 #include <cstdint>
+#include <optional>
 #include <random>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "sim/compiled_scenario.hpp"
+#include "sim/scenario.hpp"
 #include "sim/scheduler.hpp"
+#include "sim/spatial_index.hpp"
 #include "sim/world.hpp"
 
 namespace rescueops::sim
 {
+  // Source of the random walk's steps.
+  //  - Mt19937: one mt19937_64 stream consumed in unit order (compatibility with older runs).
+  //  - Philox: counter-based, keyed by (seed, unit id, tick); independent of update order.
+  enum class MotionRng
+  {
+    Mt19937,
+    Philox,
+  };
+
+  std::optional<MotionRng> parse_motion_rng(std::string_view name);
+  const char* motion_rng_name(MotionRng rng);
+
+  class TrajectoryRecorder;
+
   struct RunResult
   {
     Tick ticks_executed = 0;
@@ -19,10 +39,30 @@ namespace rescueops::sim
    public:
     Engine();
 
-    // Load a scenario file (very lightweight parser: extracts a few integer fields + unit positions).
+    // Load a scenario file (see parse_scenario); false if it cannot be read or is malformed.
     bool load_scenario(const std::string& path);
+    // Takes the seed and world of an already parsed scenario and starts a new timeline.
+    void load(const Scenario& scenario);
+    // Same from a mapped image: the unit columns are bulk-copied (they change every tick), the
+    // names are interned once each.
+    void load(const CompiledScenario& scenario);
 
+    // Runs ticks [tick(), ticks) and returns the totals so far. Successive calls continue the
+    // same timeline: run(100) then run(200) equals run(200).
     RunResult run(Tick ticks);
+    // Next tick to execute (0 after construction or load_scenario).
+    Tick tick() const { return tick_; }
+
+    // Versioned binary snapshot of the full simulation state: seed, tick, motion mode, mt19937_64
+    // state, world and units, and the engine's recurring events. Resuming from it continues
+    // exactly like the uninterrupted run. Closures scheduled through scheduler() cannot be
+    // serialized: checkpoint() fails (returns an empty string) while any are pending.
+    std::string checkpoint() const;
+    bool save_checkpoint(const std::string& path) const;
+    // Replaces the current state with a snapshot's; false (state unchanged) if the data is
+    // malformed, from another version, or foreign events are pending.
+    bool restore(std::string_view snapshot);
+    bool load_checkpoint(const std::string& path);
 
     World& world() { return world_; }
     const World& world() const { return world_; }
@@ -31,15 +71,62 @@ namespace rescueops::sim
     std::mt19937_64& rng() { return rng_; }
 
     void set_seed(std::uint64_t seed);
+    std::uint64_t seed() const { return seed_; }
+
+    void set_motion_rng(MotionRng rng) { motion_rng_ = rng; }
+    MotionRng motion_rng() const { return motion_rng_; }
+
+    // Worker pool for the tick update (nullptr, the default, runs it on the calling thread).
+    // With MotionRng::Philox and more than one worker, each tick's walk is split into chunks of
+    // rows updated in parallel; results are identical for any pool size. The mt19937 walk is
+    // one sequential stream and always runs serially.
+    // The pool is also handed to the scheduler (Scheduler::set_thread_pool).
+    void set_thread_pool(ThreadPool* pool);
+
+    // Proximity queries over the units (off by default; cell_size 0 turns it off again).
+    // run() rebuilds the index when it starts and updates it after every tick's motion, so
+    // scheduled events and callers between runs see current positions. load_scenario() and
+    // restore() rebuild it too; after editing world().units directly, call this again (or run).
+    void enable_spatial_index(int cell_size);
+    // nullptr while disabled.
+    const SpatialIndex* spatial_index() const { return index_enabled_ ? &index_ : nullptr; }
+
+    // Records unit positions into `recorder` (nullptr, the default, records nothing). run()
+    // records frame tick() when it starts, then frame t + 1 after each tick t's motion, so the
+    // recording covers every state the run passes through. The recorder must outlive its use
+    // and is not part of snapshots.
+    void set_trajectory_recorder(TrajectoryRecorder* recorder) { recorder_ = recorder; }
 
    private:
+    // Recurring events the engine schedules itself. Snapshots store these descriptors and
+    // restore() re-arms them, since the callables cannot be serialized.
+    enum class BuiltinEvent : std::uint32_t
+    {
+      Heartbeat = 0,
+    };
+
+    struct Recurring
+    {
+      BuiltinEvent kind = BuiltinEvent::Heartbeat;
+      Tick period = 0;
+      Tick phase = 0;
+      EventHandle handle;
+    };
+
+    void arm(BuiltinEvent kind, Tick period, Tick phase);
+    void disarm();
+    bool only_builtins_pending() const { return scheduler_.pending() == recurring_.size(); }
+
     Scheduler scheduler_;
     World world_;
     std::mt19937_64 rng_;
     std::uint64_t seed_ = 0;
-
-    static int extract_int_field(const std::string& text, const std::string& key, int fallback);
-    static std::uint64_t extract_u64_field(const std::string& text, const std::string& key, std::uint64_t fallback);
-    void extract_units_minimal(const std::string& text);
+    MotionRng motion_rng_ = MotionRng::Mt19937;
+    ThreadPool* pool_ = nullptr;
+    Tick tick_ = 0;
+    std::vector<Recurring> recurring_;
+    bool index_enabled_ = false;
+    SpatialIndex index_;
+    TrajectoryRecorder* recorder_ = nullptr;
   };
 } // namespace rescueops::sim
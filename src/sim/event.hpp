@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+namespace rescueops::sim
+{
+  using Tick = std::uint64_t;
+
+  // Queue entry: ordering key plus the id of the callable in the Scheduler's EventArena.
+  // Kept small and trivially copyable so heap sifts and wheel cascades move 24 bytes.
+  struct ScheduledEvent
+  {
+    Tick tick{};
+    std::uint64_t seq{}; // tie-breaker for stable ordering
+    std::uint32_t task{};
+
+    // priority_queue puts "largest" first; we invert for min-heap behavior.
+    bool operator<(const ScheduledEvent& other) const
+    {
+      if (tick != other.tick) return tick > other.tick;
+      return seq > other.seq;
+    }
+  };
+
+  // Refers to one scheduled event (all occurrences, for a periodic one) until it is released.
+  // A default-constructed handle refers to nothing.
+  struct EventHandle
+  {
+    std::uint32_t id = 0xffffffffu;
+    std::uint32_t generation = 0;
+  };
+} // namespace rescueops::sim
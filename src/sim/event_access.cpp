@@ -0,0 +1,78 @@
+#include "sim/event_access.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace rescueops::sim
+{
+  void ConflictSet::clear()
+  {
+    count_ = 0;
+    if (++gen_ == 0)
+    {
+      std::fill(stamps_.begin(), stamps_.end(), 0u);
+      gen_ = 1;
+    }
+  }
+
+  std::size_t ConflictSet::probe(std::uint64_t key) const
+  {
+    const std::size_t mask = keys_.size() - 1;
+    std::size_t i = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (stamps_[i] == gen_ && keys_[i] != key) i = (i + 1) & mask;
+    return i;
+  }
+
+  std::uint8_t ConflictSet::flags(std::uint64_t key) const
+  {
+    if (keys_.empty()) return 0;
+    const std::size_t i = probe(key);
+    return stamps_[i] == gen_ ? flags_[i] : 0;
+  }
+
+  void ConflictSet::claim(std::uint64_t key, std::uint8_t flag)
+  {
+    if ((count_ + 1) * 2 > keys_.size()) grow();
+    const std::size_t i = probe(key);
+    if (stamps_[i] != gen_)
+    {
+      stamps_[i] = gen_;
+      keys_[i] = key;
+      flags_[i] = 0;
+      ++count_;
+    }
+    flags_[i] |= flag;
+  }
+
+  void ConflictSet::grow()
+  {
+    std::vector<std::uint64_t> keys = std::move(keys_);
+    std::vector<std::uint32_t> stamps = std::move(stamps_);
+    std::vector<std::uint8_t> flags = std::move(flags_);
+
+    const std::size_t size = std::max<std::size_t>(64, keys.size() * 2);
+    keys_.assign(size, 0);
+    stamps_.assign(size, 0);
+    flags_.assign(size, 0);
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      if (stamps[i] != gen_) continue;
+      const std::size_t j = probe(keys[i]);
+      stamps_[j] = gen_;
+      keys_[j] = keys[i];
+      flags_[j] = flags[i];
+    }
+  }
+
+  bool ConflictSet::try_claim(const EventAccess& access)
+  {
+    for (std::size_t i = 0; i < access.write_count; ++i)
+      if (flags(access.writes[i]) != 0) return false;
+    for (std::size_t i = 0; i < access.read_count; ++i)
+      if (flags(access.reads[i]) & kWrite) return false;
+
+    for (std::size_t i = 0; i < access.write_count; ++i) claim(access.writes[i], kWrite);
+    for (std::size_t i = 0; i < access.read_count; ++i) claim(access.reads[i], kRead);
+    return true;
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace rescueops::sim
+{
+  // Opaque key for EventAccess: a domain (units, regions, comms channels, ...) plus an id in it.
+  constexpr std::uint64_t access_key(std::uint32_t domain, std::uint32_t id)
+  {
+    return (static_cast<std::uint64_t>(domain) << 32) | id;
+  }
+
+  // State an event reads and writes, declared when it is scheduled. Two same-tick events whose
+  // sets do not conflict (no write/write or read/write overlap) may run concurrently; see
+  // Scheduler::set_thread_pool. Fixed capacity, no allocation: declaring more keys than fit
+  // marks the event exclusive, and it then runs on its own like an undeclared event.
+  struct EventAccess
+  {
+    static constexpr std::size_t kMaxKeys = 4;
+
+    std::array<std::uint64_t, kMaxKeys> reads{};
+    std::array<std::uint64_t, kMaxKeys> writes{};
+    std::uint8_t read_count = 0;
+    std::uint8_t write_count = 0;
+    bool exclusive = false;
+
+    EventAccess& read(std::uint64_t key)
+    {
+      if (read_count == kMaxKeys)
+        exclusive = true;
+      else
+        reads[read_count++] = key;
+      return *this;
+    }
+
+    EventAccess& write(std::uint64_t key)
+    {
+      if (write_count == kMaxKeys)
+        exclusive = true;
+      else
+        writes[write_count++] = key;
+      return *this;
+    }
+  };
+
+  // Keys claimed by the events of one parallel batch. Open addressing with generation stamps:
+  // clear() is O(1) and the table is reused, so it only allocates when a batch outgrows it.
+  class ConflictSet
+  {
+   public:
+    void clear();
+
+    // Claims the keys of `access`, unless one conflicts with a key already claimed.
+    bool try_claim(const EventAccess& access);
+
+   private:
+    static constexpr std::uint8_t kRead = 1;
+    static constexpr std::uint8_t kWrite = 2;
+
+    std::uint8_t flags(std::uint64_t key) const;
+    void claim(std::uint64_t key, std::uint8_t flag);
+    std::size_t probe(std::uint64_t key) const;
+    void grow();
+
+    std::vector<std::uint64_t> keys_;
+    std::vector<std::uint32_t> stamps_; // slot is in use iff stamps_[i] == gen_
+    std::vector<std::uint8_t> flags_;
+    std::uint32_t gen_ = 1;
+    std::size_t count_ = 0;
+  };
+} // namespace rescueops::sim
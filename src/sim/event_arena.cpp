@@ -0,0 +1,25 @@
+#include "sim/event_arena.hpp"
+
+namespace rescueops::sim
+{
+  void EventArena::grow()
+  {
+    const auto base = static_cast<std::uint32_t>(capacity());
+    chunks_.push_back(std::make_unique<Node[]>(kChunkSize));
+    // Reserve for every slot so releasing never reallocates the free list.
+    free_.reserve(capacity());
+    for (std::size_t i = kChunkSize; i > 0; --i) free_.push_back(base + static_cast<std::uint32_t>(i - 1));
+  }
+
+  void EventArena::release(std::uint32_t id)
+  {
+    Node& n = node(id);
+    n.task.reset();
+    n.state = State::Free;
+    n.cancelled = false;
+    n.period = 0;
+    n.has_access = false;
+    ++n.generation;
+    free_.push_back(id);
+  }
+} // namespace rescueops::sim
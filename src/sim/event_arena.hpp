@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "sim/event.hpp"
+#include "sim/event_access.hpp"
+#include "sim/inline_task.hpp"
+
+namespace rescueops::sim
+{
+  // Event callables are stored inline in 64 bytes (eight pointers' worth of captures).
+  using EventTask = InlineTask<64>;
+
+  // Slab of event nodes addressed by a 32-bit id, recycled through a free list.
+  // A node holds the callable, its queue entry and an intrusive `next` link, so queues can chain
+  // events without storage of their own. Nodes live in fixed-size chunks that never move: a task
+  // runs in place while it schedules more tasks. Memory only grows to the peak number of pending
+  // events; after that, emplace/release do no heap allocation.
+  class EventArena
+  {
+   public:
+    static constexpr std::uint32_t kNil = 0xffffffffu;
+
+    enum class State : std::uint8_t
+    {
+      Free,
+      Queued,
+      Running,
+      Reserved, // scheduled by a member of a parallel batch; queued when the batch commits
+    };
+
+    struct Node
+    {
+      ScheduledEvent entry;
+      std::uint32_t next = kNil;
+      std::uint32_t generation = 0; // bumped on release; stale EventHandles stop matching
+      State state = State::Free;
+      bool cancelled = false;
+      Tick period = 0; // 0 = one-shot
+      Tick end = 0;    // last tick a periodic event may fire at
+      bool has_access = false; // declared EventAccess: may run in a parallel batch
+      std::uint32_t batch_cancel = kNil; // lowest batch member that cancelled it this batch
+      EventAccess access;
+      EventTask task;
+    };
+
+    template <class F>
+    std::uint32_t emplace(F&& fn)
+    {
+      if (free_.empty()) grow();
+      const std::uint32_t id = free_.back();
+      free_.pop_back();
+      node(id).task.emplace(std::forward<F>(fn));
+      return id;
+    }
+
+    std::uint32_t emplace_task(EventTask&& task)
+    {
+      if (free_.empty()) grow();
+      const std::uint32_t id = free_.back();
+      free_.pop_back();
+      node(id).task = std::move(task);
+      return id;
+    }
+
+    // Destroys the task of node `id` and recycles the node.
+    void release(std::uint32_t id);
+
+    Node& node(std::uint32_t id) { return chunks_[id / kChunkSize][id % kChunkSize]; }
+    const Node& node(std::uint32_t id) const { return chunks_[id / kChunkSize][id % kChunkSize]; }
+
+    ScheduledEvent& entry(std::uint32_t id) { return node(id).entry; }
+    std::uint32_t& next(std::uint32_t id) { return node(id).next; }
+
+    bool contains(std::uint32_t id) const { return id < capacity(); }
+    std::size_t capacity() const { return chunks_.size() * kChunkSize; }
+    std::size_t live() const { return capacity() - free_.size(); }
+    // Number of chunk allocations so far; stays flat once the pending peak has been reached.
+    std::size_t chunk_allocations() const { return chunks_.size(); }
+
+   private:
+    static constexpr std::size_t kChunkSize = 1024;
+
+    void grow();
+
+    std::vector<std::unique_ptr<Node[]>> chunks_;
+    std::vector<std::uint32_t> free_;
+  };
+} // namespace rescueops::sim
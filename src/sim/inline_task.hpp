@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rescueops::sim
+{
+  // Move-only `void()` callable stored in a fixed inline buffer: never allocates.
+  // Callables that do not fit are rejected at compile time rather than spilled to the heap;
+  // capture pointers/references (or an index) instead of large objects.
+  template <std::size_t Capacity>
+  class InlineTask
+  {
+   public:
+    static constexpr std::size_t kCapacity = Capacity;
+
+    InlineTask() = default;
+
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineTask>>>
+    InlineTask(F&& fn) // NOLINT(google-explicit-constructor): lambdas convert implicitly
+    {
+      emplace(std::forward<F>(fn));
+    }
+
+    InlineTask(InlineTask&& other) noexcept { take(other); }
+
+    InlineTask& operator=(InlineTask&& other) noexcept
+    {
+      if (this != &other)
+      {
+        reset();
+        take(other);
+      }
+      return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() { reset(); }
+
+    template <class F>
+    void emplace(F&& fn)
+    {
+      using T = std::decay_t<F>;
+      static_assert(sizeof(T) <= Capacity, "callable too large for InlineTask: capture less");
+      static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned callable");
+      static_assert(std::is_nothrow_move_constructible_v<T>, "callable must be nothrow-movable");
+      reset();
+      ::new (static_cast<void*>(buf_)) T(std::forward<F>(fn));
+      ops_ = &kOps<T>;
+    }
+
+    void reset()
+    {
+      if (!ops_) return;
+      ops_->destroy(buf_);
+      ops_ = nullptr;
+    }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+    void operator()() { ops_->invoke(buf_); }
+
+   private:
+    struct Ops
+    {
+      void (*invoke)(void*);
+      void (*relocate)(void* dst, void* src); // move-construct into dst, destroy src
+      void (*destroy)(void*);
+    };
+
+    template <class T>
+    static T* as(void* p)
+    {
+      return std::launder(static_cast<T*>(p));
+    }
+
+    template <class T>
+    static constexpr Ops kOps = {
+      [](void* p) { (*as<T>(p))(); },
+      [](void* dst, void* src) {
+        ::new (dst) T(std::move(*as<T>(src)));
+        as<T>(src)->~T();
+      },
+      [](void* p) { as<T>(p)->~T(); },
+    };
+
+    void take(InlineTask& other) noexcept
+    {
+      if (!other.ops_) return;
+      other.ops_->relocate(buf_, other.buf_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char buf_[Capacity];
+    const Ops* ops_ = nullptr;
+  };
+} // namespace rescueops::sim
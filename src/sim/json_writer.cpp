@@ -0,0 +1,109 @@
+#include "sim/json_writer.hpp"
+
+#include <algorithm>
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    // Escape for each byte below 0x20, and for '"' and '\'; empty means "copy as is".
+    constexpr std::string_view escape_for(unsigned char c)
+    {
+      switch (c)
+      {
+        case '"': return "\\\"";
+        case '\\': return "\\\\";
+        case '\b': return "\\b";
+        case '\f': return "\\f";
+        case '\n': return "\\n";
+        case '\r': return "\\r";
+        case '\t': return "\\t";
+        default: return {};
+      }
+    }
+
+    bool needs_escape(unsigned char c)
+    {
+      return c < 0x20 || c == '"' || c == '\\';
+    }
+  } // namespace
+
+  JsonWriter::JsonWriter(std::ostream& out, std::size_t buffer_bytes)
+    : out_(out), buf_(std::max<std::size_t>(buffer_bytes, 256))
+  {
+  }
+
+  JsonWriter::~JsonWriter()
+  {
+    flush();
+  }
+
+  JsonWriter& JsonWriter::spaces(std::size_t n)
+  {
+    while (n > 0)
+    {
+      if (used_ == buf_.size()) flush_buffer();
+      const std::size_t k = std::min(n, buf_.size() - used_);
+      std::memset(buf_.data() + used_, ' ', k);
+      used_ += k;
+      n -= k;
+    }
+    return *this;
+  }
+
+  JsonWriter& JsonWriter::string(std::string_view s)
+  {
+    put('"');
+    // Copy runs of plain bytes in one piece; names rarely need escaping at all.
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+      const auto c = static_cast<unsigned char>(s[i]);
+      if (!needs_escape(c)) continue;
+      raw(s.substr(run, i - run));
+      const std::string_view esc = escape_for(c);
+      if (!esc.empty())
+      {
+        raw(esc);
+      }
+      else
+      {
+        constexpr char kHex[] = "0123456789abcdef";
+        const char u[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+        raw(std::string_view(u, sizeof(u)));
+      }
+      run = i + 1;
+    }
+    raw(s.substr(run));
+    return put('"');
+  }
+
+  JsonWriter& JsonWriter::raw_slow(std::string_view s)
+  {
+    flush_buffer();
+    if (s.size() >= buf_.size())
+    {
+      out_.write(s.data(), static_cast<std::streamsize>(s.size()));
+      flushed_ += s.size();
+      return *this;
+    }
+    std::memcpy(buf_.data(), s.data(), s.size());
+    used_ = s.size();
+    return *this;
+  }
+
+  void JsonWriter::flush_buffer()
+  {
+    if (used_ == 0) return;
+    out_.write(buf_.data(), static_cast<std::streamsize>(used_));
+    flushed_ += used_;
+    used_ = 0;
+  }
+
+  bool JsonWriter::flush()
+  {
+    flush_buffer();
+    out_.flush();
+    return static_cast<bool>(out_);
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,78 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace rescueops::sim
+{
+  // Buffered JSON text output. Tokens are appended to a preallocated buffer and handed to the
+  // stream in large blocks; numbers are formatted with std::to_chars, without locale or stream
+  // state. string() quotes and escapes its argument. The writer does not track structure:
+  // callers emit the punctuation and whitespace themselves, so any layout can be reproduced
+  // byte for byte.
+  //
+  // The destructor flushes; call flush() first to see whether the stream accepted everything.
+  class JsonWriter
+  {
+   public:
+    explicit JsonWriter(std::ostream& out, std::size_t buffer_bytes = 64 * 1024);
+    ~JsonWriter();
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    // Verbatim text. Text larger than the buffer bypasses it.
+    JsonWriter& raw(std::string_view s)
+    {
+      if (s.size() > buf_.size() - used_) return raw_slow(s);
+      std::memcpy(buf_.data() + used_, s.data(), s.size());
+      used_ += s.size();
+      return *this;
+    }
+
+    JsonWriter& put(char c)
+    {
+      if (used_ == buf_.size()) flush_buffer();
+      buf_[used_++] = c;
+      return *this;
+    }
+
+    JsonWriter& spaces(std::size_t n);
+
+    template <class T>
+      requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
+    JsonWriter& number(T v)
+    {
+      if (buf_.size() - used_ < kMaxNumberChars) flush_buffer();
+      char* p = buf_.data() + used_;
+      used_ += static_cast<std::size_t>(std::to_chars(p, p + kMaxNumberChars, v).ptr - p);
+      return *this;
+    }
+
+    JsonWriter& boolean(bool v) { return raw(v ? std::string_view("true") : std::string_view("false")); }
+
+    // `s` as a JSON string: quoted, with '"', '\' and control characters escaped. Other bytes,
+    // including UTF-8 sequences, are copied as they are.
+    JsonWriter& string(std::string_view s);
+
+    // Writes the buffered text to the stream; false if the stream is in a failed state.
+    bool flush();
+
+    // Bytes accepted so far, buffered or not.
+    std::size_t bytes_written() const { return flushed_ + used_; }
+
+   private:
+    static constexpr std::size_t kMaxNumberChars = 24; // any 64-bit integer, with sign
+
+    JsonWriter& raw_slow(std::string_view s);
+    void flush_buffer();
+
+    std::ostream& out_;
+    std::vector<char> buf_;
+    std::size_t used_ = 0;
+    std::size_t flushed_ = 0;
+  };
+} // namespace rescueops::sim
@@ -0,0 +1,99 @@
+#include "sim/mapped_file.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rescueops::sim
+{
+  MappedFile::~MappedFile()
+  {
+    close();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+  {
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other)
+    {
+      close();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+#ifdef _WIN32
+  bool MappedFile::open(const std::string& path)
+  {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    {
+      CloseHandle(file);
+      return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return false;
+    // The view keeps the mapping alive after its handle is closed.
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return false;
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    return true;
+  }
+
+  void MappedFile::close()
+  {
+    if (data_) UnmapViewOfFile(data_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+#else
+  bool MappedFile::open(const std::string& path)
+  {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+      ::close(fd);
+      return false;
+    }
+    // The mapping stays valid after the descriptor is closed.
+    void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    data_ = static_cast<const char*>(p);
+    size_ = static_cast<std::size_t>(st.st_size);
+    return true;
+  }
+
+  void MappedFile::close()
+  {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+#endif
+} // namespace rescueops::sim
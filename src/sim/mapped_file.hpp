@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace rescueops::sim
+{
+  // Read-only view of a whole file. Uses mmap (POSIX) or a file mapping (Windows), so pages are
+  // loaded on first touch and shared with every other process mapping the same file. The data
+  // is page-aligned. Move-only.
+  class MappedFile
+  {
+   public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps `path`; false (and closed) if it cannot be opened or mapped, or is empty.
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+   private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+  };
+} // namespace rescueops::sim
@@ -0,0 +1,109 @@
+#include "sim/monte_carlo.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "sim/thread_pool.hpp"
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    // Linear interpolation between closest ranks of a sorted sample.
+    double percentile(const std::vector<double>& sorted, double q)
+    {
+      if (sorted.empty()) return 0.0;
+      const double rank = q * static_cast<double>(sorted.size() - 1);
+      const auto lo = static_cast<std::size_t>(rank);
+      const std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+      return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - static_cast<double>(lo));
+    }
+  } // namespace
+
+  bool MonteCarlo::run(std::string_view base_snapshot, const MonteCarloConfig& cfg, ThreadPool& pool,
+                       const Measure& measure, const Sink& sink)
+  {
+    // One engine per worker, reused across its runs (restore() replaces the whole state).
+    std::vector<std::unique_ptr<Engine>> engines(pool.size());
+    for (auto& e : engines)
+    {
+      e = std::make_unique<Engine>();
+      if (!e->restore(base_snapshot)) return false;
+    }
+
+    moments_.resize(names_.size());
+    samples_.resize(names_.size());
+    next_emit_ = 0;
+    first_seed_ = cfg.first_seed;
+    window_.clear();
+
+    // Runs are taken in increasing order, so run next_emit_ is always already running: waiting
+    // for it cannot deadlock.
+    const std::size_t window = cfg.window > 0 ? cfg.window : 2 * static_cast<std::size_t>(pool.size());
+    pool.parallel_for(cfg.runs, [&](std::size_t i, unsigned worker) {
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        emitted_.wait(lock, [&] { return i < next_emit_ + window; });
+      }
+      Engine& eng = *engines[worker];
+      eng.restore(base_snapshot);
+      eng.set_seed(cfg.first_seed + i);
+      eng.run(cfg.ticks);
+
+      std::vector<double> metrics(names_.size(), 0.0);
+      measure(eng, worker, metrics);
+      accept(i, std::move(metrics), sink);
+    });
+    return true;
+  }
+
+  void MonteCarlo::accept(std::size_t run, std::vector<double> metrics, const Sink& sink)
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    window_.emplace(run, std::move(metrics));
+    // Emit every run that is now contiguous with what was already emitted.
+    for (auto it = window_.begin(); it != window_.end() && it->first == next_emit_; it = window_.erase(it))
+    {
+      const auto& m = it->second;
+      for (std::size_t k = 0; k < m.size(); ++k)
+      {
+        Welford& w = moments_[k];
+        ++w.n;
+        const double delta = m[k] - w.mean;
+        w.mean += delta / static_cast<double>(w.n);
+        w.m2 += delta * (m[k] - w.mean);
+        samples_[k].push_back(m[k]);
+      }
+      if (sink) sink(next_emit_, first_seed_ + next_emit_, m);
+      ++next_emit_;
+    }
+    peak_waiting_ = std::max(peak_waiting_, window_.size());
+    emitted_.notify_all();
+  }
+
+  std::vector<MetricSummary> MonteCarlo::summary() const
+  {
+    std::vector<MetricSummary> out;
+    for (std::size_t k = 0; k < samples_.size(); ++k)
+    {
+      MetricSummary s;
+      s.name = names_[k];
+      s.count = moments_[k].n;
+      s.mean = moments_[k].mean;
+      s.stdev = s.count > 1 ? std::sqrt(moments_[k].m2 / static_cast<double>(s.count - 1)) : 0.0;
+      std::vector<double> sorted = samples_[k];
+      std::sort(sorted.begin(), sorted.end());
+      if (!sorted.empty())
+      {
+        s.min = sorted.front();
+        s.max = sorted.back();
+      }
+      s.p50 = percentile(sorted, 0.50);
+      s.p90 = percentile(sorted, 0.90);
+      s.p99 = percentile(sorted, 0.99);
+      out.push_back(s);
+    }
+    return out;
+  }
+} // namespace rescueops::sim
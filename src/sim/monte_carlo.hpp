@@ -0,0 +1,90 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "sim/engine.hpp"
+
+namespace rescueops::sim
+{
+  class ThreadPool;
+
+  struct MonteCarloConfig
+  {
+    std::uint64_t first_seed = 1; // run i uses seed first_seed + i
+    std::size_t runs = 0;
+    Tick ticks = 0;
+    // Most runs started but not yet emitted in seed order (0 = twice the pool size).
+    std::size_t window = 0;
+  };
+
+  // One metric over all runs. stdev is the sample standard deviation; percentiles interpolate
+  // linearly between the closest ranks.
+  struct MetricSummary
+  {
+    std::string name;
+    std::size_t count = 0;
+    double mean = 0.0;
+    double stdev = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  // Runs one scenario under many seeds. Every run is forked from the same base snapshot
+  // (Engine::checkpoint) into a per-worker Engine, so the scenario is parsed once and anything the
+  // measure callback shares (grids, planners) is built once and only read.
+  // Runs are handed out on the pool one at a time (an idle worker takes the next seed). Results
+  // are reordered into seed order before reaching the sink and the statistics, so the output
+  // stream and the summary are identical for any thread count. A worker does not start run i
+  // until run i - window has been emitted, so one slow run holds back at most `window` others.
+  // Per run only its metric values are kept (for exact percentiles), never the engine.
+  class MonteCarlo
+  {
+   public:
+    // Fills `out` (one slot per metric name) from a finished run; `worker` identifies the
+    // calling pool thread, for per-thread scratch.
+    using Measure = std::function<void(const Engine& engine, unsigned worker, std::span<double> out)>;
+    // Receives each run's metrics in seed order (called from one thread at a time).
+    using Sink = std::function<void(std::size_t run, std::uint64_t seed, std::span<const double> metrics)>;
+
+    explicit MonteCarlo(std::vector<std::string> metric_names) : names_(std::move(metric_names)) {}
+
+    // False if `base_snapshot` does not restore. Statistics accumulate across calls.
+    bool run(std::string_view base_snapshot, const MonteCarloConfig& cfg, ThreadPool& pool, const Measure& measure,
+             const Sink& sink);
+
+    std::size_t runs() const { return samples_.empty() ? 0 : samples_.front().size(); }
+    // Most finished runs that waited at once for an earlier run to be emitted.
+    std::size_t peak_waiting() const { return peak_waiting_; }
+    std::vector<MetricSummary> summary() const;
+
+   private:
+    void accept(std::size_t run, std::vector<double> metrics, const Sink& sink);
+
+    struct Welford
+    {
+      std::size_t n = 0;
+      double mean = 0.0;
+      double m2 = 0.0;
+    };
+
+    std::vector<std::string> names_;
+    std::vector<Welford> moments_;
+    std::vector<std::vector<double>> samples_; // per metric, in seed order
+
+    std::mutex mu_;
+    std::condition_variable emitted_;
+    std::size_t next_emit_ = 0;
+    std::size_t peak_waiting_ = 0;
+    std::uint64_t first_seed_ = 0;
+    std::map<std::size_t, std::vector<double>> window_; // finished runs waiting for earlier ones
+  };
+} // namespace rescueops::sim
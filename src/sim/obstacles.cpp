@@ -0,0 +1,100 @@
+#include "sim/obstacles.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    // Blocks cells [x0, x1) of row y; the range is already clipped.
+    void fill_span(std::span<std::uint8_t> blocked, int width, long long y, long long x0, long long x1)
+    {
+      std::memset(blocked.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+                    static_cast<std::size_t>(x0),
+                  1, static_cast<std::size_t>(x1 - x0));
+    }
+
+    // Rectangle with its rows shifted up by `oy` (the first row the grid holds).
+    void fill_rect_at(std::span<std::uint8_t> blocked, int width, int height, const ObstacleRect& r, long long oy)
+    {
+      // 64-bit bounds so x + w cannot overflow
+      const long long x0 = std::max<long long>(r.x, 0);
+      const long long x1 = std::min<long long>(static_cast<long long>(r.x) + r.w, width);
+      const long long y0 = std::max<long long>(r.y - oy, 0);
+      const long long y1 = std::min<long long>(static_cast<long long>(r.y) + r.h - oy, height);
+      if (x0 >= x1 || y0 >= y1) return;
+      for (long long yy = y0; yy < y1; ++yy) fill_span(blocked, width, yy, x0, x1);
+    }
+
+    void fill_layer_at(std::span<std::uint8_t> blocked, int width, int height, const ObstacleLayer& layer, long long oy)
+    {
+      if (layer.width <= 0 || layer.height <= 0) return;
+      const auto lw = static_cast<long long>(layer.width);
+      const long long cells = lw * layer.height;
+      long long pos = 0; // row-major index inside the layer
+      for (std::size_t i = 0; i < layer.runs.size() && pos < cells; ++i)
+      {
+        const long long end = std::min<long long>(pos + layer.runs[i], cells);
+        if (i % 2 == 1)
+        {
+          // A blocked run: one span per layer row it touches, clipped to the grid.
+          while (pos < end)
+          {
+            const long long row = pos / lw;
+            const long long col = pos % lw;
+            const long long stop = std::min(end, (row + 1) * lw);
+            const long long gy = layer.y + row - oy;
+            if (gy >= 0 && gy < height)
+            {
+              const long long x0 = std::max<long long>(layer.x + col, 0);
+              const long long x1 = std::min<long long>(layer.x + col + (stop - pos), width);
+              if (x0 < x1) fill_span(blocked, width, gy, x0, x1);
+            }
+            pos = stop;
+          }
+        }
+        pos = end;
+      }
+    }
+  } // namespace
+
+  void fill_rect(std::span<std::uint8_t> blocked, int width, int height, int x, int y, int w, int h)
+  {
+    fill_rect_at(blocked, width, height, ObstacleRect{x, y, w, h}, 0);
+  }
+
+  void fill_layer(std::span<std::uint8_t> blocked, int width, int height, const ObstacleLayer& layer)
+  {
+    fill_layer_at(blocked, width, height, layer, 0);
+  }
+
+  std::size_t count_blocked(std::span<const std::uint8_t> blocked)
+  {
+    // Eight 0/1 cells per word. Multiplying by 0x0101...01 sums the bytes into the top byte, a
+    // popcount that stays cheap without a POPCNT instruction (not in the x86-64 baseline).
+    constexpr std::uint64_t kOnes = 0x0101010101010101ull;
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= blocked.size(); i += 8)
+    {
+      std::uint64_t word = 0;
+      std::memcpy(&word, blocked.data() + i, 8);
+      count += static_cast<std::size_t>((word * kOnes) >> 56);
+    }
+    for (; i < blocked.size(); ++i) count += blocked[i];
+    return count;
+  }
+
+  std::size_t rasterize_obstacles(const Scenario& scenario,
+                                  int width,
+                                  int height,
+                                  std::span<std::uint8_t> blocked,
+                                  int first_row)
+  {
+    if (width <= 0 || height <= 0) return 0;
+    for (const auto& r : scenario.obstacles) fill_rect_at(blocked, width, height, r, first_row);
+    for (const auto& layer : scenario.obstacle_layers) fill_layer_at(blocked, width, height, layer, first_row);
+    return count_blocked(blocked.first(static_cast<std::size_t>(width) * static_cast<std::size_t>(height)));
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "sim/scenario.hpp"
+
+namespace rescueops::sim
+{
+  // Obstacle rasterization into a row-major width x height byte grid (0 free, 1 blocked).
+  // Shapes are clipped to the grid once and filled one row span at a time.
+
+  // Blocks the rectangle [x, x + w) x [y, y + h); empty or outside parts are ignored.
+  void fill_rect(std::span<std::uint8_t> blocked, int width, int height, int x, int y, int w, int h);
+
+  // Blocks the cells of a run-length encoded layer (see ObstacleLayer).
+  void fill_layer(std::span<std::uint8_t> blocked, int width, int height, const ObstacleLayer& layer);
+
+  // Number of blocked cells; cells must hold 0 or 1.
+  std::size_t count_blocked(std::span<const std::uint8_t> blocked);
+
+  // Blocks every obstacle and obstacle layer of `scenario` on top of what `blocked` already
+  // holds, and returns the number of blocked cells afterwards. With `first_row`, `blocked` is
+  // the band of world rows [first_row, first_row + height), so a map too large to hold at once
+  // can be rasterized band by band.
+  std::size_t rasterize_obstacles(const Scenario& scenario,
+                                  int width,
+                                  int height,
+                                  std::span<std::uint8_t> blocked,
+                                  int first_row = 0);
+} // namespace rescueops::sim
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace rescueops::sim
+{
+  // Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): a keyed
+  // bijection of a 128-bit counter. Random numbers are a pure function of (key, counter), so
+  // any unit can draw its values for any tick without a shared generator state: results do not
+  // depend on iteration order or on how the work is split between threads.
+  using PhiloxCounter = std::array<std::uint32_t, 4>;
+  using PhiloxKey = std::array<std::uint32_t, 2>;
+
+  constexpr PhiloxCounter philox4x32(PhiloxCounter ctr, PhiloxKey key)
+  {
+    constexpr std::uint32_t kMul0 = 0xD2511F53u;
+    constexpr std::uint32_t kMul1 = 0xCD9E8D57u;
+    constexpr std::uint32_t kWeyl0 = 0x9E3779B9u;
+    constexpr std::uint32_t kWeyl1 = 0xBB67AE85u;
+    for (int round = 0; round < 10; ++round)
+    {
+      const std::uint64_t p0 = std::uint64_t{kMul0} * ctr[0];
+      const std::uint64_t p1 = std::uint64_t{kMul1} * ctr[2];
+      ctr = PhiloxCounter{static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(p1),
+                          static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(p0)};
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    return ctr;
+  }
+
+  // Independent sequences drawn from one (seed, unit, tick) triple.
+  enum class RngStream : std::uint32_t
+  {
+    Motion = 0,
+  };
+
+  // The four words for `unit` at `tick` on `stream`, keyed by the run seed.
+  constexpr PhiloxCounter counter_random(std::uint64_t seed, std::uint32_t unit, std::uint64_t tick,
+                                         RngStream stream)
+  {
+    return philox4x32(PhiloxCounter{unit, static_cast<std::uint32_t>(tick), static_cast<std::uint32_t>(tick >> 32),
+                                    static_cast<std::uint32_t>(stream)},
+                      PhiloxKey{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)});
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,478 @@
+#include "sim/scenario.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    // Recursive-descent reader over the scenario text. Each byte is visited once; values of
+    // interest are decoded in place, everything else is skipped structurally.
+    class Parser
+    {
+     public:
+      Parser(std::string_view text, Scenario& out) : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()), out_(out) {}
+
+      bool parse()
+      {
+        ws();
+        if (!object([&](std::string_view key) { return root_field(key); })) return false;
+        ws();
+        if (p_ != end_) return fail("trailing characters after the scenario object");
+        return true;
+      }
+
+      const std::string& error() const { return error_; }
+
+     private:
+      static constexpr int kMaxDepth = 64;
+
+      bool fail(const char* what)
+      {
+        if (error_.empty()) error_ = std::string(what) + " at offset " + std::to_string(p_ - begin_);
+        return false;
+      }
+
+      void ws()
+      {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+      }
+
+      bool peek(char c)
+      {
+        ws();
+        return p_ != end_ && *p_ == c;
+      }
+
+      bool expect(char c)
+      {
+        if (!peek(c))
+        {
+          const char msg[] = {'e', 'x', 'p', 'e', 'c', 't', 'e', 'd', ' ', '\'', c, '\'', '\0'};
+          return fail(msg);
+        }
+        ++p_;
+        return true;
+      }
+
+      // Calls on_key(key) with the cursor before each value; on_key must consume the value.
+      // A trailing comma before '}' is tolerated.
+      template <class F>
+      bool object(F&& on_key)
+      {
+        if (!expect('{')) return false;
+        if (++depth_ > kMaxDepth) return fail("nesting too deep");
+        while (!peek('}'))
+        {
+          std::string_view key;
+          bool escaped = false;
+          if (!string(key, escaped) || !expect(':') || !on_key(key)) return false;
+          if (peek(',')) ++p_;
+          else if (!peek('}')) return fail("expected ',' or '}'");
+        }
+        ++p_;
+        --depth_;
+        return true;
+      }
+
+      // Calls on_element() with the cursor before each element. Trailing comma tolerated.
+      template <class F>
+      bool array(F&& on_element)
+      {
+        if (!expect('[')) return false;
+        if (++depth_ > kMaxDepth) return fail("nesting too deep");
+        while (!peek(']'))
+        {
+          if (!on_element()) return false;
+          if (peek(',')) ++p_;
+          else if (!peek(']')) return fail("expected ',' or ']'");
+        }
+        ++p_;
+        --depth_;
+        return true;
+      }
+
+      // Raw contents between the quotes; `escaped` tells whether decode() is needed.
+      bool string(std::string_view& raw, bool& escaped)
+      {
+        if (!expect('"')) return false;
+        const char* start = p_;
+        escaped = false;
+        while (p_ != end_ && *p_ != '"')
+        {
+          if (*p_ == '\\')
+          {
+            escaped = true;
+            if (++p_ == end_) break;
+          }
+          ++p_;
+        }
+        if (p_ == end_) return fail("unterminated string");
+        raw = std::string_view(start, static_cast<std::size_t>(p_ - start));
+        ++p_;
+        return true;
+      }
+
+      static void append_utf8(std::string& out, std::uint32_t cp)
+      {
+        if (cp < 0x80)
+        {
+          out += static_cast<char>(cp);
+        }
+        else if (cp < 0x800)
+        {
+          out += static_cast<char>(0xC0 | (cp >> 6));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+          out += static_cast<char>(0xE0 | (cp >> 12));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+          out += static_cast<char>(0xF0 | (cp >> 18));
+          out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+      }
+
+      static bool hex4(std::string_view s, std::size_t i, std::uint32_t& v)
+      {
+        if (i + 4 > s.size()) return false;
+        const auto r = std::from_chars(s.data() + i, s.data() + i + 4, v, 16);
+        return r.ec == std::errc{} && r.ptr == s.data() + i + 4;
+      }
+
+      // JSON escapes to UTF-8; unknown or malformed escapes are kept literally.
+      static void decode(std::string_view raw, std::string& out)
+      {
+        out.clear();
+        for (std::size_t i = 0; i < raw.size(); ++i)
+        {
+          if (raw[i] != '\\' || i + 1 == raw.size())
+          {
+            out += raw[i];
+            continue;
+          }
+          const char c = raw[++i];
+          switch (c)
+          {
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          case 'u':
+          {
+            std::uint32_t cp = 0;
+            if (!hex4(raw, i + 1, cp))
+            {
+              out += "\\u";
+              break;
+            }
+            i += 4;
+            std::uint32_t low = 0;
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u' &&
+                hex4(raw, i + 3, low) && low >= 0xDC00 && low < 0xE000)
+            {
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+              i += 6;
+            }
+            append_utf8(out, cp);
+            break;
+          }
+          default: out += c; break; // \" \\ \/ and anything unknown
+          }
+        }
+      }
+
+      // A number token; `value` gets its integer part (fraction and exponent are dropped).
+      bool number(long long& value)
+      {
+        ws();
+        const char* start = p_;
+        if (p_ != end_ && *p_ == '-') ++p_;
+        const char* digits = p_;
+        while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        if (p_ == digits) return fail("expected a number");
+        const char* int_end = p_;
+        while (p_ != end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-' ||
+                              (*p_ >= '0' && *p_ <= '9')))
+          ++p_;
+        const auto r = std::from_chars(start, int_end, value);
+        if (r.ec != std::errc{}) return fail("number out of range");
+        return true;
+      }
+
+      // Numeric field: a number yields a value, anything else is skipped and yields none.
+      bool int_field(std::optional<long long>& out)
+      {
+        ws();
+        if (p_ != end_ && (*p_ == '-' || (*p_ >= '0' && *p_ <= '9')))
+        {
+          long long v = 0;
+          if (!number(v)) return false;
+          out = v;
+          return true;
+        }
+        return skip();
+      }
+
+      // Unsigned 64-bit field (seeds span the full u64 range); a negative number is an error,
+      // anything that is not a number is skipped and yields none.
+      bool u64_field(std::optional<std::uint64_t>& out)
+      {
+        ws();
+        if (p_ != end_ && *p_ == '-') return fail("expected a non-negative number");
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') return skip();
+        const char* start = p_;
+        while (p_ != end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        const char* int_end = p_;
+        while (p_ != end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-' ||
+                              (*p_ >= '0' && *p_ <= '9')))
+          ++p_;
+        std::uint64_t v = 0;
+        const auto r = std::from_chars(start, int_end, v);
+        if (r.ec != std::errc{}) return fail("number out of range");
+        out = v;
+        return true;
+      }
+
+      bool literal(std::string_view word)
+      {
+        if (static_cast<std::size_t>(end_ - p_) < word.size() || std::string_view(p_, word.size()) != word)
+          return fail("unexpected character");
+        p_ += word.size();
+        return true;
+      }
+
+      bool skip()
+      {
+        ws();
+        if (p_ == end_) return fail("unexpected end of input");
+        switch (*p_)
+        {
+        case '{': return object([&](std::string_view) { return skip(); });
+        case '[': return array([&] { return skip(); });
+        case '"':
+        {
+          std::string_view s;
+          bool escaped = false;
+          return string(s, escaped);
+        }
+        case 't': return literal("true");
+        case 'f': return literal("false");
+        case 'n': return literal("null");
+        default:
+        {
+          long long v = 0;
+          return number(v);
+        }
+        }
+      }
+
+      bool root_field(std::string_view key)
+      {
+        if (key == "seed")
+        {
+          std::optional<std::uint64_t> v;
+          if (!u64_field(v)) return false;
+          if (v) out_.seed = *v;
+          return true;
+        }
+        if (key == "ticks")
+        {
+          std::optional<long long> v;
+          if (!int_field(v)) return false;
+          if (v && *v >= 0) out_.ticks = static_cast<std::uint64_t>(*v);
+          return true;
+        }
+        if (key == "world" && peek('{'))
+        {
+          return object([&](std::string_view k) {
+            std::optional<long long> v;
+            if (!int_field(v)) return false;
+            if (v && k == "width") out_.world.width = static_cast<int>(*v);
+            if (v && k == "height") out_.world.height = static_cast<int>(*v);
+            return true;
+          });
+        }
+        if (key == "units" && peek('[')) return array([&] { return unit(); });
+        if (key == "targets" && peek('[')) return array([&] { return target(); });
+        if (key == "obstacles" && peek('[')) return array([&] { return obstacle(); });
+        if (key == "obstacle_layers" && peek('[')) return array([&] { return obstacle_layer(); });
+        return skip();
+      }
+
+      bool unit()
+      {
+        if (!peek('{')) return skip();
+        std::optional<std::string_view> name;
+        bool escaped = false;
+        std::optional<long long> x, y;
+        const bool ok = object([&](std::string_view k) {
+          if (k == "name" && peek('"'))
+          {
+            std::string_view s;
+            if (!string(s, escaped)) return false;
+            name = s;
+            return true;
+          }
+          if (k == "x") return int_field(x);
+          if (k == "y") return int_field(y);
+          return skip();
+        });
+        if (!ok) return false;
+        if (!name || !x || !y) return true;
+
+        const auto id = static_cast<std::uint32_t>(out_.world.units.size() + 1);
+        std::string_view n = *name;
+        if (escaped)
+        {
+          decode(n, scratch_);
+          n = scratch_;
+        }
+        if (n.empty())
+        {
+          scratch_ = "unit_" + std::to_string(id);
+          n = scratch_;
+        }
+        out_.world.units.push_back(id, n, Vec2i{static_cast<int>(*x), static_cast<int>(*y)});
+        return true;
+      }
+
+      bool target()
+      {
+        if (!peek('{')) return skip();
+        std::optional<std::string_view> unit;
+        bool escaped = false;
+        std::optional<long long> tx, ty;
+        const bool ok = object([&](std::string_view k) {
+          if (k == "unit" && peek('"'))
+          {
+            std::string_view s;
+            if (!string(s, escaped)) return false;
+            unit = s;
+            return true;
+          }
+          if (k == "tx") return int_field(tx);
+          if (k == "ty") return int_field(ty);
+          return skip();
+        });
+        if (!ok) return false;
+        if (!unit || !tx || !ty) return true;
+
+        std::string_view u = *unit;
+        if (escaped)
+        {
+          decode(u, out_.unescaped.emplace_back());
+          u = out_.unescaped.back();
+        }
+        out_.targets.push_back(ScenarioTarget{u, static_cast<int>(*tx), static_cast<int>(*ty)});
+        return true;
+      }
+
+      bool obstacle()
+      {
+        if (!peek('{')) return skip();
+        std::optional<long long> x, y, w, h;
+        const bool ok = object([&](std::string_view k) {
+          if (k == "x") return int_field(x);
+          if (k == "y") return int_field(y);
+          if (k == "w") return int_field(w);
+          if (k == "h") return int_field(h);
+          return skip();
+        });
+        if (!ok) return false;
+        if (!x || !y) return true;
+
+        ObstacleRect r{static_cast<int>(*x), static_cast<int>(*y), 1, 1};
+        if (w && h)
+        {
+          r.w = static_cast<int>(*w);
+          r.h = static_cast<int>(*h);
+        }
+        out_.obstacles.push_back(r);
+        return true;
+      }
+
+      bool obstacle_layer()
+      {
+        if (!peek('{')) return skip();
+        std::optional<long long> x, y, w, h;
+        ObstacleLayer layer;
+        bool has_runs = false;
+        const bool ok = object([&](std::string_view k) {
+          if (k == "x") return int_field(x);
+          if (k == "y") return int_field(y);
+          if (k == "width") return int_field(w);
+          if (k == "height") return int_field(h);
+          if (k == "runs" && peek('['))
+          {
+            has_runs = true;
+            return array([&] {
+              long long run = 0;
+              if (!number(run)) return false;
+              if (run < 0 || run > 0xffffffffll) return fail("run length out of range");
+              layer.runs.push_back(static_cast<std::uint32_t>(run));
+              return true;
+            });
+          }
+          return skip();
+        });
+        if (!ok) return false;
+        if (!w || !h || !has_runs) return true;
+
+        layer.x = x ? static_cast<int>(*x) : 0;
+        layer.y = y ? static_cast<int>(*y) : 0;
+        layer.width = static_cast<int>(*w);
+        layer.height = static_cast<int>(*h);
+        out_.obstacle_layers.push_back(std::move(layer));
+        return true;
+      }
+
+      const char* begin_;
+      const char* p_;
+      const char* end_;
+      Scenario& out_;
+      int depth_ = 0;
+      std::string scratch_;
+      std::string error_;
+    };
+  } // namespace
+
+  bool parse_scenario(std::string text, Scenario& out, std::string* error)
+  {
+    Scenario s;
+    s.text = std::move(text);
+    Parser parser(s.text, s);
+    if (!parser.parse())
+    {
+      if (error) *error = parser.error();
+      return false;
+    }
+    if (s.world.units.empty()) s.world.units.push_back(Unit{1, "alpha", Vec2i{1, 1}});
+    out = std::move(s);
+    return true;
+  }
+
+  bool load_scenario_file(const std::string& path, Scenario& out, std::string* error)
+  {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+      if (error) *error = "cannot open " + path;
+      return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return parse_scenario(std::move(ss).str(), out, error);
+  }
+} // namespace rescueops::sim
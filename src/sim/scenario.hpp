@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sim/world.hpp"
+
+namespace rescueops::sim
+{
+  // "targets": [{"unit": "alpha", "tx": 12, "ty": 7}, ...]
+  struct ScenarioTarget
+  {
+    std::string_view unit; // points into the owning Scenario
+    int tx = 0;
+    int ty = 0;
+  };
+
+  // "obstacles": [{"x": 16, "y": 0, "w": 1, "h": 8}, {"x": 10, "y": 10}, ...]
+  // An entry without both w and h is the single cell (x, y).
+  struct ObstacleRect
+  {
+    int x = 0;
+    int y = 0;
+    int w = 1;
+    int h = 1;
+  };
+
+  // "obstacle_layers": [{"x": 0, "y": 0, "width": 4, "height": 2, "runs": [1, 2, 3, 2]}, ...]
+  // A raster of width x height cells placed at (x, y), run-length encoded in row-major order:
+  // run lengths alternate free, blocked, free, ... starting with free, and may cross rows.
+  // Cells past the last run are free; runs past the end of the layer are ignored.
+  struct ObstacleLayer
+  {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint32_t> runs;
+  };
+
+  // Everything a scenario file describes. Move-only: target names are views into `text` (or,
+  // for names with escape sequences, into the decoded copies kept alongside).
+  struct Scenario
+  {
+    std::uint64_t seed = 42;
+    std::uint64_t ticks = 0; // suggested run length, 0 if absent
+    World world;             // 32x18 and a default unit "alpha" if the file gives none
+    std::vector<ScenarioTarget> targets;
+    std::vector<ObstacleRect> obstacles;
+    std::vector<ObstacleLayer> obstacle_layers;
+
+    std::string text;
+    std::deque<std::string> unescaped;
+
+    Scenario() = default;
+    Scenario(Scenario&&) = default;
+    Scenario& operator=(Scenario&&) = default;
+    Scenario(const Scenario&) = delete;
+    Scenario& operator=(const Scenario&) = delete;
+  };
+
+  // Parses a scenario in one pass over the text: no per-field searches, numbers via
+  // std::from_chars, names stored as views (only names with escapes are copied, decoded).
+  // Unknown keys are skipped. Units need "name", "x" and "y", targets "unit", "tx" and "ty",
+  // obstacles "x" and "y", obstacle layers "width", "height" and "runs"; incomplete entries are
+  // ignored. Fractional numbers are truncated.
+  // On malformed JSON returns false and, if `error` is set, describes the first problem.
+  bool parse_scenario(std::string text, Scenario& out, std::string* error = nullptr);
+  // Reads the file once and parses it.
+  bool load_scenario_file(const std::string& path, Scenario& out, std::string* error = nullptr);
+} // namespace rescueops::sim
@@ -1,24 +1,241 @@
 #include "sim/scheduler.hpp"
 
+#include <algorithm>
+
+#include "sim/thread_pool.hpp"
+
 namespace rescueops::sim
 {
-  void Scheduler::schedule(Tick at, std::function<void()> fn)
+  using State = EventArena::State;
+
+  namespace
+  {
+    // Set while a worker runs a batch member: schedule()/cancel() on that scheduler are buffered.
+    thread_local const Scheduler* t_batch_owner = nullptr;
+    thread_local void* t_batch_ops = nullptr; // std::vector<Scheduler::Deferred>*
+    thread_local std::uint32_t t_batch_self = EventArena::kNil;
+    thread_local std::uint32_t t_batch_member = 0; // index in the batch, i.e. seq order
+  } // namespace
+
+  EventHandle Scheduler::add(Tick at, Tick period, Tick end, const EventAccess* access, EventTask&& task)
+  {
+    if (t_batch_owner == this) return add_in_batch(at, period, end, access, std::move(task));
+
+    const std::uint32_t id = arena_.emplace_task(std::move(task));
+    auto& node = arena_.node(id);
+    node.period = period;
+    node.end = end;
+    node.has_access = access != nullptr;
+    if (access) node.access = *access;
+    node.entry = ScheduledEvent{at, next_seq_++, id};
+    push(node.entry);
+    return EventHandle{id, node.generation};
+  }
+
+  EventHandle Scheduler::add_in_batch(Tick at, Tick period, Tick end, const EventAccess* access, EventTask&& task)
   {
-    q_.push(ScheduledEvent{at, next_seq_++, std::move(fn)});
+    // The serial loop would run such an event before the rest of the batch.
+    if (at < batch_.front().tick)
+    {
+      violations_.fetch_add(1, std::memory_order_relaxed);
+      return EventHandle{};
+    }
+
+    // Reserve the node now so the handle works; it gets its seq and is queued at commit.
+    std::lock_guard<std::mutex> lock(batch_mu_);
+    const std::uint32_t id = arena_.emplace_task(std::move(task));
+    auto& node = arena_.node(id);
+    node.period = period;
+    node.end = end;
+    node.has_access = access != nullptr;
+    if (access) node.access = *access;
+    node.entry.tick = at;
+    node.state = State::Reserved;
+    const EventHandle handle{id, node.generation};
+    static_cast<std::vector<Deferred>*>(t_batch_ops)->push_back(Deferred{false, handle});
+    return handle;
+  }
+
+  void Scheduler::push(const ScheduledEvent& ev)
+  {
+    arena_.node(ev.task).state = State::Queued;
+    if (kind_ == EventQueue::TimingWheel)
+    {
+      wheel_.push(ev);
+      return;
+    }
+    heap_.push_back(ev);
+    std::push_heap(heap_.begin(), heap_.end());
+  }
+
+  bool Scheduler::pop_due(Tick now, ScheduledEvent& out)
+  {
+    if (kind_ == EventQueue::TimingWheel) return wheel_.pop_due(now, out);
+
+    if (heap_.empty() || heap_.front().tick > now) return false;
+    std::pop_heap(heap_.begin(), heap_.end());
+    out = heap_.back();
+    heap_.pop_back();
+    return true;
+  }
+
+  bool Scheduler::cancel(EventHandle handle)
+  {
+    if (t_batch_owner == this) return cancel_in_batch(handle);
+    if (!arena_.contains(handle.id)) return false;
+    return cancel_now(handle);
+  }
+
+  bool Scheduler::cancel_in_batch(EventHandle handle)
+  {
+    std::lock_guard<std::mutex> lock(batch_mu_);
+    if (!arena_.contains(handle.id)) return false;
+    auto& node = arena_.node(handle.id);
+    if (node.generation != handle.generation || node.state == State::Free || node.cancelled) return false;
+    if (node.state == State::Running && handle.id != t_batch_self)
+    {
+      violations_.fetch_add(1, std::memory_order_relaxed); // a batch peer
+      return false;
+    }
+
+    // In the serial run the first member (in seq order) to cancel an event gets true and every
+    // later attempt false.
+    if (node.batch_cancel != EventArena::kNil)
+    {
+      if (node.batch_cancel <= t_batch_member) return false;
+      violations_.fetch_add(1, std::memory_order_relaxed); // a later member already got true
+    }
+    node.batch_cancel = t_batch_member;
+    static_cast<std::vector<Deferred>*>(t_batch_ops)->push_back(Deferred{true, handle});
+    return true;
+  }
+
+  bool Scheduler::cancel_now(EventHandle handle)
+  {
+    auto& node = arena_.node(handle.id);
+    if (node.generation != handle.generation || node.state == State::Free || node.cancelled) return false;
+
+    // Queued entries are dropped lazily when they surface; a running one is not re-armed.
+    node.cancelled = true;
+    if (node.state == State::Queued) ++cancelled_queued_;
+    return true;
+  }
+
+  void Scheduler::finish(const ScheduledEvent& ev)
+  {
+    // Re-arm in place with the same seq (the node may have cancelled itself meanwhile).
+    auto& node = arena_.node(ev.task);
+    if (node.period != 0 && !node.cancelled && node.end - ev.tick >= node.period)
+    {
+      node.entry.tick = ev.tick + node.period;
+      push(node.entry);
+      return;
+    }
+    arena_.release(ev.task);
+  }
+
+  void Scheduler::run_batch(Tick now, const ScheduledEvent& first)
+  {
+    // Gather the longest run of due, same-tick, declared events with disjoint access sets.
+    // Cancelled entries met on the way stay in the batch (still Queued) and are released in
+    // order at commit, as the serial loop would.
+    batch_.clear();
+    claimed_.clear();
+    claimed_.try_claim(arena_.node(first.task).access);
+    batch_.push_back(first);
+    arena_.node(first.task).state = State::Running;
+
+    ScheduledEvent ev;
+    while (pop_due(now, ev))
+    {
+      auto& node = arena_.node(ev.task);
+      if (!node.cancelled)
+      {
+        if (ev.tick != first.tick || !node.has_access || node.access.exclusive || !claimed_.try_claim(node.access))
+        {
+          push(ev); // not part of this batch: back to the queue, where it is still the minimum
+          break;
+        }
+        node.state = State::Running;
+      }
+      batch_.push_back(ev);
+    }
+
+    // Workers reach their nodes through these pointers: the arena may grow under batch_mu_ while
+    // the batch runs, and chunks never move.
+    batch_nodes_.clear();
+    for (const auto& member : batch_) batch_nodes_.push_back(&arena_.node(member.task));
+    if (deferred_.size() < batch_.size()) deferred_.resize(batch_.size());
+    pool_->parallel_for(batch_.size(), [this](std::size_t i, unsigned) {
+      auto& node = *batch_nodes_[i];
+      if (node.state != State::Running) return;
+      t_batch_owner = this;
+      t_batch_ops = &deferred_[i];
+      t_batch_self = batch_[i].task;
+      t_batch_member = static_cast<std::uint32_t>(i);
+      if (node.task) node.task();
+      t_batch_owner = nullptr;
+    });
+    ++parallel_batches_;
+
+    // Commit in seq order: each member's buffered calls, then its own re-arm/release.
+    for (std::size_t i = 0; i < batch_.size(); ++i)
+    {
+      const auto& member = batch_[i];
+      if (arena_.node(member.task).state == State::Queued)
+      {
+        --cancelled_queued_;
+        arena_.release(member.task);
+        continue;
+      }
+      ++parallel_events_;
+      for (const auto& d : deferred_[i])
+      {
+        auto& node = arena_.node(d.handle.id);
+        if (d.cancel)
+        {
+          node.batch_cancel = EventArena::kNil;
+          cancel_now(d.handle);
+          continue;
+        }
+        node.entry = ScheduledEvent{node.entry.tick, next_seq_++, d.handle.id};
+        push(node.entry);
+        if (node.cancelled) ++cancelled_queued_; // cancelled by an earlier member before it was queued
+      }
+      deferred_[i].clear();
+      finish(member);
+    }
   }
 
   void Scheduler::run_due(Tick now)
   {
-    while (!q_.empty() && q_.top().tick <= now)
+    // Events may schedule more events; anything due by `now` still runs in this call.
+    ScheduledEvent ev;
+    while (pop_due(now, ev))
     {
-      auto ev = q_.top();
-      q_.pop();
-      if (ev.fn) ev.fn();
+      auto& node = arena_.node(ev.task);
+      if (node.cancelled)
+      {
+        --cancelled_queued_;
+        arena_.release(ev.task);
+        continue;
+      }
+
+      if (pool_ && pool_->size() > 1 && node.has_access && !node.access.exclusive)
+      {
+        run_batch(now, ev);
+        continue;
+      }
+
+      node.state = State::Running;
+      if (node.task) node.task();
+      finish(ev);
     }
   }
 
   std::size_t Scheduler::pending() const
   {
-    return q_.size();
+    const std::size_t queued = kind_ == EventQueue::TimingWheel ? wheel_.size() : heap_.size();
+    return queued - cancelled_queued_;
   }
 } // namespace rescueops::sim
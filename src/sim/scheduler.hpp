@@ -1,36 +1,136 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
-#include <functional>
-#include <queue>
+#include <limits>
+#include <mutex>
+#include <utility>
 #include <vector>
 
+#include "sim/event.hpp"
+#include "sim/event_access.hpp"
+#include "sim/event_arena.hpp"
+#include "sim/timing_wheel.hpp"
+
 namespace rescueops::sim
 {
-  using Tick = std::uint64_t;
+  class ThreadPool;
 
-  struct ScheduledEvent
+  // Pending-event containers. Both run events in (tick, seq) order: by tick, then FIFO.
+  //  - BinaryHeap: O(log n) per event, no assumptions about the tick distribution.
+  //  - TimingWheel: O(1) amortised when most events land within a few thousand ticks of now.
+  enum class EventQueue
   {
-    Tick tick{};
-    std::uint64_t seq{}; // tie-breaker for stable ordering
-    std::function<void()> fn;
-
-    // priority_queue puts "largest" first; we invert for min-heap behavior.
-    bool operator<(const ScheduledEvent& other) const
-    {
-      if (tick != other.tick) return tick > other.tick;
-      return seq > other.seq;
-    }
+    BinaryHeap,
+    TimingWheel,
   };
 
+  // Callables live in an EventArena owned by the scheduler; the heap orders small
+  // (tick, seq, task id) entries and the wheel links arena nodes directly. Once the arena and
+  // queue storage have grown to the peak pending count, schedule/run_due do no heap allocation.
   class Scheduler
   {
    public:
-    void schedule(Tick at, std::function<void()> fn);
+    static constexpr Tick kForever = std::numeric_limits<Tick>::max();
+
+    explicit Scheduler(EventQueue kind = EventQueue::BinaryHeap) : kind_(kind), wheel_(arena_) {}
+
+    // `fn` is any nothrow-movable void() callable of at most EventTask::kCapacity bytes.
+    template <class F>
+    EventHandle schedule(Tick at, F&& fn)
+    {
+      return add(at, 0, 0, nullptr, EventTask(std::forward<F>(fn)));
+    }
+
+    // Same, declaring what the event reads and writes (see set_thread_pool).
+    template <class F>
+    EventHandle schedule(Tick at, const EventAccess& access, F&& fn)
+    {
+      return add(at, 0, 0, &access, EventTask(std::forward<F>(fn)));
+    }
+
+    // Recurring event at phase, phase + period, ... up to and including `end`. One arena node is
+    // re-armed in place after each firing, so memory does not depend on the run length. Every
+    // occurrence keeps the seq taken here: the firing order is exactly that of scheduling all
+    // occurrences up front. Returns an empty handle (and schedules nothing) if phase > end.
+    template <class F>
+    EventHandle schedule_every(Tick period, Tick phase, F&& fn, Tick end = kForever)
+    {
+      if (period == 0 || phase > end) return EventHandle{};
+      return add(phase, period, end, nullptr, EventTask(std::forward<F>(fn)));
+    }
+
+    template <class F>
+    EventHandle schedule_every(Tick period, Tick phase, const EventAccess& access, F&& fn, Tick end = kForever)
+    {
+      if (period == 0 || phase > end) return EventHandle{};
+      return add(phase, period, end, &access, EventTask(std::forward<F>(fn)));
+    }
+
+    // Stops a pending event (every remaining occurrence of a periodic one). An event may cancel
+    // itself while running. Returns false if the handle no longer refers to a live event.
+    bool cancel(EventHandle handle);
+
+    // Parallel same-tick execution (nullptr, the default, runs everything serially).
+    // Consecutive due events of one tick that all declared an EventAccess and do not conflict
+    // form a batch that runs on `pool`. Their schedule()/cancel() calls are buffered and applied
+    // in (tick, seq) order afterwards, so seqs and results match the serial run exactly.
+    // Inside a batch, schedule() reserves the arena node at once and returns a working handle
+    // (arena ids may differ from the serial run), and cancel() returns what it would have in the
+    // serial run. Undeclared or exclusive events run alone. The pool must outlive its use here
+    // and must not be running another loop.
+    //
+    // Batch contract, checked in every build: an event must not schedule into an earlier tick
+    // (schedule() returns an empty handle and schedules nothing) or cancel another member of its
+    // batch (cancel() returns false). Two members cancelling the same event is also a violation
+    // when the later one got there first: its `true` cannot be taken back. Each violation counts
+    // in contract_violations().
+    void set_thread_pool(ThreadPool* pool) { pool_ = pool; }
+
     void run_due(Tick now);
+    // Events still to fire; a periodic event counts once.
     std::size_t pending() const;
 
+    EventQueue queue() const { return kind_; }
+    const EventArena& arena() const { return arena_; }
+
+    // Number of parallel batches run and events run in them, since construction.
+    std::size_t parallel_batches() const { return parallel_batches_; }
+    std::size_t parallel_events() const { return parallel_events_; }
+    std::size_t contract_violations() const { return violations_.load(std::memory_order_relaxed); }
+
    private:
-    std::priority_queue<ScheduledEvent> q_;
+    // schedule()/cancel() issued by an event of a running batch: a reserved node to queue, or a
+    // cancel to apply.
+    struct Deferred
+    {
+      bool cancel = false;
+      EventHandle handle;
+    };
+
+    EventHandle add(Tick at, Tick period, Tick end, const EventAccess* access, EventTask&& task);
+    void push(const ScheduledEvent& ev);
+    bool pop_due(Tick now, ScheduledEvent& out);
+    void finish(const ScheduledEvent& ev); // re-arm or release after running
+    void run_batch(Tick now, const ScheduledEvent& first);
+    bool cancel_now(EventHandle handle);
+    EventHandle add_in_batch(Tick at, Tick period, Tick end, const EventAccess* access, EventTask&& task);
+    bool cancel_in_batch(EventHandle handle);
+
+    EventQueue kind_;
+    EventArena arena_; // before wheel_, which links through it
+    std::vector<ScheduledEvent> heap_;
+    TimingWheel wheel_;
     std::uint64_t next_seq_ = 0;
+    std::size_t cancelled_queued_ = 0; // cancelled entries still sitting in a queue
+
+    ThreadPool* pool_ = nullptr;
+    ConflictSet claimed_;
+    std::vector<ScheduledEvent> batch_;
+    std::vector<EventArena::Node*> batch_nodes_; // looked up before the batch runs
+    std::vector<std::vector<Deferred>> deferred_; // per batch member, storage reused
+    std::mutex batch_mu_;                          // guards the arena while a batch runs
+    std::size_t parallel_batches_ = 0;
+    std::size_t parallel_events_ = 0;
+    std::atomic<std::size_t> violations_{0};
   };
 } // namespace rescueops::sim
@@ -0,0 +1,124 @@
+#include "sim/spatial_index.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rescueops::sim
+{
+  SpatialIndex::SpatialIndex(int cell_size)
+  {
+    shift_ = 0;
+    while ((1 << shift_) < cell_size && shift_ < 30) ++shift_;
+  }
+
+  std::uint32_t SpatialIndex::cell_index(int x, int y) const
+  {
+    const int cx = std::clamp(x, 0, width_ - 1) >> shift_;
+    const int cy = std::clamp(y, 0, height_ - 1) >> shift_;
+    return static_cast<std::uint32_t>(cy) * static_cast<std::uint32_t>(cols_) + static_cast<std::uint32_t>(cx);
+  }
+
+  void SpatialIndex::build(const UnitTable& units, int width, int height)
+  {
+    units_ = &units;
+    width_ = std::max(1, width);
+    height_ = std::max(1, height);
+    cols_ = ((width_ - 1) >> shift_) + 1;
+    rows_ = ((height_ - 1) >> shift_) + 1;
+    cells_.resize(static_cast<std::size_t>(cols_) * static_cast<std::size_t>(rows_));
+    for (auto& c : cells_) c.clear(); // keeps bucket capacity across rebuilds
+    moves_ = 0;
+
+    const auto xs = units.x();
+    const auto ys = units.y();
+    cell_of_.resize(units.size());
+    slot_of_.resize(units.size());
+    for (std::size_t i = 0; i < units.size(); ++i)
+    {
+      auto& cell = cells_[cell_of_[i] = cell_index(xs[i], ys[i])];
+      slot_of_[i] = static_cast<std::uint32_t>(cell.size());
+      cell.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+
+  void SpatialIndex::update()
+  {
+    if (!units_) return;
+    const auto xs = units_->x();
+    const auto ys = units_->y();
+    for (std::size_t i = 0; i < cell_of_.size(); ++i)
+    {
+      const std::uint32_t to = cell_index(xs[i], ys[i]);
+      const std::uint32_t from = cell_of_[i];
+      if (to == from) continue;
+
+      // Buckets are unordered (queries sort), so removal moves the last entry into the hole.
+      auto& old_cell = cells_[from];
+      const std::uint32_t last = old_cell.back();
+      old_cell[slot_of_[i]] = last;
+      slot_of_[last] = slot_of_[i];
+      old_cell.pop_back();
+
+      auto& new_cell = cells_[to];
+      slot_of_[i] = static_cast<std::uint32_t>(new_cell.size());
+      new_cell.push_back(static_cast<std::uint32_t>(i));
+      cell_of_[i] = to;
+      ++moves_;
+    }
+  }
+
+  template <class F>
+  void SpatialIndex::for_each_in_cells(Vec2i lo, Vec2i hi, F&& fn) const
+  {
+    if (!units_ || lo.x > hi.x || lo.y > hi.y) return;
+    // Clamping (not skipping) out-of-world ranges visits the border cells, which also hold any
+    // units positioned outside the world.
+    const int cx0 = std::clamp(lo.x, 0, width_ - 1) >> shift_;
+    const int cy0 = std::clamp(lo.y, 0, height_ - 1) >> shift_;
+    const int cx1 = std::clamp(hi.x, 0, width_ - 1) >> shift_;
+    const int cy1 = std::clamp(hi.y, 0, height_ - 1) >> shift_;
+    for (int cy = cy0; cy <= cy1; ++cy)
+    {
+      for (int cx = cx0; cx <= cx1; ++cx)
+      {
+        for (const auto row : cells_[static_cast<std::size_t>(cy) * static_cast<std::size_t>(cols_) +
+                                     static_cast<std::size_t>(cx)])
+          fn(row);
+      }
+    }
+  }
+
+  void SpatialIndex::query_radius(Vec2i c, int r, std::vector<std::uint32_t>& out) const
+  {
+    out.clear();
+    if (r < 0) return;
+    const auto xs = units_ ? units_->x() : std::span<const int>{};
+    const auto ys = units_ ? units_->y() : std::span<const int>{};
+    const long long r2 = static_cast<long long>(r) * r;
+    const auto box = [](long long v) {
+      return static_cast<int>(std::clamp<long long>(v, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    };
+    const Vec2i lo{box(static_cast<long long>(c.x) - r), box(static_cast<long long>(c.y) - r)};
+    const Vec2i hi{box(static_cast<long long>(c.x) + r), box(static_cast<long long>(c.y) + r)};
+    for_each_in_cells(lo, hi, [&](std::uint32_t row) {
+      // Widened before subtracting; outside the box (units off the world sit in border cells)
+      // is rejected first, which also keeps the squares below 2^63.
+      const long long dx = static_cast<long long>(xs[row]) - c.x;
+      const long long dy = static_cast<long long>(ys[row]) - c.y;
+      if (dx < -r || dx > r || dy < -r || dy > r) return;
+      if (dx * dx + dy * dy <= r2) out.push_back(row);
+    });
+    std::sort(out.begin(), out.end());
+  }
+
+  void SpatialIndex::query_rect(Vec2i lo, Vec2i hi, std::vector<std::uint32_t>& out) const
+  {
+    out.clear();
+    const auto xs = units_ ? units_->x() : std::span<const int>{};
+    const auto ys = units_ ? units_->y() : std::span<const int>{};
+    for_each_in_cells(lo, hi, [&](std::uint32_t row) {
+      if (xs[row] >= lo.x && xs[row] <= hi.x && ys[row] >= lo.y && ys[row] <= hi.y) out.push_back(row);
+    });
+    std::sort(out.begin(), out.end());
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "sim/world.hpp"
+
+namespace rescueops::sim
+{
+  // Uniform-grid index over the unit positions of a UnitTable, for proximity queries.
+  // Cells are square with a power-of-two side; each holds the rows of the units inside it.
+  // update() re-buckets only the units whose cell changed since the last build()/update(), so
+  // keeping the index current costs one compare per unit plus the (few) cell changes.
+  // Query results are unit rows in ascending order, independent of the history of updates.
+  // Positions outside the world are treated as in the nearest border cell.
+  class SpatialIndex
+  {
+   public:
+    // `cell_size` is rounded up to a power of two (at least 1).
+    explicit SpatialIndex(int cell_size = 8);
+
+    // Indexes every unit of `units`; the table must outlive the index (or the next build()).
+    void build(const UnitTable& units, int width, int height);
+    // Re-buckets units that changed cell. The table must be the one passed to build() and must
+    // not have gained or lost rows since.
+    void update();
+
+    // Rows of the units with (x - c.x)^2 + (y - c.y)^2 <= r^2, ascending. Replaces `out`.
+    void query_radius(Vec2i c, int r, std::vector<std::uint32_t>& out) const;
+    // Rows of the units with lo.x <= x <= hi.x and lo.y <= y <= hi.y, ascending. Replaces `out`.
+    void query_rect(Vec2i lo, Vec2i hi, std::vector<std::uint32_t>& out) const;
+
+    int cell_size() const { return 1 << shift_; }
+    std::size_t size() const { return cell_of_.size(); }
+    // Cell changes applied by update() since build().
+    std::size_t moves() const { return moves_; }
+
+   private:
+    std::uint32_t cell_index(int x, int y) const;
+    // Calls fn(row) for every unit in the cells overlapping [lo, hi] (clipped to the world).
+    template <class F>
+    void for_each_in_cells(Vec2i lo, Vec2i hi, F&& fn) const;
+
+    int shift_ = 3;
+    int width_ = 0;
+    int height_ = 0;
+    int cols_ = 0;
+    int rows_ = 0;
+    const UnitTable* units_ = nullptr;
+    std::vector<std::vector<std::uint32_t>> cells_;
+    std::vector<std::uint32_t> cell_of_; // per unit row
+    std::vector<std::uint32_t> slot_of_; // per unit row: position in its cell's bucket
+    std::size_t moves_ = 0;
+  };
+} // namespace rescueops::sim
@@ -0,0 +1,74 @@
+#include "sim/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace rescueops::sim
+{
+  ThreadPool::ThreadPool(unsigned threads)
+  {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_ = threads;
+    threads_.reserve(size_ - 1);
+    for (unsigned w = 1; w < size_; ++w) threads_.emplace_back([this, w] { worker_loop(w); });
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+  }
+
+  void ThreadPool::drain(unsigned worker)
+  {
+    for (std::size_t i = next_++; i < n_; i = next_++) (*fn_)(i, worker);
+  }
+
+  void ThreadPool::worker_loop(unsigned worker)
+  {
+    std::uint64_t seen = 0;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+      }
+
+      drain(worker);
+
+      std::lock_guard<std::mutex> lock(mu_);
+      if (--busy_ == 0) done_.notify_one();
+    }
+  }
+
+  void ThreadPool::parallel_for(std::size_t n, const std::function<void(std::size_t, unsigned)>& fn)
+  {
+    if (n == 0) return;
+    if (threads_.empty() || n == 1)
+    {
+      for (std::size_t i = 0; i < n; ++i) fn(i, 0);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      fn_ = &fn;
+      n_ = n;
+      next_ = 0;
+      busy_ = static_cast<unsigned>(threads_.size());
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mu_);
+    done_.wait(lock, [&] { return busy_ == 0; });
+    fn_ = nullptr;
+  }
+} // namespace rescueops::sim
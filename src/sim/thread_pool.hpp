@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rescueops::sim
+{
+  // Fixed-size worker pool for data-parallel loops.
+  // The calling thread takes part in every loop, so a pool of size 1 starts no threads and runs
+  // inline. Work is handed out by an atomic index, which only affects *who* runs an item, never
+  // where its result goes: callers write results into per-item slots to stay deterministic.
+  class ThreadPool
+  {
+   public:
+    // `threads` = total participants including the caller; 0 = hardware concurrency.
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return size_; }
+
+    // Calls fn(i, worker) for every i in [0, n) and blocks until all calls returned.
+    // `worker` is in [0, size()) and identifies the executing thread (for per-thread scratch).
+    // Not reentrant: fn must not call parallel_for on the same pool.
+    void parallel_for(std::size_t n, const std::function<void(std::size_t, unsigned)>& fn);
+
+   private:
+    void worker_loop(unsigned worker);
+    void drain(unsigned worker);
+
+    unsigned size_ = 1;
+    std::vector<std::thread> threads_;
+
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    unsigned busy_ = 0;
+    bool stop_ = false;
+
+    const std::function<void(std::size_t, unsigned)>* fn_ = nullptr;
+    std::size_t n_ = 0;
+    std::atomic<std::size_t> next_{0};
+  };
+} // namespace rescueops::sim
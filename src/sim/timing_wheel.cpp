@@ -0,0 +1,155 @@
+#include "sim/timing_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace rescueops::sim
+{
+  void TimingWheel::push(const ScheduledEvent& ev)
+  {
+    place(ev);
+  }
+
+  void TimingWheel::place(const ScheduledEvent& ev)
+  {
+    const Tick diff = ev.tick ^ now_;
+    if (ev.tick < now_ || (diff >> (kLevels * kSlotBits)) != 0)
+    {
+      heap_.push_back(ev);
+      std::push_heap(heap_.begin(), heap_.end());
+      return;
+    }
+
+    int level = 0;
+    while ((diff >> ((level + 1) * kSlotBits)) != 0) ++level;
+    auto& lv = levels_[static_cast<std::size_t>(level)];
+    const auto slot = static_cast<std::size_t>((ev.tick >> (level * kSlotBits)) & (kSlots - 1));
+    auto& list = lv.slots[slot];
+    ++wheel_count_;
+    if (list.tail == EventArena::kNil)
+    {
+      arena_.next(ev.task) = EventArena::kNil;
+      list.head = list.tail = ev.task;
+      mark(lv, slot, true);
+      return;
+    }
+    if (arena_.entry(list.tail).seq < ev.seq)
+    {
+      arena_.next(ev.task) = EventArena::kNil;
+      arena_.next(list.tail) = ev.task;
+      list.tail = ev.task;
+      return;
+    }
+
+    // Out of seq order: only a re-armed periodic event, which keeps its original seq.
+    std::uint32_t* link = &list.head;
+    while (arena_.entry(*link).seq < ev.seq) link = &arena_.next(*link);
+    arena_.next(ev.task) = *link;
+    *link = ev.task;
+  }
+
+  void TimingWheel::mark(Level& level, std::size_t slot, bool on)
+  {
+    const std::uint64_t bit = std::uint64_t{1} << (slot % 64);
+    if (on)
+      level.occupied[slot / 64] |= bit;
+    else
+      level.occupied[slot / 64] &= ~bit;
+  }
+
+  int TimingWheel::first_occupied(const Level& level, std::size_t from)
+  {
+    for (std::size_t w = from / 64; w < level.occupied.size(); ++w)
+    {
+      std::uint64_t bits = level.occupied[w];
+      if (w == from / 64) bits &= ~std::uint64_t{0} << (from % 64);
+      if (bits) return static_cast<int>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+    }
+    return -1;
+  }
+
+  void TimingWheel::advance_to(Tick t)
+  {
+    const Tick old = now_;
+    now_ = t;
+    // Top-down, so a cascade from level l refills the level l-1 slot that is cascaded next.
+    for (int level = kLevels - 1; level >= 1; --level)
+    {
+      const int shift = level * kSlotBits;
+      if ((t >> shift) == (old >> shift)) continue;
+      auto& lv = levels_[static_cast<std::size_t>(level)];
+      const auto slot = static_cast<std::size_t>((t >> shift) & (kSlots - 1));
+      const std::uint32_t head = lv.slots[slot].head;
+      if (head == EventArena::kNil) continue;
+
+      // Cascaded events always land on lower levels, never back in this slot.
+      lv.slots[slot] = Slot{};
+      mark(lv, slot, false);
+      for (std::uint32_t id = head; id != EventArena::kNil;)
+      {
+        const std::uint32_t next = arena_.next(id);
+        --wheel_count_;
+        place(arena_.entry(id));
+        id = next;
+      }
+    }
+  }
+
+  const ScheduledEvent* TimingWheel::next_wheel_event(Tick limit)
+  {
+    if (now_ > limit) return nullptr; // the cursor only holds ticks >= now_
+    if (current_slot().head != EventArena::kNil) return &arena_.entry(current_slot().head);
+
+    // Jump to the next occupied slot: exact tick on level 0, start of a block on higher levels
+    // (entering the block cascades it, then look again).
+    while (wheel_count_ > 0)
+    {
+      Tick next = 0;
+      bool found = false;
+      for (int level = 0; level < kLevels && !found; ++level)
+      {
+        const int shift = level * kSlotBits;
+        const auto cur = static_cast<std::size_t>((now_ >> shift) & (kSlots - 1));
+        const int slot = first_occupied(levels_[static_cast<std::size_t>(level)], level == 0 ? cur : cur + 1);
+        if (slot < 0) continue;
+        const int upper = shift + kSlotBits;
+        next = ((now_ >> upper) << upper) | (static_cast<Tick>(slot) << shift);
+        found = true;
+      }
+      if (!found || next > limit) break;
+      advance_to(next);
+      if (current_slot().head != EventArena::kNil) return &arena_.entry(current_slot().head);
+    }
+
+    // Nothing due up to `limit`: move the cursor past it so later pushes for ticks <= limit are
+    // treated as late and ordered through the heap.
+    if (limit != std::numeric_limits<Tick>::max() && now_ <= limit) advance_to(limit + 1);
+    return nullptr;
+  }
+
+  bool TimingWheel::pop_due(Tick now, ScheduledEvent& out)
+  {
+    const ScheduledEvent* wheel = next_wheel_event(now);
+    const bool heap_due = !heap_.empty() && heap_.front().tick <= now;
+    if (heap_due && (!wheel || *wheel < heap_.front()))
+    {
+      std::pop_heap(heap_.begin(), heap_.end());
+      out = heap_.back();
+      heap_.pop_back();
+      return true;
+    }
+    if (!wheel) return false;
+
+    out = *wheel;
+    Slot& slot = current_slot();
+    slot.head = arena_.next(slot.head);
+    if (slot.head == EventArena::kNil)
+    {
+      slot.tail = EventArena::kNil;
+      mark(levels_[0], static_cast<std::size_t>(now_ & (kSlots - 1)), false);
+    }
+    --wheel_count_;
+    return true;
+  }
+} // namespace rescueops::sim
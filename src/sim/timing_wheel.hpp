@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "sim/event.hpp"
+#include "sim/event_arena.hpp"
+
+namespace rescueops::sim
+{
+  // Hierarchical timing wheel over integer ticks: 4 levels of 256 slots (2^32-tick horizon).
+  // An event lands on the level of the highest 8-bit digit where its tick differs from the
+  // cursor; when the cursor enters a new slot of a higher level, that slot is cascaded into the
+  // levels below. Level-0 slots therefore hold exactly one tick, in scheduling (seq) order.
+  // Events beyond the horizon, or behind the cursor, go to a small (tick, seq) heap that
+  // pop_due() merges with the wheel, so the pop order is exactly that of a priority queue.
+  // schedule and pop are O(1) amortised; empty stretches are skipped through slot bitmaps.
+  // Slots are seq-ordered lists threaded through the arena's node links: the wheel never
+  // allocates. Pushes arrive in seq order except re-armed periodic events, which are inserted.
+  class TimingWheel
+  {
+   public:
+    explicit TimingWheel(EventArena& arena) : arena_(arena) {}
+
+    // `ev.task` must be an arena node whose entry() equals `ev`.
+    void push(const ScheduledEvent& ev);
+
+    // Removes the earliest event with tick <= now (ties by seq) and copies its entry to `out`.
+    bool pop_due(Tick now, ScheduledEvent& out);
+
+    std::size_t size() const { return wheel_count_ + heap_.size(); }
+
+   private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+
+    struct Slot
+    {
+      std::uint32_t head = EventArena::kNil;
+      std::uint32_t tail = EventArena::kNil;
+    };
+
+    struct Level
+    {
+      std::array<Slot, kSlots> slots;
+      std::array<std::uint64_t, kSlots / 64> occupied{}; // bit per non-empty slot
+    };
+
+    void place(const ScheduledEvent& ev);
+    const ScheduledEvent* next_wheel_event(Tick limit);
+    void advance_to(Tick t);
+    void mark(Level& level, std::size_t slot, bool on);
+    static int first_occupied(const Level& level, std::size_t from);
+    Slot& current_slot() { return levels_[0].slots[static_cast<std::size_t>(now_ & (kSlots - 1))]; }
+
+    EventArena& arena_;
+    std::array<Level, kLevels> levels_;
+    std::vector<ScheduledEvent> heap_; // beyond the horizon or behind the cursor
+    Tick now_ = 0;                     // cursor: every tick below it has been drained from the wheel
+    std::size_t wheel_count_ = 0;
+  };
+} // namespace rescueops::sim
@@ -0,0 +1,476 @@
+#include "sim/trajectory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "sim/binary_io.hpp"
+
+namespace rescueops::sim
+{
+  namespace
+  {
+    constexpr std::string_view kMagic = "RSOPTRAJ";
+    constexpr std::string_view kIndexMagic = "RSOPTIDX";
+    constexpr std::uint32_t kChunkMagic = 0x4b435254; // "TRCK"
+    constexpr std::size_t kHeaderBytes = 16;
+    constexpr std::size_t kChunkHeaderBytes = 40;
+    constexpr std::size_t kIndexEntryBytes = 24;
+    constexpr std::size_t kFooterBytes = 24;
+
+    bool fail(std::string* error, const std::string& what)
+    {
+      if (error) *error = what;
+      return false;
+    }
+
+    std::uint64_t zigzag(std::int64_t v)
+    {
+      return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t v)
+    {
+      return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    void put_varint(std::string& out, std::uint64_t v)
+    {
+      while (v >= 0x80)
+      {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+      }
+      out.push_back(static_cast<char>(v));
+    }
+
+    // 2-bit code of a coordinate change; 3 means the delta follows as an escape varint.
+    std::uint8_t delta_code(std::int64_t d)
+    {
+      return d == 0 ? 0 : d == 1 ? 1 : d == -1 ? 2 : 3;
+    }
+
+    // Bounds-checked reads from a chunk payload; a bad read clears ok.
+    struct PayloadReader
+    {
+      const unsigned char* p;
+      const unsigned char* end;
+      bool ok = true;
+
+      std::uint64_t varint()
+      {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+          if (p == end) break;
+          const unsigned char b = *p++;
+          v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+          if ((b & 0x80) == 0) return v;
+        }
+        ok = false;
+        return 0;
+      }
+
+      const unsigned char* take(std::size_t n)
+      {
+        if (static_cast<std::size_t>(end - p) < n)
+        {
+          ok = false;
+          return nullptr;
+        }
+        const unsigned char* q = p;
+        p += n;
+        return q;
+      }
+    };
+
+    // Bytes of one column of 2-bit codes; each column starts on a byte.
+    std::size_t column_bytes(std::size_t units)
+    {
+      return (units + 3) / 4;
+    }
+
+    // Deltas of the four codes of a byte, for bytes without an escape code.
+    struct CodeDeltas
+    {
+      std::int8_t d[256][4];
+      constexpr CodeDeltas() : d{}
+      {
+        for (int b = 0; b < 256; ++b)
+          for (int j = 0; j < 4; ++j)
+          {
+            const int c = (b >> (2 * j)) & 3;
+            d[b][j] = static_cast<std::int8_t>(c == 1 ? 1 : c == 2 ? -1 : 0);
+          }
+      }
+    };
+    constexpr CodeDeltas kCodeDeltas;
+
+    bool has_escape(unsigned char b)
+    {
+      return (b & (b >> 1) & 0x55) != 0;
+    }
+  } // namespace
+
+  // ------------------------------------------------------------------ recorder
+
+  TrajectoryRecorder::~TrajectoryRecorder()
+  {
+    if (open_) close();
+  }
+
+  bool TrajectoryRecorder::open(const std::string& path, const TrajectoryOptions& options, std::string* error)
+  {
+    if (open_) close();
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) return fail(error, "cannot write " + path);
+
+    options_ = options;
+    options_.chunk_frames = std::max<std::uint32_t>(1, options_.chunk_frames);
+    open_ = true;
+    frames_ = 0;
+    offset_ = 0;
+    index_.clear();
+    chunk_frames_ = 0;
+    stop_ = false;
+    failed_ = false;
+    queued_bytes_ = 0;
+
+    BinaryWriter header;
+    header.bytes(kMagic);
+    header.u32(kTrajectoryVersion);
+    header.u32(options_.chunk_frames);
+    offset_ = header.size();
+    out_.write(header.data().data(), static_cast<std::streamsize>(header.size()));
+    if (options_.background) writer_ = std::thread([this] { writer_loop(); });
+    return true;
+  }
+
+  void TrajectoryRecorder::record(Tick frame, const UnitTable& units)
+  {
+    if (!open_ || (frames_ > 0 && frame <= last_frame_)) return;
+
+    const auto xs = units.x();
+    const auto ys = units.y();
+    const auto ids = units.ids();
+    const std::size_t n = xs.size();
+    const bool continues = chunk_frames_ > 0 && chunk_frames_ < options_.chunk_frames && frame == last_frame_ + 1 &&
+                           n == prev_x_.size() &&
+                           (n == 0 || std::memcmp(ids.data(), prev_ids_.data(), n * sizeof(std::uint32_t)) == 0);
+    last_frame_ = frame;
+    ++frames_;
+    if (!continues)
+    {
+      if (chunk_frames_ > 0) finish_chunk();
+      begin_chunk(frame, units);
+      return;
+    }
+
+    // Delta frame: the x codes, then the y codes, then the escapes.
+    const std::size_t base = payload_.size();
+    const std::size_t cb = column_bytes(n);
+    payload_.resize(base + 2 * cb);
+    auto* codes = reinterpret_cast<unsigned char*>(payload_.data() + base);
+    escapes_.clear();
+    const auto column = [&](std::span<const int> now, std::vector<int>& prev, unsigned char* out) {
+      for (std::size_t i = 0; i < n; i += 4)
+      {
+        unsigned b = 0;
+        for (std::size_t j = 0; j < 4 && i + j < n; ++j)
+        {
+          const std::int64_t d = static_cast<std::int64_t>(now[i + j]) - prev[i + j];
+          const std::uint8_t c = delta_code(d);
+          if (c == 3) escapes_.push_back(d);
+          b |= static_cast<unsigned>(c) << (2 * j);
+          prev[i + j] = now[i + j];
+        }
+        out[i / 4] = static_cast<unsigned char>(b);
+      }
+    };
+    column(xs, prev_x_, codes);
+    column(ys, prev_y_, codes + cb);
+    for (const auto d : escapes_) put_varint(payload_, zigzag(d));
+    ++chunk_frames_;
+  }
+
+  void TrajectoryRecorder::begin_chunk(Tick frame, const UnitTable& units)
+  {
+    payload_.clear();
+    const auto ids = units.ids();
+    const auto xs = units.x();
+    const auto ys = units.y();
+    prev_ids_.assign(ids.begin(), ids.end());
+    prev_x_.assign(xs.begin(), xs.end());
+    prev_y_.assign(ys.begin(), ys.end());
+
+    std::int64_t prev = 0;
+    for (const auto id : ids)
+    {
+      put_varint(payload_, zigzag(static_cast<std::int64_t>(id) - prev));
+      prev = id;
+    }
+    for (const auto x : xs) put_varint(payload_, zigzag(x));
+    for (const auto y : ys) put_varint(payload_, zigzag(y));
+    chunk_first_ = frame;
+    chunk_frames_ = 1;
+  }
+
+  void TrajectoryRecorder::finish_chunk()
+  {
+    BinaryWriter w;
+    w.u32(kChunkMagic);
+    w.u32(static_cast<std::uint32_t>(chunk_frames_));
+    w.u64(chunk_first_);
+    w.u64(prev_x_.size());
+    w.u64(payload_.size());
+    w.u64(fnv1a64(payload_));
+    w.bytes(payload_);
+    index_.push_back(IndexEntry{chunk_first_, chunk_frames_, offset_});
+    offset_ += w.size();
+    chunk_frames_ = 0;
+    submit(w.take());
+  }
+
+  void TrajectoryRecorder::submit(std::string bytes)
+  {
+    if (!options_.background)
+    {
+      out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      if (!out_) failed_ = true;
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mu_);
+    drained_.wait(lock, [&] { return queued_bytes_ <= options_.max_pending_bytes || failed_; });
+    queued_bytes_ += bytes.size();
+    queue_.push_back(std::move(bytes));
+    lock.unlock();
+    wake_.notify_one();
+  }
+
+  void TrajectoryRecorder::writer_loop()
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true)
+    {
+      wake_.wait(lock, [&] { return !queue_.empty() || stop_; });
+      if (queue_.empty()) break;
+      std::string bytes = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      const bool ok = static_cast<bool>(out_);
+      lock.lock();
+      queued_bytes_ -= bytes.size();
+      if (!ok) failed_ = true;
+      drained_.notify_all();
+    }
+  }
+
+  bool TrajectoryRecorder::close(std::string* error)
+  {
+    if (!open_) return fail(error, "trajectory recorder is not open");
+    if (chunk_frames_ > 0) finish_chunk();
+
+    BinaryWriter w;
+    for (const auto& e : index_)
+    {
+      w.u64(e.first_frame);
+      w.u64(e.frames);
+      w.u64(e.offset);
+    }
+    w.u64(index_.size());
+    w.u64(offset_);
+    w.bytes(kIndexMagic);
+    offset_ += w.size();
+    submit(w.take());
+
+    if (writer_.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+      }
+      wake_.notify_one();
+      writer_.join();
+    }
+    out_.close();
+    open_ = false;
+    if (failed_ || !out_) return fail(error, "failed to write the trajectory file");
+    return true;
+  }
+
+  // ------------------------------------------------------------------ reader
+
+  bool TrajectoryReader::open(const std::string& path, std::string* error)
+  {
+    *this = TrajectoryReader{};
+    if (!file_.open(path)) return fail(error, "cannot map " + path);
+    const std::string_view data = file_.view();
+    if (data.size() < kHeaderBytes || data.substr(0, kMagic.size()) != kMagic)
+      return fail(error, "not a trajectory file");
+    BinaryReader header(data.substr(kMagic.size(), 8));
+    const auto version = header.u32();
+    if (version != kTrajectoryVersion) return fail(error, "unsupported trajectory version " + std::to_string(version));
+
+    // Parses the chunk frame at `offset`; false unless a whole chunk is there.
+    const auto chunk_at = [&](std::size_t offset, Chunk& c, std::uint64_t& checksum) {
+      if (offset > data.size() || data.size() - offset < kChunkHeaderBytes) return false;
+      BinaryReader r(data.substr(offset, kChunkHeaderBytes));
+      if (r.u32() != kChunkMagic) return false;
+      c.frames = r.u32();
+      c.first_frame = r.u64();
+      c.units = r.u64();
+      const auto bytes = r.u64();
+      checksum = r.u64();
+      c.payload = offset + kChunkHeaderBytes;
+      if (c.frames == 0 || bytes > data.size() - c.payload) return false;
+      c.payload_bytes = static_cast<std::size_t>(bytes);
+      return true;
+    };
+
+    // A closed file ends with the index; its chunks are checksummed when first decoded.
+    if (data.size() >= kHeaderBytes + kFooterBytes && data.substr(data.size() - kIndexMagic.size()) == kIndexMagic)
+    {
+      BinaryReader footer(data.substr(data.size() - kFooterBytes, 16));
+      const auto count = footer.u64();
+      const auto index_offset = footer.u64();
+      if (index_offset < kHeaderBytes || index_offset > data.size() - kFooterBytes ||
+          count != (data.size() - kFooterBytes - index_offset) / kIndexEntryBytes ||
+          (data.size() - kFooterBytes - index_offset) % kIndexEntryBytes != 0)
+        return fail(error, "corrupt trajectory index");
+      BinaryReader r(data.substr(static_cast<std::size_t>(index_offset)));
+      for (std::uint64_t i = 0; i < count; ++i)
+      {
+        const auto first = r.u64();
+        const auto frames = r.u64();
+        const auto offset = r.u64();
+        Chunk c;
+        std::uint64_t checksum = 0;
+        if (!chunk_at(static_cast<std::size_t>(std::min<std::uint64_t>(offset, data.size())), c, checksum) ||
+            c.first_frame != first || c.frames != frames || c.payload + c.payload_bytes > index_offset)
+          return fail(error, "trajectory index does not match chunk " + std::to_string(i));
+        chunks_.push_back(c);
+      }
+      indexed_ = true;
+    }
+    else
+    {
+      // No index: keep every complete chunk up to the first damaged or missing one.
+      std::size_t offset = kHeaderBytes;
+      Chunk c;
+      std::uint64_t checksum = 0;
+      while (chunk_at(offset, c, checksum) &&
+             fnv1a64(data.substr(c.payload, c.payload_bytes)) == checksum)
+      {
+        chunks_.push_back(c);
+        offset = c.payload + c.payload_bytes;
+      }
+    }
+
+    for (std::size_t i = 1; i < chunks_.size(); ++i)
+      if (chunks_[i].first_frame < chunks_[i - 1].first_frame + chunks_[i - 1].frames)
+        return fail(error, "trajectory chunks out of order");
+    return true;
+  }
+
+  const TrajectoryReader::Chunk* TrajectoryReader::find(Tick frame) const
+  {
+    // Last chunk starting at or before `frame`.
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), frame,
+                               [](Tick f, const Chunk& c) { return f < c.first_frame; });
+    if (it == chunks_.begin()) return nullptr;
+    --it;
+    return frame < it->first_frame + it->frames ? &*it : nullptr;
+  }
+
+  bool TrajectoryReader::has_frame(Tick frame) const
+  {
+    return find(frame) != nullptr;
+  }
+
+  Tick TrajectoryReader::first_frame() const
+  {
+    return chunks_.empty() ? 0 : chunks_.front().first_frame;
+  }
+
+  Tick TrajectoryReader::last_frame() const
+  {
+    return chunks_.empty() ? 0 : chunks_.back().first_frame + chunks_.back().frames - 1;
+  }
+
+  bool TrajectoryReader::read_frame(Tick frame,
+                                    std::vector<std::uint32_t>& ids,
+                                    std::vector<int>& x,
+                                    std::vector<int>& y) const
+  {
+    const Chunk* c = find(frame);
+    if (!c) return false;
+    const auto* base = reinterpret_cast<const unsigned char*>(file_.data()) + c->payload;
+    const std::size_t n = static_cast<std::size_t>(c->units);
+    const auto invalid = [&] {
+      cur_chunk_ = nullptr;
+      return false;
+    };
+
+    if (cur_chunk_ != c || frame < cur_frame_)
+    {
+      const std::string_view payload(file_.data() + c->payload, c->payload_bytes);
+      BinaryReader header(file_.view().substr(c->payload - 8, 8));
+      if (fnv1a64(payload) != header.u64() || n > c->payload_bytes / 3) return invalid();
+      PayloadReader r{base, base + c->payload_bytes};
+      cur_ids_.resize(n);
+      cur_x_.resize(n);
+      cur_y_.resize(n);
+      std::int64_t prev = 0;
+      for (auto& id : cur_ids_)
+      {
+        prev += unzigzag(r.varint());
+        id = static_cast<std::uint32_t>(prev);
+      }
+      for (auto& v : cur_x_) v = static_cast<int>(unzigzag(r.varint()));
+      for (auto& v : cur_y_) v = static_cast<int>(unzigzag(r.varint()));
+      if (!r.ok) return invalid();
+      cur_chunk_ = c;
+      cur_frame_ = c->first_frame;
+      cur_pos_ = static_cast<std::size_t>(r.p - base);
+    }
+
+    PayloadReader r{base + cur_pos_, base + c->payload_bytes};
+    const std::size_t cb = column_bytes(n);
+    const std::size_t whole = n / 4;
+    for (; cur_frame_ < frame; ++cur_frame_)
+    {
+      const unsigned char* codes = r.take(2 * cb);
+      if (!r.ok) return invalid();
+      // Four units per code byte; bytes with an escape (and the tail) go code by code.
+      const auto column = [&](int* v, const unsigned char* col) {
+        for (std::size_t q = 0; q < cb; ++q)
+        {
+          const unsigned char b = col[q];
+          int* u = v + 4 * q;
+          if (q < whole && !has_escape(b))
+          {
+            for (int j = 0; j < 4; ++j) u[j] += kCodeDeltas.d[b][j];
+            continue;
+          }
+          for (std::size_t j = 0; j < 4 && 4 * q + j < n; ++j)
+          {
+            const unsigned c = (b >> (2 * j)) & 3u;
+            u[j] = c == 3 ? static_cast<int>(u[j] + unzigzag(r.varint())) : u[j] + kCodeDeltas.d[c][0];
+          }
+        }
+      };
+      column(cur_x_.data(), codes);
+      column(cur_y_.data(), codes + cb);
+      if (!r.ok) return invalid();
+    }
+    cur_pos_ = static_cast<std::size_t>(r.p - base);
+
+    ids = cur_ids_;
+    x = cur_x_;
+    y = cur_y_;
+    return true;
+  }
+} // namespace rescueops::sim
@@ -0,0 +1,156 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/mapped_file.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+
+namespace rescueops::sim
+{
+  // Trajectory file: the position of every unit at every recorded frame. Frame f is the world
+  // after f ticks, so frame 0 holds the initial positions and a run to tick T ends at frame T.
+  //
+  // Little-endian. A 16-byte header: "RSOPTRAJ", u32 version, u32 frames per chunk. Then chunks,
+  // each framed as
+  //   u32 "TRCK"  u32 frames  u64 first frame  u64 units  u64 payload bytes  u64 FNV-1a(payload)
+  // and a self-contained payload:
+  //   ids       one zigzag varint per unit: id minus the previous unit's id (the first minus 0)
+  //   keyframe  x then y of every unit at the first frame, zigzag varints
+  //   deltas    for each later frame: the x column then the y column as 2-bit codes per unit
+  //             (0: unchanged, 1: +1, 2: -1, 3: escape), packed 4 to a byte, low bits first,
+  //             (units + 3) / 4 bytes per column; then the escaped deltas, in the same order,
+  //             as zigzag varints
+  // The file ends with an index of {u64 first frame, u64 frames, u64 offset} per chunk, then
+  // u64 chunk count, u64 index offset and "RSOPTIDX". A file cut short (the writer did not
+  // close) has no index; readers then recover every complete chunk by walking the frames.
+  inline constexpr std::uint32_t kTrajectoryVersion = 1;
+
+  struct TrajectoryOptions
+  {
+    std::uint32_t chunk_frames = 256; // frames per chunk: the most a seek has to decode
+    // Write finished chunks from a dedicated thread, so record() only encodes. record() waits
+    // only if more than max_pending_bytes of chunks are queued (the disk is falling behind).
+    bool background = false;
+    std::size_t max_pending_bytes = 64u << 20;
+  };
+
+  // Encodes frames into chunks and writes them to a trajectory file. Attach one to an Engine
+  // (Engine::set_trajectory_recorder) to record every tick of run(), or call record() directly.
+  // Not thread-safe: record() and close() must come from one thread.
+  class TrajectoryRecorder
+  {
+   public:
+    TrajectoryRecorder() = default;
+    ~TrajectoryRecorder();
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    bool open(const std::string& path, const TrajectoryOptions& options = {}, std::string* error = nullptr);
+    bool is_open() const { return open_; }
+
+    // Records `units` as frame `frame`. Frames at or before the last recorded one are ignored,
+    // so a run that restarts from the current state does not record it twice. A gap in frame
+    // numbers or a change in the unit count starts a new chunk.
+    void record(Tick frame, const UnitTable& units);
+
+    // Writes the last chunk and the index and closes the file (joining the writer thread);
+    // false if any write failed.
+    bool close(std::string* error = nullptr);
+
+    std::size_t frames() const { return frames_; }
+    // Encoded bytes handed to the file so far (not counting the chunk being built).
+    std::uint64_t bytes() const { return offset_; }
+
+   private:
+    struct IndexEntry
+    {
+      std::uint64_t first_frame = 0;
+      std::uint64_t frames = 0;
+      std::uint64_t offset = 0;
+    };
+
+    void begin_chunk(Tick frame, const UnitTable& units);
+    void finish_chunk();
+    void submit(std::string bytes);
+    void writer_loop();
+
+    TrajectoryOptions options_;
+    bool open_ = false;
+    std::size_t frames_ = 0;
+    std::uint64_t offset_ = 0;
+    std::vector<IndexEntry> index_;
+
+    // Chunk being built
+    std::string payload_;
+    Tick chunk_first_ = 0;
+    std::uint64_t chunk_frames_ = 0;
+    Tick last_frame_ = 0;
+    std::vector<std::uint32_t> prev_ids_;
+    std::vector<int> prev_x_;
+    std::vector<int> prev_y_;
+    std::vector<std::int64_t> escapes_;
+
+    // Output; owned by the writer thread while it runs.
+    std::ofstream out_;
+    std::thread writer_;
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::deque<std::string> queue_;
+    std::size_t queued_bytes_ = 0;
+    bool stop_ = false;
+    bool failed_ = false;
+  };
+
+  // Random access to a trajectory file through a memory mapping. Reading frames in increasing
+  // order within a chunk continues from the previous frame instead of decoding from the chunk
+  // start. Not thread-safe (the decode position is cached); open one reader per thread.
+  class TrajectoryReader
+  {
+   public:
+    bool open(const std::string& path, std::string* error = nullptr);
+    bool is_open() const { return file_.is_open(); }
+
+    std::size_t chunk_count() const { return chunks_.size(); }
+    // True if the file was closed properly; false if the chunks were recovered by scanning.
+    bool indexed() const { return indexed_; }
+    bool has_frame(Tick frame) const;
+    Tick first_frame() const;
+    Tick last_frame() const; // the last recorded frame (0 if none)
+
+    // Fills ids, x and y (one entry per unit) with frame `frame`; false if it was not recorded.
+    bool read_frame(Tick frame, std::vector<std::uint32_t>& ids, std::vector<int>& x, std::vector<int>& y) const;
+
+   private:
+    struct Chunk
+    {
+      std::uint64_t first_frame = 0;
+      std::uint64_t frames = 0;
+      std::uint64_t units = 0;
+      std::size_t payload = 0; // offset of the payload in the file
+      std::size_t payload_bytes = 0;
+    };
+
+    const Chunk* find(Tick frame) const;
+
+    MappedFile file_;
+    std::vector<Chunk> chunks_;
+    bool indexed_ = false;
+
+    // Decode position: the last frame read and where its successor's deltas start.
+    mutable const Chunk* cur_chunk_ = nullptr;
+    mutable std::uint64_t cur_frame_ = 0;
+    mutable std::size_t cur_pos_ = 0;
+    mutable std::vector<std::uint32_t> cur_ids_;
+    mutable std::vector<int> cur_x_;
+    mutable std::vector<int> cur_y_;
+  };
+} // namespace rescueops::sim
@@ -2,5 +2,73 @@
 
 namespace rescueops::sim
 {
-  // currently header-only data types; file kept for future expansions
+  std::uint32_t StringTable::intern(std::string_view s)
+  {
+    if (const auto it = index_.find(s); it != index_.end()) return it->second;
+    const auto index = static_cast<std::uint32_t>(size());
+    index_.emplace(std::string(s), index);
+    chars_.append(s);
+    offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+    return index;
+  }
+
+  std::string_view StringTable::at(std::uint32_t index) const
+  {
+    return std::string_view(chars_).substr(offsets_[index], offsets_[index + 1] - offsets_[index]);
+  }
+
+  void StringTable::clear()
+  {
+    chars_.clear();
+    offsets_.assign(1, 0);
+    index_.clear();
+  }
+
+  void UnitTable::clear()
+  {
+    ids_.clear();
+    x_.clear();
+    y_.clear();
+    name_index_.clear();
+    names_.clear();
+  }
+
+  void UnitTable::reserve(std::size_t n)
+  {
+    ids_.reserve(n);
+    x_.reserve(n);
+    y_.reserve(n);
+    name_index_.reserve(n);
+  }
+
+  void UnitTable::push_back(const Unit& unit)
+  {
+    push_back(unit.id, unit.name, unit.pos);
+  }
+
+  void UnitTable::push_back(std::uint32_t id, std::string_view name, Vec2i pos)
+  {
+    ids_.push_back(id);
+    x_.push_back(pos.x);
+    y_.push_back(pos.y);
+    name_index_.push_back(names_.intern(name));
+  }
+
+  void UnitTable::assign(std::span<const std::uint32_t> ids,
+                         std::span<const int> x,
+                         std::span<const int> y,
+                         std::span<const std::uint32_t> name_index,
+                         std::span<const std::string_view> names)
+  {
+    clear();
+    ids_.assign(ids.begin(), ids.end());
+    x_.assign(x.begin(), x.end());
+    y_.assign(y.begin(), y.end());
+
+    // Intern each name once; duplicates in `names` collapse onto one index.
+    std::vector<std::uint32_t> remap(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) remap[i] = names_.intern(names[i]);
+    name_index_.resize(name_index.size());
+    for (std::size_t i = 0; i < name_index.size(); ++i) name_index_[i] = remap[name_index[i]];
+  }
 } // namespace rescueops::sim
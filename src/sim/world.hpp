@@ -1,6 +1,10 @@
 #pragma once
 #include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace rescueops::sim
@@ -11,6 +15,7 @@ namespace rescueops::sim
     int y = 0;
   };
 
+  // One unit as a value, for building a UnitTable.
   struct Unit
   {
     std::uint32_t id = 0;
@@ -18,10 +23,108 @@ namespace rescueops::sim
     Vec2i pos{};
   };
 
+  // Read-only row of a UnitTable (what iterating it yields). `name` points into the table.
+  struct UnitRef
+  {
+    std::uint32_t id = 0;
+    std::string_view name;
+    Vec2i pos{};
+  };
+
+  // Interned strings stored back to back in one buffer; equal strings share one index.
+  class StringTable
+  {
+   public:
+    std::uint32_t intern(std::string_view s);
+    std::string_view at(std::uint32_t index) const;
+    std::size_t size() const { return offsets_.size() - 1; }
+    void clear();
+
+   private:
+    // Lets lookups take a string_view without building a std::string first.
+    struct Hash
+    {
+      using is_transparent = void;
+      std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::string chars_;
+    std::vector<std::uint32_t> offsets_{0}; // string i is chars_[offsets_[i], offsets_[i + 1])
+    std::unordered_map<std::string, std::uint32_t, Hash, std::equal_to<>> index_;
+  };
+
+  // Units as parallel arrays (structure of arrays): per-tick loops stream x()/y() without
+  // pulling ids or names into cache. Row i of every column is the same unit; names are interned
+  // and referenced by index.
+  class UnitTable
+  {
+   public:
+    class const_iterator
+    {
+     public:
+      const_iterator(const UnitTable* table, std::size_t i) : table_(table), i_(i) {}
+      UnitRef operator*() const { return (*table_)[i_]; }
+      const_iterator& operator++()
+      {
+        ++i_;
+        return *this;
+      }
+      bool operator==(const const_iterator& other) const { return i_ == other.i_; }
+      bool operator!=(const const_iterator& other) const { return i_ != other.i_; }
+
+     private:
+      const UnitTable* table_;
+      std::size_t i_;
+    };
+
+    std::size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    void clear();
+    void reserve(std::size_t n);
+    void push_back(const Unit& unit);
+    void push_back(std::uint32_t id, std::string_view name, Vec2i pos);
+    // Replaces the contents with whole columns. name_index refers into `names`; every entry
+    // must be < names.size().
+    void assign(std::span<const std::uint32_t> ids,
+                std::span<const int> x,
+                std::span<const int> y,
+                std::span<const std::uint32_t> name_index,
+                std::span<const std::string_view> names);
+
+    UnitRef operator[](std::size_t i) const { return UnitRef{ids_[i], name(i), pos(i)}; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    std::uint32_t id(std::size_t i) const { return ids_[i]; }
+    std::string_view name(std::size_t i) const { return names_.at(name_index_[i]); }
+    Vec2i pos(std::size_t i) const { return Vec2i{x_[i], y_[i]}; }
+    void set_pos(std::size_t i, Vec2i p)
+    {
+      x_[i] = p.x;
+      y_[i] = p.y;
+    }
+
+    // Contiguous columns, for tight per-tick loops.
+    std::span<int> x() { return x_; }
+    std::span<int> y() { return y_; }
+    std::span<const int> x() const { return x_; }
+    std::span<const int> y() const { return y_; }
+    std::span<const std::uint32_t> ids() const { return ids_; }
+    std::span<const std::uint32_t> name_indices() const { return name_index_; } // into names()
+    const StringTable& names() const { return names_; }
+
+   private:
+    std::vector<std::uint32_t> ids_;
+    std::vector<int> x_;
+    std::vector<int> y_;
+    std::vector<std::uint32_t> name_index_; // into names_
+    StringTable names_;
+  };
+
   struct World
   {
     int width = 32;
     int height = 18;
-    std::vector<Unit> units;
+    UnitTable units;
   };
 } // namespace rescueops::sim
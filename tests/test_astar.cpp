@@ -3,6 +3,7 @@
 #include "planner/astar.hpp"
 
 using rescueops::planner::Grid;
+using rescueops::planner::SearchContext;
 using rescueops::planner::astar;
 using rescueops::sim::Vec2i;
 
@@ -25,9 +26,71 @@ TEST_CASE(test_astar_simple_path)
   TEST_ASSERT(res->path.back().x == 4 && res->path.back().y == 4);
 }
 
+TEST_CASE(test_astar_context_reuse)
+{
+  Grid big;
+  big.w = 8;
+  big.h = 6;
+  big.blocked.assign(static_cast<std::size_t>(big.w * big.h), 0);
+  for (int y = 0; y < 5; ++y) big.blocked[static_cast<std::size_t>(y * big.w + 4)] = 1;
+
+  Grid small;
+  small.w = 3;
+  small.h = 3;
+  small.blocked.assign(9, 0);
+  small.blocked[4] = 1;
+
+  SearchContext ctx;
+  for (int round = 0; round < 3; ++round)
+  {
+    auto a = astar(big, Vec2i{0, 0}, Vec2i{7, 0}, ctx);
+    auto fresh = astar(big, Vec2i{0, 0}, Vec2i{7, 0});
+    TEST_ASSERT(a && fresh);
+    TEST_ASSERT(a->cost == fresh->cost && a->cost == 17);
+    TEST_ASSERT(a->path.size() == fresh->path.size());
+    for (std::size_t i = 0; i < a->path.size(); ++i)
+      TEST_ASSERT(a->path[i].x == fresh->path[i].x && a->path[i].y == fresh->path[i].y);
+
+    // Records left over from the larger grid must not leak into this query.
+    auto b = astar(small, Vec2i{0, 0}, Vec2i{2, 2}, ctx);
+    TEST_ASSERT(b && b->cost == 4);
+    TEST_ASSERT(!astar(small, Vec2i{0, 0}, Vec2i{1, 1}, ctx));
+  }
+}
+
+TEST_CASE(test_astar_bucket_queue_same_cost)
+{
+  Grid g;
+  g.w = 12;
+  g.h = 9;
+  g.blocked.assign(static_cast<std::size_t>(g.w * g.h), 0);
+  for (int y = 0; y < 8; ++y) g.blocked[static_cast<std::size_t>(y * g.w + 3)] = 1;
+  for (int y = 1; y < 9; ++y) g.blocked[static_cast<std::size_t>(y * g.w + 8)] = 1;
+
+  SearchContext heap;
+  SearchContext buckets;
+  buckets.set_open_list(rescueops::planner::OpenList::Buckets);
+  for (const auto& goal : {Vec2i{11, 8}, Vec2i{11, 0}, Vec2i{5, 4}, Vec2i{0, 8}})
+  {
+    auto a = astar(g, Vec2i{0, 0}, goal, heap);
+    auto b = astar(g, Vec2i{0, 0}, goal, buckets);
+    TEST_ASSERT(a && b);
+    TEST_ASSERT(a->cost == b->cost);
+    TEST_ASSERT(static_cast<int>(b->path.size()) == b->cost + 1);
+
+    // Same query again: identical tie-breaking every run.
+    auto again = astar(g, Vec2i{0, 0}, goal, buckets);
+    TEST_ASSERT(again && again->path.size() == b->path.size());
+    for (std::size_t i = 0; i < b->path.size(); ++i)
+      TEST_ASSERT(again->path[i].x == b->path[i].x && again->path[i].y == b->path[i].y);
+  }
+}
+
 int main()
 {
   RUN_TEST(test_astar_simple_path);
+  RUN_TEST(test_astar_context_reuse);
+  RUN_TEST(test_astar_bucket_queue_same_cost);
   std::cout << "All A* tests passed.\n";
   return 0;
 }
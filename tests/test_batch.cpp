@@ -0,0 +1,74 @@
+#include "test_common.hpp"
+
+#include <random>
+
+#include "planner/batch.hpp"
+
+using rescueops::planner::BatchPlanner;
+using rescueops::planner::Grid;
+using rescueops::planner::PlanConfig;
+using rescueops::planner::PlanQuery;
+using rescueops::planner::SearchContext;
+using rescueops::sim::ThreadPool;
+using rescueops::sim::Vec2i;
+
+TEST_CASE(test_thread_pool_covers_every_index)
+{
+  ThreadPool pool(4);
+  TEST_ASSERT(pool.size() == 4);
+  for (int round = 0; round < 50; ++round)
+  {
+    std::vector<int> hits(1000, 0);
+    pool.parallel_for(hits.size(), [&](std::size_t i, unsigned worker) {
+      TEST_ASSERT(worker < 4);
+      hits[i] += 1;
+    });
+    for (int h : hits) TEST_ASSERT(h == 1);
+  }
+}
+
+TEST_CASE(test_batch_matches_serial_for_any_thread_count)
+{
+  std::mt19937 rng(3);
+  Grid g;
+  g.w = 60;
+  g.h = 40;
+  g.blocked.resize(static_cast<std::size_t>(g.w * g.h));
+  for (auto& b : g.blocked) b = (rng() % 100) < 25 ? 1 : 0;
+
+  std::vector<PlanQuery> queries;
+  for (int i = 0; i < 300; ++i)
+  {
+    queries.push_back(PlanQuery{Vec2i{static_cast<int>(rng() % 60), static_cast<int>(rng() % 40)},
+                                Vec2i{static_cast<int>(rng() % 60), static_cast<int>(rng() % 40)}});
+  }
+
+  PlanConfig cfg;
+  SearchContext ctx;
+  std::vector<std::optional<rescueops::planner::PathResult>> serial;
+  for (const auto& q : queries) serial.push_back(rescueops::planner::find_path(cfg, g, q.start, q.goal, ctx));
+
+  for (unsigned threads : {1u, 2u, 5u})
+  {
+    ThreadPool pool(threads);
+    BatchPlanner batch(pool);
+    const auto out = batch.plan(cfg, g, queries);
+    TEST_ASSERT(out.size() == serial.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+      TEST_ASSERT(out[i].has_value() == serial[i].has_value());
+      if (!out[i]) continue;
+      TEST_ASSERT(out[i]->cost == serial[i]->cost && out[i]->path.size() == serial[i]->path.size());
+      for (std::size_t k = 0; k < out[i]->path.size(); ++k)
+        TEST_ASSERT(out[i]->path[k].x == serial[i]->path[k].x && out[i]->path[k].y == serial[i]->path[k].y);
+    }
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_thread_pool_covers_every_index);
+  RUN_TEST(test_batch_matches_serial_for_any_thread_count);
+  std::cout << "All batch planning tests passed.\n";
+  return 0;
+}
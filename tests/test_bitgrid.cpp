@@ -0,0 +1,65 @@
+#include "test_common.hpp"
+
+#include "planner/bitgrid.hpp"
+#include "planner/jps.hpp"
+
+using rescueops::planner::BitGrid;
+using rescueops::planner::Grid;
+using rescueops::planner::SearchContext;
+using rescueops::planner::astar;
+using rescueops::planner::jps;
+using rescueops::sim::Vec2i;
+
+TEST_CASE(test_bitgrid_border_and_rects)
+{
+  BitGrid b(130, 4);
+  TEST_ASSERT(b.count_blocked() == 0);
+  TEST_ASSERT(b.is_blocked(-1, 0) && b.is_blocked(130, 0));
+  TEST_ASSERT(b.is_blocked(5, -1) && b.is_blocked(5, 4));
+
+  // Spans a word boundary and is clipped on the right.
+  b.fill_rect(60, 1, 100, 2);
+  TEST_ASSERT(b.count_blocked() == 2 * 70);
+  TEST_ASSERT(!b.is_blocked(59, 1) && b.is_blocked(60, 1) && b.is_blocked(129, 2) && !b.is_blocked(60, 3));
+
+  const std::uint64_t from = b.bits_from(58, 1);
+  TEST_ASSERT((from & 0x3u) == 0 && ((from >> 2) & 1u) == 1);
+  const std::uint64_t until = b.bits_until(61, 1);
+  TEST_ASSERT((until >> 62) == 0x3u && ((until >> 61) & 1u) == 0);
+
+  const Grid g = b.to_grid();
+  TEST_ASSERT(g.w == 130 && g.h == 4 && g.is_blocked(100, 2) && !g.is_blocked(100, 0));
+}
+
+TEST_CASE(test_bitgrid_search_matches_byte_grid)
+{
+  Grid g;
+  g.w = 70;
+  g.h = 9;
+  g.blocked.assign(static_cast<std::size_t>(g.w * g.h), 0);
+  for (int y = 0; y < 8; ++y) g.blocked[static_cast<std::size_t>(y * g.w + 20)] = 1;
+  for (int y = 1; y < 9; ++y) g.blocked[static_cast<std::size_t>(y * g.w + 50)] = 1;
+  const BitGrid b(g);
+
+  SearchContext ctx;
+  for (const auto& goal : {Vec2i{69, 8}, Vec2i{69, 0}, Vec2i{35, 4}})
+  {
+    const auto ga = astar(g, Vec2i{0, 0}, goal, ctx);
+    const auto ba = astar(b, Vec2i{0, 0}, goal, ctx);
+    const auto gj = jps(g, Vec2i{0, 0}, goal, ctx);
+    const auto bj = jps(b, Vec2i{0, 0}, goal, ctx);
+    TEST_ASSERT(ga && ba && gj && bj);
+    TEST_ASSERT(ga->cost == ba->cost && ga->path.size() == ba->path.size());
+    TEST_ASSERT(gj->cost == bj->cost && gj->cost == ga->cost);
+    for (std::size_t i = 0; i < gj->path.size(); ++i)
+      TEST_ASSERT(gj->path[i].x == bj->path[i].x && gj->path[i].y == bj->path[i].y);
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_bitgrid_border_and_rects);
+  RUN_TEST(test_bitgrid_search_matches_byte_grid);
+  std::cout << "All BitGrid tests passed.\n";
+  return 0;
+}
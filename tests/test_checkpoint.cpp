@@ -0,0 +1,150 @@
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "sim/binary_io.hpp"
+#include "sim/engine.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::MotionRng;
+using rescueops::sim::Unit;
+using rescueops::sim::Vec2i;
+
+static void setup(Engine& eng, MotionRng rng)
+{
+  eng.set_seed(99);
+  eng.set_motion_rng(rng);
+  eng.world().width = 40;
+  eng.world().height = 25;
+  for (std::uint32_t i = 0; i < 300; ++i)
+  {
+    const std::string name = i % 3 == 0 ? "medic" : "team_" + std::to_string(i);
+    eng.world().units.push_back(Unit{i + 1, name, Vec2i{static_cast<int>(i % 40), static_cast<int>(i % 25)}});
+  }
+}
+
+static bool same_state(Engine& a, Engine& b)
+{
+  const auto& ua = a.world().units;
+  const auto& ub = b.world().units;
+  if (a.tick() != b.tick() || ua.size() != ub.size()) return false;
+  for (std::size_t i = 0; i < ua.size(); ++i)
+  {
+    if (ua.id(i) != ub.id(i) || ua.name(i) != ub.name(i)) return false;
+    if (ua.pos(i).x != ub.pos(i).x || ua.pos(i).y != ub.pos(i).y) return false;
+  }
+  return a.rng()() == b.rng()();
+}
+
+TEST_CASE(test_run_continues_the_timeline)
+{
+  Engine once, steps;
+  setup(once, MotionRng::Mt19937);
+  setup(steps, MotionRng::Mt19937);
+  const auto rr = once.run(230);
+  steps.run(70);
+  steps.run(70); // already there: no-op
+  steps.run(160);
+  const auto rs = steps.run(230);
+  TEST_ASSERT(rr.ticks_executed == 230 && rs.ticks_executed == 230);
+  TEST_ASSERT(same_state(once, steps));
+  TEST_ASSERT(steps.scheduler().pending() == 1); // one heartbeat, armed once
+}
+
+TEST_CASE(test_resume_matches_uninterrupted_run)
+{
+  for (const auto mode : {MotionRng::Mt19937, MotionRng::Philox})
+  {
+    Engine full;
+    setup(full, mode);
+    full.run(333);
+
+    Engine first;
+    setup(first, mode);
+    first.run(125);
+    const std::string snap = first.checkpoint();
+    TEST_ASSERT(!snap.empty());
+
+    Engine resumed; // default seed/world, all replaced by the snapshot
+    TEST_ASSERT(resumed.restore(snap));
+    TEST_ASSERT(resumed.tick() == 125 && resumed.motion_rng() == mode);
+    TEST_ASSERT(resumed.world().units.names().size() == first.world().units.names().size());
+    TEST_ASSERT(resumed.checkpoint() == snap); // round-trips byte for byte
+    const auto rr = resumed.run(333);
+    TEST_ASSERT(rr.ticks_executed == 333 && rr.seed == 99);
+    TEST_ASSERT(same_state(full, resumed));
+  }
+}
+
+TEST_CASE(test_restore_rejects_bad_snapshots)
+{
+  Engine src;
+  setup(src, MotionRng::Mt19937);
+  src.run(10);
+  const std::string snap = src.checkpoint();
+
+  Engine eng;
+  eng.world().units.push_back(Unit{7, "keep", Vec2i{1, 2}});
+  std::string flipped = snap;
+  flipped[snap.size() / 2] ^= 0x10;
+  TEST_ASSERT(!eng.restore(flipped));
+  TEST_ASSERT(!eng.restore(snap.substr(0, snap.size() - 1)));
+  TEST_ASSERT(!eng.restore(""));
+  TEST_ASSERT(eng.world().units.size() == 1 && eng.world().units.name(0) == "keep" && eng.tick() == 0);
+
+  // Closures scheduled from outside cannot be saved, and a restore would drop them.
+  eng.scheduler().schedule(5, [] {});
+  TEST_ASSERT(eng.checkpoint().empty());
+  TEST_ASSERT(!eng.restore(snap));
+}
+
+// Snapshots whose counts claim more entries than the bytes left, with a valid checksum: restore
+// must fail before allocating for them.
+TEST_CASE(test_restore_rejects_oversized_counts)
+{
+  Engine src;
+  setup(src, MotionRng::Mt19937);
+  src.run(10);
+  const std::string snap = src.checkpoint();
+  const std::string body = snap.substr(0, snap.size() - 8);
+
+  // Walk the header up to the recurring count: magic, version, seed, tick, motion, w, h, rng.
+  rescueops::sim::BinaryReader r(body);
+  r.bytes(8);
+  r.u32();
+  r.u64();
+  r.u64();
+  r.u8();
+  r.i32();
+  r.i32();
+  r.str();
+  const std::size_t recurring_at = r.position();
+  const std::uint32_t recurring = r.u32();
+  for (std::uint32_t i = 0; i < recurring; ++i) r.bytes(20);
+  const std::size_t names_at = r.position();
+  TEST_ASSERT(r.ok());
+
+  const auto forge = [&](std::size_t at) {
+    std::string bad = body;
+    for (std::size_t k = 0; k < 4; ++k) bad[at + k] = '\xff';
+    rescueops::sim::BinaryWriter w;
+    w.bytes(bad);
+    w.u64(rescueops::sim::fnv1a64(bad));
+    return w.take();
+  };
+  Engine eng;
+  TEST_ASSERT(!eng.restore(forge(recurring_at)));
+  TEST_ASSERT(!eng.restore(forge(names_at)));
+  TEST_ASSERT(eng.restore(snap) && same_state(eng, src));
+}
+
+int main()
+{
+  RUN_TEST(test_run_continues_the_timeline);
+  RUN_TEST(test_resume_matches_uninterrupted_run);
+  RUN_TEST(test_restore_rejects_bad_snapshots);
+  RUN_TEST(test_restore_rejects_oversized_counts);
+  std::cout << "All checkpoint tests passed.\n";
+  return 0;
+}
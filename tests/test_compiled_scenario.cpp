@@ -0,0 +1,125 @@
+#include "test_common.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sim/compiled_scenario.hpp"
+#include "sim/engine.hpp"
+
+using rescueops::sim::CompiledScenario;
+using rescueops::sim::Engine;
+using rescueops::sim::Scenario;
+
+static const char* kScenario = R"({
+  "seed": 5, "ticks": 30,
+  "world": {"width": 70, "height": 4},
+  "units": [{"name": "alpha", "x": 1, "y": 1}, {"name": "bravo", "x": 68, "y": 2}, {"name": "alpha", "x": 3, "y": 3}],
+  "targets": [{"unit": "bravo", "tx": 60, "ty": 0}, {"unit": "ghost", "tx": 2, "ty": 2}]
+})";
+
+static std::string temp_path(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Cells (x, 1) for x in [10, 70) are blocked, crossing the word boundary at 64.
+static std::vector<std::uint8_t> make_blocked()
+{
+  std::vector<std::uint8_t> blocked(70 * 4, 0);
+  for (int x = 10; x < 70; ++x) blocked[static_cast<std::size_t>(70 + x)] = 1;
+  return blocked;
+}
+
+TEST_CASE(test_round_trip)
+{
+  Scenario s;
+  TEST_ASSERT(rescueops::sim::parse_scenario(kScenario, s));
+  const auto blocked = make_blocked();
+  const std::string path = temp_path("rescueops_test_round_trip.rsc");
+  TEST_ASSERT(rescueops::sim::write_compiled_scenario(path, s, blocked));
+  TEST_ASSERT(rescueops::sim::is_compiled_scenario(path));
+
+  CompiledScenario c;
+  std::string error;
+  TEST_ASSERT(c.open(path, &error));
+  TEST_ASSERT(c.seed() == 5 && c.ticks() == 30 && c.width() == 70 && c.height() == 4);
+  TEST_ASSERT(c.unit_ids().size() == 3 && c.unit_x()[1] == 68 && c.unit_y()[2] == 3);
+  TEST_ASSERT(c.unit_name_count() == 2 && c.name_count() == 3);
+  TEST_ASSERT(c.name(c.unit_name_indices()[2]) == "alpha");
+  TEST_ASSERT(c.target_count() == 2);
+  TEST_ASSERT(c.target(0).unit == "bravo" && c.target(0).tx == 60 && c.target(0).ty == 0);
+  TEST_ASSERT(c.target(1).unit == "ghost");
+
+  TEST_ASSERT(c.blocked_count() == 60 && c.words_per_row() == 2);
+  TEST_ASSERT(!c.is_blocked(9, 1) && c.is_blocked(10, 1) && c.is_blocked(69, 1) && !c.is_blocked(69, 2));
+  std::vector<std::uint8_t> unpacked(70 * 4, 7);
+  c.unpack_blocked(unpacked);
+  TEST_ASSERT(unpacked == blocked);
+
+  // The engine sees the same world as from the JSON
+  Engine from_json;
+  from_json.load(s);
+  Engine from_image;
+  from_image.load(c);
+  from_json.run(20);
+  from_image.run(20);
+  TEST_ASSERT(from_image.seed() == 5);
+  TEST_ASSERT(from_image.world().units.names().size() == from_json.world().units.names().size());
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    const auto a = from_json.world().units[i];
+    const auto b = from_image.world().units[i];
+    TEST_ASSERT(a.id == b.id && a.name == b.name && a.pos.x == b.pos.x && a.pos.y == b.pos.y);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_rejects_damaged_images)
+{
+  Scenario s;
+  TEST_ASSERT(rescueops::sim::parse_scenario(kScenario, s));
+  const std::string path = temp_path("rescueops_test_damaged.rsc");
+  TEST_ASSERT(rescueops::sim::write_compiled_scenario(path, s, make_blocked()));
+  std::string image;
+  {
+    std::ifstream in(path, std::ios::binary);
+    image.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  const auto write = [&](const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << bytes;
+  };
+
+  CompiledScenario c;
+  std::string error;
+  write(image.substr(0, image.size() - 8)); // truncated
+  TEST_ASSERT(!c.open(path, &error) && !c.is_open());
+
+  std::string bad = image;
+  bad[8] = 2; // version
+  write(bad);
+  TEST_ASSERT(!c.open(path, &error));
+  TEST_ASSERT(error.find("version") != std::string::npos);
+
+  bad = image;
+  bad[96] = 1; // first section offset no longer aligned
+  write(bad);
+  TEST_ASSERT(!c.open(path, &error));
+
+  write(image);
+  TEST_ASSERT(c.open(path, &error));
+  TEST_ASSERT(!rescueops::sim::write_compiled_scenario(path, s, std::vector<std::uint8_t>(5), &error));
+  std::filesystem::remove(path);
+
+  TEST_ASSERT(!c.open(temp_path("rescueops_test_missing.rsc"), &error));
+}
+
+int main()
+{
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_rejects_damaged_images);
+  std::cout << "All compiled scenario tests passed.\n";
+  return 0;
+}
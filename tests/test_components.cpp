@@ -0,0 +1,134 @@
+#include "test_common.hpp"
+
+#include <random>
+#include <vector>
+
+#include "planner/components.hpp"
+#include "planner/plan.hpp"
+
+using rescueops::planner::ComponentLabels;
+using rescueops::planner::Grid;
+using rescueops::planner::PlanConfig;
+using rescueops::planner::SearchContext;
+using rescueops::sim::Vec2i;
+
+static Grid empty_grid(int w, int h)
+{
+  Grid g;
+  g.w = w;
+  g.h = h;
+  g.blocked.assign(static_cast<std::size_t>(w * h), 0);
+  return g;
+}
+
+TEST_CASE(test_components_split_and_merge)
+{
+  Grid g = empty_grid(7, 5);
+  ComponentLabels cc;
+  cc.build(g);
+  TEST_ASSERT(cc.component_count() == 1);
+
+  // Wall at x=3 with a single gap at y=2.
+  std::vector<Vec2i> wall;
+  for (int y = 0; y < 5; ++y)
+  {
+    if (y == 2) continue;
+    g.blocked[static_cast<std::size_t>(y * g.w + 3)] = 1;
+    wall.push_back(Vec2i{3, y});
+  }
+  cc.update(g, wall);
+  TEST_ASSERT(cc.component_count() == 1);
+  TEST_ASSERT(cc.connected(Vec2i{0, 0}, Vec2i{6, 4}));
+
+  // Closing the gap splits the map in two.
+  g.blocked[static_cast<std::size_t>(2 * g.w + 3)] = 1;
+  const Vec2i gap[] = {Vec2i{3, 2}};
+  cc.update(g, gap);
+  TEST_ASSERT(cc.component_count() == 2);
+  TEST_ASSERT(!cc.connected(Vec2i{0, 0}, Vec2i{6, 4}));
+  TEST_ASSERT(cc.connected(Vec2i{0, 0}, Vec2i{2, 4}));
+  TEST_ASSERT(!cc.connected(Vec2i{3, 2}, Vec2i{3, 2}));
+
+  // Reopening it merges them again.
+  g.blocked[static_cast<std::size_t>(2 * g.w + 3)] = 0;
+  cc.update(g, gap);
+  TEST_ASSERT(cc.component_count() == 1);
+  TEST_ASSERT(cc.connected(Vec2i{0, 0}, Vec2i{6, 4}));
+}
+
+TEST_CASE(test_components_reject_before_search)
+{
+  Grid g = empty_grid(9, 9);
+  // Enclose the cell (6,6) in a ring.
+  for (int x = 5; x <= 7; ++x)
+  {
+    g.blocked[static_cast<std::size_t>(5 * g.w + x)] = 1;
+    g.blocked[static_cast<std::size_t>(7 * g.w + x)] = 1;
+  }
+  g.blocked[static_cast<std::size_t>(6 * g.w + 5)] = 1;
+  g.blocked[static_cast<std::size_t>(6 * g.w + 7)] = 1;
+
+  ComponentLabels cc;
+  cc.build(g);
+  TEST_ASSERT(cc.component_count() == 2);
+
+  PlanConfig cfg;
+  cfg.components = &cc;
+  SearchContext ctx;
+  TEST_ASSERT(!rescueops::planner::find_path(cfg, g, Vec2i{0, 0}, Vec2i{6, 6}, ctx));
+  TEST_ASSERT(ctx.stats().expanded == 0);
+
+  auto ok = rescueops::planner::find_path(cfg, g, Vec2i{0, 0}, Vec2i{8, 8}, ctx);
+  TEST_ASSERT(ok && ok->cost == 16);
+}
+
+// Seeded random toggles, one cell or a small batch at a time: after every update the
+// incremental labels must agree with labels built from scratch on the same grid.
+TEST_CASE(test_components_random_toggles_match_rebuild)
+{
+  for (std::uint64_t seed = 1; seed <= 4; ++seed)
+  {
+    std::mt19937_64 rng(seed);
+    Grid g = empty_grid(13, 11);
+    for (auto& b : g.blocked) b = rng() % 10 < 3 ? 1 : 0;
+    ComponentLabels cc;
+    cc.build(g);
+
+    const auto cell = [&] {
+      return Vec2i{static_cast<int>(rng() % static_cast<std::uint64_t>(g.w)),
+                   static_cast<int>(rng() % static_cast<std::uint64_t>(g.h))};
+    };
+    std::vector<Vec2i> changed;
+    for (int step = 0; step < 300; ++step)
+    {
+      changed.clear();
+      for (int k = rng() % 4 == 0 ? 1 + static_cast<int>(rng() % 4) : 1; k > 0; --k)
+      {
+        const Vec2i c = cell();
+        auto& b = g.blocked[static_cast<std::size_t>(c.y * g.w + c.x)];
+        b = b ? 0 : 1;
+        changed.push_back(c);
+      }
+      cc.update(g, changed);
+
+      ComponentLabels fresh;
+      fresh.build(g);
+      TEST_ASSERT(cc.component_count() == fresh.component_count());
+      for (int q = 0; q < 40; ++q)
+      {
+        const Vec2i a = cell();
+        const Vec2i b = cell();
+        TEST_ASSERT(cc.connected(a, b) == fresh.connected(a, b));
+      }
+    }
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_components_split_and_merge);
+  RUN_TEST(test_components_reject_before_search);
+  RUN_TEST(test_components_random_toggles_match_rebuild);
+  std::cout << "All component tests passed.\n";
+  return 0;
+}
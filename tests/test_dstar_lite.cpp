@@ -0,0 +1,92 @@
+#include "test_common.hpp"
+
+#include <random>
+
+#include "planner/dstar_lite.hpp"
+
+using rescueops::planner::DStarLite;
+using rescueops::planner::Grid;
+using rescueops::planner::SearchContext;
+using rescueops::planner::astar;
+using rescueops::sim::Vec2i;
+
+TEST_CASE(test_dstar_lite_repairs_after_wall)
+{
+  Grid g;
+  g.w = 8;
+  g.h = 6;
+  g.blocked.assign(static_cast<std::size_t>(g.w * g.h), 0);
+
+  DStarLite d;
+  d.reset(g, Vec2i{0, 0}, Vec2i{7, 0});
+  auto first = d.find_path(g);
+  TEST_ASSERT(first && first->cost == 7);
+
+  // Drop a wall across x=4 leaving a gap at the bottom row.
+  std::vector<Vec2i> changed;
+  for (int y = 0; y < 5; ++y)
+  {
+    g.blocked[static_cast<std::size_t>(y * g.w + 4)] = 1;
+    changed.push_back(Vec2i{4, y});
+  }
+  d.notify_changed(g, changed);
+  auto detour = d.find_path(g);
+  TEST_ASSERT(detour && detour->cost == 17);
+  TEST_ASSERT(static_cast<int>(detour->path.size()) == detour->cost + 1);
+
+  // Close the gap: no path.
+  g.blocked[static_cast<std::size_t>(5 * g.w + 4)] = 1;
+  const Vec2i gap[] = {Vec2i{4, 5}};
+  d.notify_changed(g, gap);
+  TEST_ASSERT(!d.find_path(g));
+}
+
+TEST_CASE(test_dstar_lite_matches_astar_under_changes)
+{
+  std::mt19937 rng(21);
+  SearchContext ctx;
+  for (int round = 0; round < 200; ++round)
+  {
+    Grid g;
+    g.w = 20;
+    g.h = 15;
+    g.blocked.resize(static_cast<std::size_t>(g.w * g.h));
+    for (auto& b : g.blocked) b = (rng() % 100) < 25 ? 1 : 0;
+
+    Vec2i s{static_cast<int>(rng() % 20), static_cast<int>(rng() % 15)};
+    const Vec2i t{static_cast<int>(rng() % 20), static_cast<int>(rng() % 15)};
+    DStarLite d;
+    d.reset(g, s, t);
+
+    for (int step = 0; step < 20; ++step)
+    {
+      auto expected = astar(g, s, t, ctx);
+      auto got = d.find_path(g);
+      TEST_ASSERT(expected.has_value() == got.has_value());
+      if (expected) TEST_ASSERT(expected->cost == got->cost);
+
+      // Advance one step along the current path, then toggle a few cells.
+      if (got && got->path.size() > 1)
+      {
+        s = got->path[1];
+        d.move_start(s);
+      }
+      std::vector<Vec2i> changed;
+      for (int k = 0; k < 3; ++k)
+      {
+        const Vec2i p{static_cast<int>(rng() % 20), static_cast<int>(rng() % 15)};
+        g.blocked[static_cast<std::size_t>(p.y * g.w + p.x)] ^= 1;
+        changed.push_back(p);
+      }
+      d.notify_changed(g, changed);
+    }
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_dstar_lite_repairs_after_wall);
+  RUN_TEST(test_dstar_lite_matches_astar_under_changes);
+  std::cout << "All D* Lite tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,264 @@
+#include "test_common.hpp"
+
+#include <random>
+
+#include "planner/batch.hpp"
+#include "planner/flow_field.hpp"
+
+using rescueops::planner::Algorithm;
+using rescueops::planner::BatchPlanner;
+using rescueops::planner::FlowField;
+using rescueops::planner::FlowFieldCache;
+using rescueops::planner::Grid;
+using rescueops::planner::PlanConfig;
+using rescueops::planner::PlanQuery;
+using rescueops::sim::ThreadPool;
+using rescueops::sim::Vec2i;
+
+static Grid random_grid(std::mt19937& rng, int w, int h, int pct)
+{
+  Grid g;
+  g.w = w;
+  g.h = h;
+  g.blocked.resize(static_cast<std::size_t>(w * h));
+  for (auto& b : g.blocked) b = static_cast<int>(rng() % 100) < pct ? 1 : 0;
+  return g;
+}
+
+TEST_CASE(test_flow_field_matches_astar_costs)
+{
+  std::mt19937 rng(11);
+  for (int round = 0; round < 30; ++round)
+  {
+    const Grid g = random_grid(rng, 25, 17, 30);
+    const Vec2i goal{static_cast<int>(rng() % 25), static_cast<int>(rng() % 17)};
+    FlowField field;
+    field.build(g, goal);
+
+    for (int y = 0; y < g.h; ++y)
+    {
+      for (int x = 0; x < g.w; ++x)
+      {
+        const auto ref = rescueops::planner::astar(g, Vec2i{x, y}, goal);
+        const auto got = field.path_from(Vec2i{x, y});
+        TEST_ASSERT(ref.has_value() == got.has_value());
+        if (!got) continue;
+        TEST_ASSERT(got->cost == ref->cost);
+        TEST_ASSERT(got->path.size() == static_cast<std::size_t>(got->cost) + 1);
+        TEST_ASSERT(got->path.back().x == goal.x && got->path.back().y == goal.y);
+        for (std::size_t k = 1; k < got->path.size(); ++k)
+        {
+          const auto& a = got->path[k - 1];
+          const auto& b = got->path[k];
+          TEST_ASSERT(std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1);
+          TEST_ASSERT(!g.is_blocked(b.x, b.y));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE(test_flow_field_next_step)
+{
+  Grid g;
+  g.w = 5;
+  g.h = 1;
+  g.blocked = {0, 0, 0, 1, 0};
+  FlowField field;
+  field.build(g, Vec2i{0, 0});
+  TEST_ASSERT(field.distance(Vec2i{2, 0}) == 2);
+  TEST_ASSERT(field.next_step(Vec2i{2, 0})->x == 1);
+  TEST_ASSERT(!field.next_step(Vec2i{0, 0}));
+  TEST_ASSERT(field.distance(Vec2i{4, 0}) == FlowField::kUnreachable);
+  TEST_ASSERT(!field.path_from(Vec2i{4, 0}));
+  TEST_ASSERT(!field.path_from(Vec2i{3, 0}));
+}
+
+TEST_CASE(test_cache_invalidation)
+{
+  Grid g;
+  g.w = 6;
+  g.h = 1;
+  g.blocked = {0, 0, 0, 1, 0, 0};
+  FlowFieldCache cache;
+  cache.get(g, Vec2i{0, 0});
+  cache.get(g, Vec2i{5, 0});
+  TEST_ASSERT(cache.size() == 2);
+
+  // Opening (3,0) touches both fields (it neighbours cells each of them reached).
+  g.blocked[3] = 0;
+  const Vec2i changed[] = {Vec2i{3, 0}};
+  cache.notify_changed(changed);
+  TEST_ASSERT(cache.size() == 0);
+  TEST_ASSERT(cache.get(g, Vec2i{0, 0}).distance(Vec2i{5, 0}) == 5);
+
+  // A change far from anything a field reached keeps it.
+  Grid walled;
+  walled.w = 6;
+  walled.h = 1;
+  walled.blocked = {0, 1, 1, 0, 0, 0};
+  cache.clear();
+  cache.get(walled, Vec2i{0, 0});
+  walled.blocked[4] = 1;
+  const Vec2i far[] = {Vec2i{4, 0}};
+  cache.notify_changed(far);
+  TEST_ASSERT(cache.find(Vec2i{0, 0}) != nullptr);
+
+  // A grid of the same width but another height gets fresh fields sized for it.
+  Grid taller;
+  taller.w = 6;
+  taller.h = 3;
+  taller.blocked.assign(18, 0);
+  const auto& f = cache.get(taller, Vec2i{0, 0});
+  TEST_ASSERT(cache.size() == 1);
+  TEST_ASSERT(f.distance(Vec2i{5, 2}) == 7);
+  TEST_ASSERT(cache.get(taller, Vec2i{4, 2}).distance(Vec2i{0, 0}) == 6);
+}
+
+TEST_CASE(test_batch_groups_by_goal)
+{
+  std::mt19937 rng(5);
+  const Grid g = random_grid(rng, 50, 40, 25);
+  const Vec2i goals[] = {{3, 4}, {40, 30}, {25, 10}};
+
+  std::vector<PlanQuery> queries;
+  for (int i = 0; i < 200; ++i)
+    queries.push_back(PlanQuery{Vec2i{static_cast<int>(rng() % 50), static_cast<int>(rng() % 40)}, goals[i % 3]});
+
+  PlanConfig cfg;
+  cfg.algorithm = Algorithm::FlowField;
+
+  std::vector<std::optional<rescueops::planner::PathResult>> first;
+  for (unsigned threads : {1u, 3u})
+  {
+    ThreadPool pool(threads);
+    BatchPlanner batch(pool);
+    const auto out = batch.plan(cfg, g, queries);
+    TEST_ASSERT(batch.flow_fields().size() == 3);
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+      const auto ref = rescueops::planner::astar(g, queries[i].start, queries[i].goal);
+      TEST_ASSERT(out[i].has_value() == ref.has_value());
+      if (out[i]) TEST_ASSERT(out[i]->cost == ref->cost);
+    }
+    if (first.empty())
+    {
+      first = out;
+      continue;
+    }
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+      if (!out[i]) continue;
+      TEST_ASSERT(out[i]->path.size() == first[i]->path.size());
+      for (std::size_t k = 0; k < out[i]->path.size(); ++k)
+        TEST_ASSERT(out[i]->path[k].x == first[i]->path[k].x && out[i]->path[k].y == first[i]->path[k].y);
+    }
+
+    // A second batch reuses the cached fields: no BFS work.
+    batch.plan(cfg, g, queries);
+    TEST_ASSERT(batch.stats().expanded == 0);
+  }
+}
+
+TEST_CASE(test_batch_distinct_goals_use_astar)
+{
+  // Every query has its own goal: a field each would flood the grid per query, so none is built.
+  std::mt19937 rng(9);
+  const Grid g = random_grid(rng, 50, 40, 25);
+  std::vector<PlanQuery> queries;
+  for (int i = 0; i < 120; ++i)
+    queries.push_back(PlanQuery{Vec2i{static_cast<int>(rng() % 50), static_cast<int>(rng() % 40)}, Vec2i{i % 50, i / 50 * 7}});
+
+  PlanConfig cfg;
+  cfg.algorithm = Algorithm::FlowField;
+  ThreadPool pool(2);
+  BatchPlanner batch(pool);
+  const auto out = batch.plan(cfg, g, queries);
+  TEST_ASSERT(batch.flow_fields().size() == 0 && batch.flow_fields().bytes() == 0);
+  TEST_ASSERT(batch.stats().expanded > 0);
+  for (std::size_t i = 0; i < out.size(); ++i)
+  {
+    const auto ref = rescueops::planner::astar(g, queries[i].start, queries[i].goal);
+    TEST_ASSERT(out[i].has_value() == ref.has_value());
+    if (out[i]) TEST_ASSERT(out[i]->cost == ref->cost);
+  }
+
+  // With the threshold at one query, every goal gets its field.
+  cfg.flow_min_share = 1;
+  batch.plan(cfg, g, queries);
+  TEST_ASSERT(batch.flow_fields().size() == queries.size());
+}
+
+TEST_CASE(test_cache_budget_evicts_lru)
+{
+  Grid g;
+  g.w = 10;
+  g.h = 10;
+  g.blocked.assign(100, 0);
+  const std::size_t field_bytes = 100 * sizeof(std::uint16_t);
+
+  FlowFieldCache cache;
+  cache.set_budget_bytes(2 * field_bytes);
+  cache.get(g, Vec2i{0, 0});
+  cache.get(g, Vec2i{1, 0});
+  cache.get(g, Vec2i{0, 0}); // now (1,0) is the least recently used
+  cache.get(g, Vec2i{2, 0});
+  TEST_ASSERT(cache.size() == 2 && cache.bytes() == 2 * field_bytes);
+  TEST_ASSERT(cache.find(Vec2i{0, 0}) && cache.find(Vec2i{2, 0}) && !cache.find(Vec2i{1, 0}));
+
+  // prepare() never evicts fields its own goals need: the least shared goal goes without.
+  ThreadPool pool(1);
+  const Vec2i goals[] = {{5, 5}, {5, 5}, {5, 5}, {6, 6}, {6, 6}, {7, 7}, {7, 7}};
+  cache.prepare(g, goals, pool, 2);
+  TEST_ASSERT(cache.size() == 2 && cache.find(Vec2i{5, 5}));
+  TEST_ASSERT(cache.find(Vec2i{6, 6}) && !cache.find(Vec2i{7, 7}));
+
+  cache.set_budget_bytes(field_bytes);
+  TEST_ASSERT(cache.size() == 1 && cache.bytes() <= field_bytes);
+}
+
+TEST_CASE(test_long_maze_widens_distances)
+{
+  // A serpentine corridor: the far end lies more than 65534 steps away, beyond 16 bits.
+  Grid g;
+  g.w = 301;
+  g.h = 440;
+  g.blocked.assign(static_cast<std::size_t>(g.w * g.h), 0);
+  for (int y = 1; y < g.h; y += 2)
+  {
+    for (int x = 0; x < g.w; ++x) g.blocked[static_cast<std::size_t>(y * g.w + x)] = 1;
+    const int gap = (y / 2) % 2 == 0 ? g.w - 1 : 0;
+    g.blocked[static_cast<std::size_t>(y * g.w + gap)] = 0;
+  }
+  FlowField field;
+  field.build(g, Vec2i{0, 0});
+  const int rows = (g.h + 1) / 2;
+  const Vec2i end{(rows - 1) % 2 == 0 ? g.w - 1 : 0, g.h - 1};
+  const int expect = rows * (g.w - 1) + (g.h - 1);
+  TEST_ASSERT(expect > 65534);
+  TEST_ASSERT(field.distance(end) == expect);
+  TEST_ASSERT(field.memory_bytes() == g.blocked.size() * sizeof(int));
+  TEST_ASSERT(field.distance(Vec2i{5, 1}) == FlowField::kUnreachable);
+
+  FlowField small;
+  small.build(g, Vec2i{0, 0}); // rebuilding reuses the field
+  Grid open;
+  open.w = 30;
+  open.h = 20;
+  open.blocked.assign(600, 0);
+  small.build(open, Vec2i{29, 19});
+  TEST_ASSERT(small.memory_bytes() == 600 * sizeof(std::uint16_t) && small.distance(Vec2i{0, 0}) == 48);
+}
+
+int main()
+{
+  RUN_TEST(test_flow_field_matches_astar_costs);
+  RUN_TEST(test_flow_field_next_step);
+  RUN_TEST(test_cache_invalidation);
+  RUN_TEST(test_batch_groups_by_goal);
+  RUN_TEST(test_batch_distinct_goals_use_astar);
+  RUN_TEST(test_cache_budget_evicts_lru);
+  RUN_TEST(test_long_maze_widens_distances);
+  std::cout << "All flow field tests passed.\n";
+  return 0;
+}
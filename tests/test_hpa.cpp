@@ -0,0 +1,100 @@
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <random>
+
+#include "planner/hpa.hpp"
+
+using rescueops::planner::Grid;
+using rescueops::planner::HierarchicalPlanner;
+using rescueops::planner::PathResult;
+using rescueops::planner::SearchContext;
+using rescueops::planner::astar;
+using rescueops::sim::Vec2i;
+
+static bool path_is_valid(const Grid& g, const PathResult& r, Vec2i start, Vec2i goal)
+{
+  if (static_cast<int>(r.path.size()) != r.cost + 1) return false;
+  if (r.path.front().x != start.x || r.path.front().y != start.y) return false;
+  if (r.path.back().x != goal.x || r.path.back().y != goal.y) return false;
+  for (std::size_t i = 1; i < r.path.size(); ++i)
+  {
+    if (std::abs(r.path[i].x - r.path[i - 1].x) + std::abs(r.path[i].y - r.path[i - 1].y) != 1) return false;
+    if (g.is_blocked(r.path[i].x, r.path[i].y)) return false;
+  }
+  return true;
+}
+
+static Grid random_grid(std::mt19937& rng, int w, int h, unsigned density)
+{
+  Grid g;
+  g.w = w;
+  g.h = h;
+  g.blocked.resize(static_cast<std::size_t>(w * h));
+  for (auto& b : g.blocked) b = (rng() % 100) < density ? 1 : 0;
+  return g;
+}
+
+TEST_CASE(test_hpa_finds_path_iff_astar_does)
+{
+  std::mt19937 rng(11);
+  SearchContext a_ctx;
+  SearchContext h_ctx;
+  for (int round = 0; round < 200; ++round)
+  {
+    Grid g = random_grid(rng, 40, 30, 35);
+    HierarchicalPlanner hpa(8);
+    hpa.build(g, 2);
+    for (int q = 0; q < 10; ++q)
+    {
+      const Vec2i s{static_cast<int>(rng() % 40), static_cast<int>(rng() % 30)};
+      const Vec2i t{static_cast<int>(rng() % 40), static_cast<int>(rng() % 30)};
+      auto a = astar(g, s, t, a_ctx);
+      auto h = hpa.find_path(g, s, t, h_ctx);
+      TEST_ASSERT(a.has_value() == h.has_value());
+      if (!a) continue;
+      TEST_ASSERT(h->cost >= a->cost);
+      TEST_ASSERT(path_is_valid(g, *h, s, t));
+    }
+  }
+}
+
+TEST_CASE(test_hpa_update_matches_rebuild)
+{
+  std::mt19937 rng(5);
+  Grid g = random_grid(rng, 33, 21, 25);
+  HierarchicalPlanner incremental(6);
+  incremental.build(g);
+  SearchContext ctx;
+
+  for (int round = 0; round < 100; ++round)
+  {
+    std::vector<Vec2i> changed;
+    for (int k = 0; k < 4; ++k)
+    {
+      const Vec2i p{static_cast<int>(rng() % 33), static_cast<int>(rng() % 21)};
+      g.blocked[static_cast<std::size_t>(p.y * g.w + p.x)] ^= 1;
+      changed.push_back(p);
+    }
+    incremental.update(g, changed);
+
+    HierarchicalPlanner fresh(6);
+    fresh.build(g);
+    TEST_ASSERT(incremental.entrance_count() == fresh.entrance_count());
+
+    const Vec2i s{static_cast<int>(rng() % 33), static_cast<int>(rng() % 21)};
+    const Vec2i t{static_cast<int>(rng() % 33), static_cast<int>(rng() % 21)};
+    auto a = incremental.find_path(g, s, t, ctx);
+    auto b = fresh.find_path(g, s, t, ctx);
+    TEST_ASSERT(a.has_value() == b.has_value());
+    if (a) TEST_ASSERT(a->cost == b->cost);
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_hpa_finds_path_iff_astar_does);
+  RUN_TEST(test_hpa_update_matches_rebuild);
+  std::cout << "All HPA* tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "test_common.hpp"
+
+#include <cstdlib>
+#include <random>
+
+#include "planner/jps.hpp"
+
+using rescueops::planner::Grid;
+using rescueops::planner::SearchContext;
+using rescueops::planner::astar;
+using rescueops::planner::jps;
+using rescueops::sim::Vec2i;
+
+static bool path_is_valid(const Grid& g, const std::vector<Vec2i>& path, Vec2i start, Vec2i goal)
+{
+  if (path.empty()) return false;
+  if (path.front().x != start.x || path.front().y != start.y) return false;
+  if (path.back().x != goal.x || path.back().y != goal.y) return false;
+  for (std::size_t i = 1; i < path.size(); ++i)
+  {
+    if (std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1) return false;
+    if (g.is_blocked(path[i].x, path[i].y)) return false;
+  }
+  return true;
+}
+
+TEST_CASE(test_jps_wall_detour)
+{
+  Grid g;
+  g.w = 8;
+  g.h = 6;
+  g.blocked.assign(static_cast<std::size_t>(g.w * g.h), 0);
+  for (int y = 0; y < 5; ++y) g.blocked[static_cast<std::size_t>(y * g.w + 4)] = 1;
+
+  SearchContext ctx;
+  auto res = jps(g, Vec2i{0, 0}, Vec2i{7, 0}, ctx);
+  TEST_ASSERT(res.has_value());
+  TEST_ASSERT(res->cost == 17);
+  TEST_ASSERT(static_cast<int>(res->path.size()) == res->cost + 1);
+  TEST_ASSERT(path_is_valid(g, res->path, Vec2i{0, 0}, Vec2i{7, 0}));
+
+  g.blocked[static_cast<std::size_t>(5 * g.w + 4)] = 1;
+  TEST_ASSERT(!jps(g, Vec2i{0, 0}, Vec2i{7, 0}, ctx));
+}
+
+TEST_CASE(test_jps_matches_astar_cost)
+{
+  std::mt19937 rng(7);
+  SearchContext a_ctx;
+  SearchContext j_ctx;
+  for (int round = 0; round < 2000; ++round)
+  {
+    Grid g;
+    g.w = 1 + static_cast<int>(rng() % 16);
+    g.h = 1 + static_cast<int>(rng() % 16);
+    g.blocked.resize(static_cast<std::size_t>(g.w * g.h));
+    for (auto& b : g.blocked) b = (rng() % 100) < 30 ? 1 : 0;
+
+    const auto pick = [&] {
+      return Vec2i{static_cast<int>(rng() % static_cast<unsigned>(g.w)),
+                   static_cast<int>(rng() % static_cast<unsigned>(g.h))};
+    };
+    const Vec2i s = pick();
+    const Vec2i t = pick();
+
+    auto a = astar(g, s, t, a_ctx);
+    auto j = jps(g, s, t, j_ctx);
+    TEST_ASSERT(a.has_value() == j.has_value());
+    if (!a) continue;
+    TEST_ASSERT(a->cost == j->cost);
+    TEST_ASSERT(path_is_valid(g, j->path, s, t));
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_jps_wall_detour);
+  RUN_TEST(test_jps_matches_astar_cost);
+  std::cout << "All JPS tests passed.\n";
+  return 0;
+}
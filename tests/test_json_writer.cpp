@@ -0,0 +1,85 @@
+#include "test_common.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "sim/json_writer.hpp"
+#include "sim/scenario.hpp"
+
+using rescueops::sim::JsonWriter;
+
+TEST_CASE(test_numbers_and_literals)
+{
+  std::ostringstream s;
+  {
+    JsonWriter w(s);
+    w.number(0).put(' ').number(-17).put(' ').number(INT64_MIN).put(' ').number(UINT64_MAX);
+    w.put(' ').boolean(true).put(' ').boolean(false).spaces(3).raw("x");
+  }
+  TEST_ASSERT(s.str() == "0 -17 -9223372036854775808 18446744073709551615 true false   x");
+}
+
+TEST_CASE(test_string_escaping)
+{
+  std::ostringstream s;
+  JsonWriter w(s);
+  w.string("plain").put(',').string("a\"b\\c").put(',').string("t\tn\nr\r").put(',');
+  w.string(std::string_view("\x01\x1f\b\f", 4)).put(',').string("caf\xc3\xa9").put(',').string("");
+  TEST_ASSERT(w.flush());
+  TEST_ASSERT(s.str() == "\"plain\",\"a\\\"b\\\\c\",\"t\\tn\\nr\\r\",\"\\u0001\\u001f\\b\\f\",\"caf\xc3\xa9\",\"\"");
+
+  // What the writer escapes, the scenario parser reads back.
+  const std::string name = "unit \"7\"\\\n\x02";
+  std::ostringstream doc;
+  {
+    JsonWriter d(doc);
+    d.raw("{\"units\": [{\"name\": ").string(name).raw(", \"x\": 1, \"y\": 2}]}");
+  }
+  rescueops::sim::Scenario scenario;
+  TEST_ASSERT(rescueops::sim::parse_scenario(doc.str(), scenario));
+  TEST_ASSERT(scenario.world.units.size() == 1 && scenario.world.units[0].name == name);
+}
+
+TEST_CASE(test_small_buffer_and_bulk_writes)
+{
+  // Output is the same whatever the buffer size, including text larger than the buffer.
+  const std::string big(1000, 'z');
+  std::string expect;
+  std::ostringstream s;
+  {
+    JsonWriter w(s, 1); // rounded up to the minimum size
+    for (int i = 0; i < 500; ++i)
+    {
+      w.number(i * 1000003).put(',').spaces(static_cast<std::size_t>(i % 7)).string("k\"");
+      expect += std::to_string(i * 1000003) + "," + std::string(static_cast<std::size_t>(i % 7), ' ') + "\"k\\\"\"";
+      if (i % 100 == 0)
+      {
+        w.raw(big);
+        expect += big;
+      }
+    }
+    TEST_ASSERT(w.bytes_written() == expect.size());
+  }
+  TEST_ASSERT(s.str() == expect);
+}
+
+TEST_CASE(test_flush_reports_stream_failure)
+{
+  std::ostringstream s;
+  s.setstate(std::ios::badbit);
+  JsonWriter w(s);
+  w.raw("lost");
+  TEST_ASSERT(!w.flush());
+}
+
+int main()
+{
+  RUN_TEST(test_numbers_and_literals);
+  RUN_TEST(test_string_escaping);
+  RUN_TEST(test_small_buffer_and_bulk_writes);
+  RUN_TEST(test_flush_reports_stream_failure);
+  std::cout << "All JSON writer tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include "test_common.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/engine.hpp"
+#include "sim/monte_carlo.hpp"
+#include "sim/thread_pool.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::MonteCarlo;
+using rescueops::sim::MonteCarloConfig;
+using rescueops::sim::ThreadPool;
+using rescueops::sim::Unit;
+using rescueops::sim::Vec2i;
+
+static std::string base_snapshot()
+{
+  Engine eng;
+  eng.world().width = 30;
+  eng.world().height = 20;
+  for (std::uint32_t i = 0; i < 40; ++i)
+    eng.world().units.push_back(Unit{i + 1, std::to_string(i), Vec2i{15, 10}});
+  return eng.checkpoint();
+}
+
+// Sum of coordinates: depends on every step of the walk.
+static double position_sum(const Engine& eng)
+{
+  double s = 0;
+  for (const auto& u : eng.world().units) s += u.pos.x * 100 + u.pos.y;
+  return s;
+}
+
+TEST_CASE(test_runs_stream_in_seed_order_for_any_thread_count)
+{
+  const std::string base = base_snapshot();
+  MonteCarloConfig cfg;
+  cfg.first_seed = 500;
+  cfg.runs = 64;
+  cfg.ticks = 60;
+
+  std::vector<double> reference;
+  for (const unsigned threads : {1u, 3u, 8u})
+  {
+    ThreadPool pool(threads);
+    MonteCarlo mc({"sum"});
+    std::vector<double> seen;
+    const bool ok = mc.run(
+      base, cfg, pool, [](const Engine& eng, unsigned, std::span<double> m) { m[0] = position_sum(eng); },
+      [&](std::size_t run, std::uint64_t seed, std::span<const double> m) {
+        TEST_ASSERT(run == seen.size());
+        TEST_ASSERT(seed == cfg.first_seed + run);
+        seen.push_back(m[0]);
+      });
+    TEST_ASSERT(ok);
+    TEST_ASSERT(mc.runs() == cfg.runs);
+    if (reference.empty()) reference = seen;
+    TEST_ASSERT(seen == reference);
+  }
+
+  // Each run is exactly a fresh engine with that seed.
+  Engine single;
+  TEST_ASSERT(single.restore(base));
+  single.set_seed(cfg.first_seed + 17);
+  single.run(cfg.ticks);
+  TEST_ASSERT(position_sum(single) == reference[17]);
+}
+
+TEST_CASE(test_summary_statistics)
+{
+  const std::string base = base_snapshot();
+  MonteCarloConfig cfg;
+  cfg.first_seed = 1;
+  cfg.runs = 101;
+  cfg.ticks = 0;
+
+  ThreadPool pool(4);
+  MonteCarlo mc({"seed", "constant"});
+  // Metric = seed: 1..101, so mean 51, p50 51, p90 91, p99 100, sample stdev sqrt(101*102/12).
+  TEST_ASSERT(mc.run(
+    base, cfg, pool,
+    [](const Engine& eng, unsigned, std::span<double> m) {
+      m[0] = static_cast<double>(eng.seed());
+      m[1] = 7;
+    },
+    nullptr));
+  const auto s = mc.summary();
+  TEST_ASSERT(s.size() == 2 && s[0].name == "seed" && s[0].count == 101);
+  TEST_ASSERT(s[0].mean == 51 && s[0].min == 1 && s[0].max == 101);
+  TEST_ASSERT(s[0].p50 == 51 && s[0].p90 == 91 && s[0].p99 == 100);
+  TEST_ASSERT(std::abs(s[0].stdev - std::sqrt(101.0 * 102.0 / 12.0)) < 1e-9);
+  TEST_ASSERT(s[1].mean == 7 && s[1].stdev == 0 && s[1].p99 == 7);
+
+  TEST_ASSERT(!mc.run("not a snapshot", cfg, pool, nullptr, nullptr));
+}
+
+// A slow first run holds back at most `window` runs: the rest wait instead of piling up.
+TEST_CASE(test_window_bounds_waiting_runs)
+{
+  const std::string base = base_snapshot();
+  MonteCarloConfig cfg;
+  cfg.first_seed = 10;
+  cfg.runs = 40;
+  cfg.ticks = 5;
+  cfg.window = 3;
+
+  ThreadPool pool(4);
+  MonteCarlo mc({"sum"});
+  std::size_t emitted = 0;
+  const bool ok = mc.run(
+    base, cfg, pool,
+    [&](const Engine& eng, unsigned, std::span<double> m) {
+      if (eng.seed() == cfg.first_seed) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      m[0] = position_sum(eng);
+    },
+    [&](std::size_t run, std::uint64_t, std::span<const double>) { TEST_ASSERT(run == emitted++); });
+  TEST_ASSERT(ok && emitted == cfg.runs);
+  TEST_ASSERT(mc.peak_waiting() <= cfg.window - 1);
+}
+
+int main()
+{
+  RUN_TEST(test_runs_stream_in_seed_order_for_any_thread_count);
+  RUN_TEST(test_summary_statistics);
+  RUN_TEST(test_window_bounds_waiting_runs);
+  std::cout << "All monte carlo tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "models/motion.hpp"
+#include "sim/engine.hpp"
+#include "sim/philox.hpp"
+#include "sim/thread_pool.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::MotionRng;
+using rescueops::sim::PhiloxCounter;
+using rescueops::sim::ThreadPool;
+using rescueops::sim::Unit;
+using rescueops::sim::Vec2i;
+
+// Known-answer vectors from the Random123 distribution (kat_vectors, philox4x32 10 rounds).
+TEST_CASE(test_philox_known_answers)
+{
+  using rescueops::sim::philox4x32;
+  TEST_ASSERT((philox4x32({0, 0, 0, 0}, {0, 0}) == PhiloxCounter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  TEST_ASSERT((philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+               PhiloxCounter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  TEST_ASSERT((philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+               PhiloxCounter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+static void setup(Engine& eng, MotionRng rng, std::size_t units)
+{
+  eng.set_seed(7);
+  eng.set_motion_rng(rng);
+  eng.world().width = 64;
+  eng.world().height = 48;
+  for (std::uint32_t i = 0; i < units; ++i)
+    eng.world().units.push_back(Unit{i + 1, "u", Vec2i{static_cast<int>(i % 64), static_cast<int>(i % 48)}});
+}
+
+// A unit's trajectory depends only on (seed, id, tick): updating the columns in reverse chunks
+// gives the same positions as Engine::run.
+TEST_CASE(test_philox_walk_is_order_independent)
+{
+  constexpr std::size_t kUnits = 1000;
+  constexpr rescueops::sim::Tick kTicks = 100;
+  Engine eng;
+  setup(eng, MotionRng::Philox, kUnits);
+  eng.run(kTicks);
+
+  Engine ref;
+  setup(ref, MotionRng::Philox, kUnits);
+  auto& u = ref.world().units;
+  for (rescueops::sim::Tick t = 0; t < kTicks; ++t)
+  {
+    for (std::size_t end = kUnits; end > 0;)
+    {
+      const std::size_t begin = end > 37 ? end - 37 : 0;
+      rescueops::models::random_walk_tick(u.x().subspan(begin, end - begin), u.y().subspan(begin, end - begin),
+                                          u.ids().subspan(begin, end - begin), 7, t, 64, 48);
+      end = begin;
+    }
+  }
+
+  const auto& a = eng.world().units;
+  TEST_ASSERT(std::equal(a.x().begin(), a.x().end(), u.x().begin()));
+  TEST_ASSERT(std::equal(a.y().begin(), a.y().end(), u.y().begin()));
+
+  // Removing other units does not change a unit's walk.
+  Engine solo;
+  setup(solo, MotionRng::Philox, 0);
+  solo.world().units.push_back(Unit{500, "u", Vec2i{499 % 64, 499 % 48}});
+  solo.run(kTicks);
+  TEST_ASSERT(solo.world().units.pos(0).x == a.pos(499).x && solo.world().units.pos(0).y == a.pos(499).y);
+}
+
+TEST_CASE(test_philox_steps_are_uniform_and_clamped)
+{
+  constexpr std::size_t kUnits = 30000;
+  std::vector<int> xs(kUnits, 1), ys(kUnits, 0);
+  std::vector<std::uint32_t> ids(kUnits);
+  for (std::uint32_t i = 0; i < kUnits; ++i) ids[i] = i;
+  rescueops::models::random_walk_tick(xs, ys, ids, 3, 0, 3, 1);
+
+  std::size_t count[3] = {};
+  for (std::size_t i = 0; i < kUnits; ++i)
+  {
+    TEST_ASSERT(xs[i] >= 0 && xs[i] <= 2);
+    TEST_ASSERT(ys[i] == 0);
+    ++count[xs[i]];
+  }
+  for (const auto c : count) TEST_ASSERT(c > 9500 && c < 10500);
+}
+
+// Engine::run splits the Philox walk into row chunks across the pool once there are enough units.
+TEST_CASE(test_parallel_engine_walk_matches_serial)
+{
+  constexpr std::size_t kUnits = 20000;
+  constexpr rescueops::sim::Tick kTicks = 40;
+  Engine serial;
+  setup(serial, MotionRng::Philox, kUnits);
+  serial.run(kTicks);
+  for (const unsigned threads : {2u, 3u, 4u})
+  {
+    ThreadPool pool(threads);
+    Engine eng;
+    setup(eng, MotionRng::Philox, kUnits);
+    eng.set_thread_pool(&pool);
+    eng.run(kTicks);
+    const auto& a = serial.world().units;
+    const auto& b = eng.world().units;
+    TEST_ASSERT(std::equal(a.x().begin(), a.x().end(), b.x().begin()));
+    TEST_ASSERT(std::equal(a.y().begin(), a.y().end(), b.y().begin()));
+  }
+}
+
+// The compatibility mode is still the default and still draws from the engine's mt19937_64.
+TEST_CASE(test_mt19937_remains_default)
+{
+  Engine eng;
+  TEST_ASSERT(eng.motion_rng() == MotionRng::Mt19937);
+  TEST_ASSERT(rescueops::sim::parse_motion_rng("philox") == MotionRng::Philox);
+  TEST_ASSERT(!rescueops::sim::parse_motion_rng("xorshift"));
+
+  Engine a, b, fresh;
+  setup(a, MotionRng::Mt19937, 200);
+  setup(b, MotionRng::Philox, 200);
+  setup(fresh, MotionRng::Philox, 0);
+  a.run(10);
+  b.run(10);
+  fresh.run(10);
+  TEST_ASSERT(a.rng()() != fresh.rng()()); // only the compatibility walk consumes the generator
+  TEST_ASSERT(!std::equal(a.world().units.x().begin(), a.world().units.x().end(), b.world().units.x().begin()));
+}
+
+// The walk (vector kernel plus scalar tail) matches the reference formula per unit, for unit
+// counts around the kernel width, full 64-bit seeds and ticks, and positions at both edges.
+TEST_CASE(test_philox_walk_matches_reference)
+{
+  // Degenerate worlds pin every unit to 0 in both the vector body and the scalar tail
+  const std::pair<int, int> sizes[] = {{10, 6}, {0, 6}, {10, 0}, {0, 0}};
+  for (const auto& [width, height] : sizes)
+  {
+    for (const std::size_t units : {std::size_t{1}, std::size_t{7}, std::size_t{8}, std::size_t{9}, std::size_t{1003}})
+    {
+      for (const std::uint64_t tick : {std::uint64_t{0}, std::uint64_t{77}, (std::uint64_t{5} << 32) + 3})
+      {
+        const std::uint64_t seed = 0x9E3779B97F4A7C15ull ^ tick;
+        std::vector<int> xs(units), ys(units);
+        std::vector<std::uint32_t> ids(units);
+        for (std::size_t i = 0; i < units; ++i)
+        {
+          ids[i] = static_cast<std::uint32_t>(i * 2654435761u);
+          xs[i] = static_cast<int>(i % 3 == 0 ? 0 : i % 3 == 1 ? 9 : i % 10);
+          ys[i] = static_cast<int>(i % 4 == 0 ? 0 : i % 4 == 1 ? 5 : i % 6);
+        }
+        std::vector<int> ex = xs, ey = ys;
+        for (std::size_t i = 0; i < units; ++i)
+        {
+          const auto r = rescueops::sim::counter_random(seed, ids[i], tick, rescueops::sim::RngStream::Motion);
+          ex[i] = std::max(0, std::min(width - 1, ex[i] + static_cast<int>((std::uint64_t{r[0]} * 3) >> 32) - 1));
+          ey[i] = std::max(0, std::min(height - 1, ey[i] + static_cast<int>((std::uint64_t{r[1]} * 3) >> 32) - 1));
+        }
+        rescueops::models::random_walk_tick(xs, ys, ids, seed, tick, width, height);
+        TEST_ASSERT(xs == ex && ys == ey);
+        if (width == 0) TEST_ASSERT(std::all_of(xs.begin(), xs.end(), [](int x) { return x == 0; }));
+        if (height == 0) TEST_ASSERT(std::all_of(ys.begin(), ys.end(), [](int y) { return y == 0; }));
+      }
+    }
+  }
+}
+
+int main()
+{
+  RUN_TEST(test_philox_known_answers);
+  RUN_TEST(test_philox_walk_is_order_independent);
+  RUN_TEST(test_philox_steps_are_uniform_and_clamped);
+  RUN_TEST(test_philox_walk_matches_reference);
+  RUN_TEST(test_parallel_engine_walk_matches_serial);
+  RUN_TEST(test_mt19937_remains_default);
+  std::cout << "All motion tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "test_common.hpp"
+
+#include <climits>
+#include <vector>
+
+#include "sim/obstacles.hpp"
+
+using rescueops::sim::ObstacleLayer;
+using rescueops::sim::Scenario;
+
+// Reference: the former per-cell rasterizer.
+static void reference_rect(std::vector<std::uint8_t>& grid, int w, int h, int x, int y, int rw, int rh)
+{
+  for (int yy = 0; yy < rh; ++yy)
+    for (int xx = 0; xx < rw; ++xx)
+    {
+      const long long cx = static_cast<long long>(x) + xx;
+      const long long cy = static_cast<long long>(y) + yy;
+      if (cx >= 0 && cy >= 0 && cx < w && cy < h) grid[static_cast<std::size_t>(cy * w + cx)] = 1;
+    }
+}
+
+TEST_CASE(test_fill_rect_clips)
+{
+  const int w = 10, h = 6;
+  std::vector<std::uint8_t> grid(w * h, 0);
+  rescueops::sim::fill_rect(grid, w, h, -3, -2, 5, 4);     // top-left corner
+  rescueops::sim::fill_rect(grid, w, h, 8, 4, 100, 100);   // bottom-right corner
+  rescueops::sim::fill_rect(grid, w, h, 4, 0, 0, 5);       // empty
+  rescueops::sim::fill_rect(grid, w, h, 20, 0, 3, 3);      // outside
+  rescueops::sim::fill_rect(grid, w, h, INT_MAX - 1, 0, INT_MAX, 1); // no overflow
+
+  std::vector<std::uint8_t> expect(w * h, 0);
+  reference_rect(expect, w, h, -3, -2, 5, 4);
+  reference_rect(expect, w, h, 8, 4, 100, 100);
+  TEST_ASSERT(grid == expect);
+  TEST_ASSERT(rescueops::sim::count_blocked(grid) == 4 + 4);
+}
+
+TEST_CASE(test_fill_layer_runs_cross_rows)
+{
+  const int w = 8, h = 5;
+  std::vector<std::uint8_t> grid(w * h, 0);
+  // 3x3 layer at (6, 3): runs free 2, blocked 3, free 1, blocked 10 (past the 9 cells)
+  ObstacleLayer layer;
+  layer.x = 6;
+  layer.y = 3;
+  layer.width = 3;
+  layer.height = 3;
+  layer.runs = {2, 3, 1, 10};
+  rescueops::sim::fill_layer(grid, w, h, layer);
+
+  // Layer cells 2..4 and 6..8 are blocked: (2,0) (0,1) (1,1) (0,2) (1,2) (2,2). Clipped to x < 8
+  // and y < 5, that leaves (0,1) (1,1) -> grid (6,4) (7,4); row 2 is off the grid.
+  std::vector<std::uint8_t> expect(w * h, 0);
+  expect[4 * w + 6] = 1;
+  expect[4 * w + 7] = 1;
+  TEST_ASSERT(grid == expect);
+}
+
+TEST_CASE(test_rasterize_matches_per_cell_reference)
+{
+  const int w = 131, h = 77;
+  Scenario s;
+  std::vector<std::uint8_t> expect(w * h, 0);
+  std::uint64_t state = 12345;
+  const auto next = [&](int mod) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return static_cast<int>((state >> 33) % static_cast<std::uint64_t>(mod));
+  };
+  for (int i = 0; i < 200; ++i)
+  {
+    const rescueops::sim::ObstacleRect r{next(w + 20) - 10, next(h + 20) - 10, next(30), next(30)};
+    s.obstacles.push_back(r);
+    reference_rect(expect, w, h, r.x, r.y, r.w, r.h);
+  }
+  ObstacleLayer layer;
+  layer.x = -5;
+  layer.y = 10;
+  layer.width = 60;
+  layer.height = 40;
+  for (int i = 0; i < 300; ++i) layer.runs.push_back(static_cast<std::uint32_t>(next(25)));
+  long long pos = 0;
+  for (std::size_t i = 0; i < layer.runs.size(); ++i)
+  {
+    for (std::uint32_t k = 0; k < layer.runs[i] && pos < 60 * 40; ++k, ++pos)
+      if (i % 2 == 1) reference_rect(expect, w, h, layer.x + static_cast<int>(pos % 60), layer.y + static_cast<int>(pos / 60), 1, 1);
+  }
+  s.obstacle_layers.push_back(layer);
+
+  std::vector<std::uint8_t> grid(w * h, 0);
+  const auto count = rescueops::sim::rasterize_obstacles(s, w, h, grid);
+  TEST_ASSERT(grid == expect);
+  std::size_t n = 0;
+  for (const auto c : expect) n += c;
+  TEST_ASSERT(count == n);
+}
+
+int main()
+{
+  RUN_TEST(test_fill_rect_clips);
+  RUN_TEST(test_fill_layer_runs_cross_rows);
+  RUN_TEST(test_rasterize_matches_per_cell_reference);
+  std::cout << "All obstacle tests passed.\n";
+  return 0;
+}
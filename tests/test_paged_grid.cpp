@@ -0,0 +1,190 @@
+#include "test_common.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "planner/astar.hpp"
+#include "planner/paged_grid.hpp"
+#include "sim/obstacles.hpp"
+
+using rescueops::planner::Grid;
+using rescueops::planner::PagedGrid;
+using rescueops::planner::SearchContext;
+using rescueops::sim::Vec2i;
+
+static std::string temp_path(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// 300x200 maze-like grid: walls every 8 rows with gaps, a fully blocked 64x64 square, and a
+// ragged right edge so edge tiles are partial.
+static Grid make_grid()
+{
+  Grid g;
+  g.w = 300;
+  g.h = 200;
+  g.blocked.assign(static_cast<std::size_t>(g.w) * g.h, 0);
+  for (int y = 8; y < g.h; y += 8)
+    for (int x = 0; x < g.w; ++x)
+      if ((x + y * 3) % 37 > 2) g.blocked[static_cast<std::size_t>(y) * g.w + x] = 1;
+  for (int y = 128; y < 192; ++y)
+    for (int x = 64; x < 128; ++x) g.blocked[static_cast<std::size_t>(y) * g.w + x] = 1;
+  return g;
+}
+
+TEST_CASE(test_queries_match_resident_grid)
+{
+  const Grid g = make_grid();
+  const std::string path = temp_path("rescueops_test_paged.tiles");
+  TEST_ASSERT(rescueops::planner::write_tile_file(path, g, 64));
+
+  PagedGrid p;
+  std::string error;
+  TEST_ASSERT(p.open(path, 2 * 64 * 64 / 8, &error)); // two tiles
+  TEST_ASSERT(p.width() == 300 && p.height() == 200 && p.tile_size() == 64 && p.tile_capacity() == 2);
+  std::size_t blocked = 0;
+  for (const auto c : g.blocked) blocked += c;
+  TEST_ASSERT(p.blocked_count() == blocked);
+
+  for (int y = 0; y < g.h; ++y)
+    for (int x = 0; x < g.w; ++x) TEST_ASSERT(p.is_blocked(x, y) == g.is_blocked(x, y));
+  TEST_ASSERT(p.stats().resident_tiles == 2);
+  TEST_ASSERT(p.stats().evictions == p.stats().misses - 2);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_astar_matches_resident_grid)
+{
+  const Grid g = make_grid();
+  const std::string path = temp_path("rescueops_test_paged_astar.tiles");
+  TEST_ASSERT(rescueops::planner::write_tile_file(path, g, 64));
+  PagedGrid p;
+  TEST_ASSERT(p.open(path, 1)); // budget below one tile: a single slot
+
+  SearchContext dense;
+  SearchContext sparse;
+  const Vec2i queries[][2] = {{{0, 0}, {299, 199}}, {{5, 3}, {250, 120}}, {{299, 0}, {0, 199}}, {{0, 0}, {70, 130}}};
+  for (const auto& q : queries)
+  {
+    const auto a = rescueops::planner::astar(g, q[0], q[1], dense);
+    const auto b = rescueops::planner::astar(p, q[0], q[1], sparse);
+    TEST_ASSERT(a.has_value() == b.has_value());
+    if (!a) continue;
+    TEST_ASSERT(a->cost == b->cost && a->path.size() == b->path.size());
+    for (std::size_t i = 0; i < a->path.size(); ++i)
+      TEST_ASSERT(a->path[i].x == b->path[i].x && a->path[i].y == b->path[i].y);
+    TEST_ASSERT(dense.stats().expanded == sparse.stats().expanded);
+  }
+  TEST_ASSERT(p.stats().misses > 1 && p.stats().resident_tiles == 1);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_cache_counters)
+{
+  const Grid g = make_grid();
+  const std::string path = temp_path("rescueops_test_paged_counters.tiles");
+  TEST_ASSERT(rescueops::planner::write_tile_file(path, g, 64));
+  PagedGrid p;
+  TEST_ASSERT(p.open(path, 2 * 512));
+
+  // Tiles (0, 0), (1, 0) and (2, 0) hold data; (1, 2) is the all-blocked square.
+  TEST_ASSERT(p.is_blocked(80, 150));
+  TEST_ASSERT(p.stats().hits == 0 && p.stats().misses == 0);
+  p.is_blocked(0, 0);   // miss (0, 0)
+  p.is_blocked(1, 0);   // hit
+  p.is_blocked(64, 0);  // miss (1, 0)
+  p.is_blocked(0, 8);   // hit, (0, 0) becomes most recent
+  p.is_blocked(128, 8); // miss (2, 0), evicts (1, 0)
+  p.is_blocked(0, 0);   // hit
+  p.is_blocked(64, 8);  // miss (1, 0), evicts (2, 0)
+  TEST_ASSERT(p.stats().hits == 3 && p.stats().misses == 4 && p.stats().evictions == 2);
+  TEST_ASSERT(p.stats().resident_tiles == 2);
+  TEST_ASSERT(p.is_blocked(64, 8) == g.is_blocked(64, 8) && p.is_blocked(1, 8) == g.is_blocked(1, 8));
+
+  p.reset_stats();
+  TEST_ASSERT(p.stats().hits == 0 && p.stats().misses == 0 && p.stats().resident_tiles == 2);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_rejects_damaged_files)
+{
+  const Grid g = make_grid();
+  const std::string path = temp_path("rescueops_test_paged_damaged.tiles");
+  TEST_ASSERT(rescueops::planner::write_tile_file(path, g, 64));
+  std::string image;
+  {
+    std::ifstream in(path, std::ios::binary);
+    image.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  const auto write = [&](const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << bytes;
+  };
+
+  PagedGrid p;
+  std::string error;
+  write(image.substr(0, image.size() - 8));
+  TEST_ASSERT(!p.open(path, 1 << 20, &error) && !p.is_open());
+
+  std::string bad = image;
+  bad[8] = 2; // version
+  write(bad);
+  TEST_ASSERT(!p.open(path, 1 << 20, &error));
+  TEST_ASSERT(error.find("version") != std::string::npos);
+
+  bad = image;
+  bad[64 + 6] = 0x7f; // first tile offset far past the end
+  write(bad);
+  TEST_ASSERT(!p.open(path, 1 << 20, &error));
+
+  write(image);
+  TEST_ASSERT(p.open(path, 1 << 20, &error));
+  TEST_ASSERT(!rescueops::planner::write_tile_file(path, g, 100, &error)); // not a power of two
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_banded_rasterization)
+{
+  // A tile file written band by band from the scenario matches the whole-grid rasterization.
+  rescueops::sim::Scenario s;
+  s.obstacles.push_back(rescueops::sim::ObstacleRect{-4, 60, 200, 10});
+  s.obstacles.push_back(rescueops::sim::ObstacleRect{100, 0, 3, 190});
+  rescueops::sim::ObstacleLayer layer;
+  layer.x = 150;
+  layer.y = 120;
+  layer.width = 20;
+  layer.height = 20;
+  layer.runs = {5, 30, 7, 100, 3, 9};
+  s.obstacle_layers.push_back(layer);
+
+  Grid g;
+  g.w = 190;
+  g.h = 170;
+  g.blocked.assign(static_cast<std::size_t>(g.w) * g.h, 0);
+  rescueops::sim::rasterize_obstacles(s, g.w, g.h, g.blocked);
+
+  const std::string path = temp_path("rescueops_test_paged_bands.tiles");
+  TEST_ASSERT(rescueops::planner::write_tile_file(
+    path, g.w, g.h, 64, [&](int y0, int rows, std::span<std::uint8_t> band) {
+      rescueops::sim::rasterize_obstacles(s, g.w, rows, band, y0);
+    }));
+  PagedGrid p;
+  TEST_ASSERT(p.open(path, 1 << 20));
+  for (int y = 0; y < g.h; ++y)
+    for (int x = 0; x < g.w; ++x) TEST_ASSERT(p.is_blocked(x, y) == g.is_blocked(x, y));
+  std::filesystem::remove(path);
+}
+
+int main()
+{
+  RUN_TEST(test_queries_match_resident_grid);
+  RUN_TEST(test_astar_matches_resident_grid);
+  RUN_TEST(test_cache_counters);
+  RUN_TEST(test_rejects_damaged_files);
+  RUN_TEST(test_banded_rasterization);
+  std::cout << "All paged grid tests passed.\n";
+  return 0;
+}
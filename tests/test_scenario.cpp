@@ -0,0 +1,138 @@
+#include "test_common.hpp"
+
+#include <string>
+
+#include "sim/engine.hpp"
+#include "sim/scenario.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::parse_scenario;
+using rescueops::sim::Scenario;
+
+TEST_CASE(test_parse_full_scenario)
+{
+  const std::string text = R"({
+    "name": "demo", "seed": 7, "ticks": 120,
+    "world": {"width": 40, "height": 20},
+    "units": [
+      {"name": "alpha", "x": 1, "y": 2},
+      {"name": "bravo", "x": -3, "y": 4.75, "speed": 1.5}
+    ],
+    "targets": [{"unit": "bravo", "tx": 12, "ty": 7}],
+    "obstacles": [{"x": 16, "y": 0, "w": 1, "h": 8}, {"x": 10, "y": 10}, {"x": 2, "y": 3, "w": 5}],
+    "notes": {"tags": ["a", "b"], "ok": true, "v": null}
+  })";
+  Scenario s;
+  TEST_ASSERT(parse_scenario(text, s));
+  TEST_ASSERT(s.seed == 7 && s.ticks == 120);
+  TEST_ASSERT(s.world.width == 40 && s.world.height == 20);
+  TEST_ASSERT(s.world.units.size() == 2);
+  TEST_ASSERT(s.world.units[0].id == 1 && s.world.units[0].name == "alpha");
+  TEST_ASSERT(s.world.units[1].id == 2 && s.world.units[1].pos.x == -3 && s.world.units[1].pos.y == 4);
+  TEST_ASSERT(s.targets.size() == 1 && s.targets[0].unit == "bravo");
+  TEST_ASSERT(s.targets[0].tx == 12 && s.targets[0].ty == 7);
+  TEST_ASSERT(s.obstacles.size() == 3);
+  TEST_ASSERT(s.obstacles[0].w == 1 && s.obstacles[0].h == 8);
+  TEST_ASSERT(s.obstacles[1].w == 1 && s.obstacles[1].h == 1);
+  TEST_ASSERT(s.obstacles[2].w == 1 && s.obstacles[2].h == 1); // w without h: single cell
+}
+
+TEST_CASE(test_parse_obstacle_layers)
+{
+  Scenario s;
+  TEST_ASSERT(parse_scenario(R"({"obstacle_layers": [
+                                   {"x": 2, "y": 1, "width": 4, "height": 2, "runs": [1, 2, 3, 2]},
+                                   {"width": 3, "height": 1, "runs": []},
+                                   {"width": 3, "runs": [1, 1]}
+                                 ]})",
+                             s));
+  TEST_ASSERT(s.obstacle_layers.size() == 2);
+  const auto& l = s.obstacle_layers[0];
+  TEST_ASSERT(l.x == 2 && l.y == 1 && l.width == 4 && l.height == 2);
+  TEST_ASSERT(l.runs.size() == 4 && l.runs[2] == 3);
+  TEST_ASSERT(s.obstacle_layers[1].runs.empty() && s.obstacle_layers[1].x == 0);
+
+  TEST_ASSERT(!parse_scenario(R"({"obstacle_layers": [{"width": 1, "height": 1, "runs": [-1]}]})", s));
+  TEST_ASSERT(!parse_scenario(R"({"obstacle_layers": [{"width": 1, "height": 1, "runs": ["a"]}]})", s));
+}
+
+TEST_CASE(test_defaults_and_incomplete_entries)
+{
+  Scenario s;
+  TEST_ASSERT(parse_scenario(R"({"units": [{"name": "x", "x": 1}], "targets": [{"unit": "x"}],})", s));
+  TEST_ASSERT(s.seed == 42 && s.world.width == 32 && s.world.height == 18);
+  TEST_ASSERT(s.world.units.size() == 1 && s.world.units[0].name == "alpha");
+  TEST_ASSERT(s.targets.empty());
+
+  TEST_ASSERT(parse_scenario(R"({"units": [{"name": "", "x": 0, "y": 0}, {"name": "", "x": 1, "y": 1}]})", s));
+  TEST_ASSERT(s.world.units[0].name == "unit_1" && s.world.units[1].name == "unit_2");
+}
+
+TEST_CASE(test_escaped_names_are_decoded)
+{
+  Scenario s;
+  TEST_ASSERT(parse_scenario(R"({"units": [{"name": "a\"bé", "x": 0, "y": 0}],
+                                 "targets": [{"unit": "a\"b\u00e9", "tx": 1, "ty": 1}, {"unit": "alpha", "tx": 2, "ty": 2}]})",
+                             s));
+  TEST_ASSERT(s.world.units[0].name == "a\"b\xc3\xa9");
+  TEST_ASSERT(s.targets.size() == 2 && s.targets[0].unit == s.world.units[0].name);
+
+  // Target names stay valid after the scenario is moved
+  Scenario moved = std::move(s);
+  TEST_ASSERT(moved.targets[0].unit == "a\"b\xc3\xa9" && moved.targets[1].unit == "alpha");
+}
+
+TEST_CASE(test_malformed_input_is_reported)
+{
+  Scenario s;
+  std::string error;
+  TEST_ASSERT(!parse_scenario(R"({"seed": 1, "units": [{"name": "a", "x": 1, "y": 2})", s, &error));
+  TEST_ASSERT(!error.empty());
+  TEST_ASSERT(!parse_scenario(R"({"name": "unterminated)", s));
+  TEST_ASSERT(!parse_scenario(R"({"seed": 99999999999999999999999})", s));
+  TEST_ASSERT(!parse_scenario(R"({"seed": 18446744073709551616})", s));
+  TEST_ASSERT(!parse_scenario(R"({"seed": -1})", s, &error));
+  TEST_ASSERT(!parse_scenario(R"({"a": 1} x)", s));
+  TEST_ASSERT(!parse_scenario("[1, 2]", s));
+}
+
+TEST_CASE(test_engine_load_starts_new_timeline)
+{
+  Scenario s;
+  TEST_ASSERT(parse_scenario(R"({"seed": 9, "world": {"width": 8, "height": 8},
+                                 "units": [{"name": "a", "x": 4, "y": 4}]})",
+                             s));
+  Engine eng;
+  eng.run(10);
+  eng.load(s);
+  TEST_ASSERT(eng.seed() == 9 && eng.tick() == 0);
+  TEST_ASSERT(eng.world().width == 8 && eng.world().units.size() == 1);
+  TEST_ASSERT(eng.world().units.pos(0).x == 4);
+}
+
+TEST_CASE(test_seed_spans_full_u64_range)
+{
+  Scenario s;
+  TEST_ASSERT(parse_scenario(R"({"seed": 18446744073709551615, "units": [{"name": "a", "x": 1, "y": 1}]})", s));
+  TEST_ASSERT(s.seed == 18446744073709551615ull);
+  Engine eng;
+  eng.load(s);
+  TEST_ASSERT(eng.seed() == 18446744073709551615ull);
+
+  TEST_ASSERT(parse_scenario(R"({"seed": 9223372036854775808})", s));
+  TEST_ASSERT(s.seed == 9223372036854775808ull);
+  TEST_ASSERT(parse_scenario(R"({"seed": "x"})", s) && s.seed == 42);
+}
+
+int main()
+{
+  RUN_TEST(test_parse_full_scenario);
+  RUN_TEST(test_parse_obstacle_layers);
+  RUN_TEST(test_defaults_and_incomplete_entries);
+  RUN_TEST(test_escaped_names_are_decoded);
+  RUN_TEST(test_malformed_input_is_reported);
+  RUN_TEST(test_engine_load_starts_new_timeline);
+  RUN_TEST(test_seed_spans_full_u64_range);
+  std::cout << "All scenario tests passed.\n";
+  return 0;
+}
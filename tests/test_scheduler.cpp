@@ -1,32 +1,475 @@
 #include "test_common.hpp"
 
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+
 #include "sim/scheduler.hpp"
+#include "sim/thread_pool.hpp"
+
+// Test hook: count every global allocation made by this binary.
+static std::atomic<std::size_t> g_allocations{0};
+
+void* operator new(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
 
+using rescueops::sim::EventQueue;
 using rescueops::sim::Scheduler;
+using rescueops::sim::ThreadPool;
 using rescueops::sim::Tick;
 
 TEST_CASE(test_scheduler_order)
 {
+  for (EventQueue kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    Scheduler s(kind);
+    std::string log;
+
+    s.schedule(10, [&] { log += "A"; });
+    s.schedule(5, [&] { log += "B"; });
+    s.schedule(10, [&] { log += "C"; }); // same tick as A, should run after A because scheduled later
+
+    s.run_due(4);
+    TEST_ASSERT(log.empty());
+
+    s.run_due(5);
+    TEST_ASSERT(log == "B");
+
+    s.run_due(10);
+    TEST_ASSERT(log == "BAC");
+  }
+}
+
+// Random mix of near, far (past the wheel horizon) and late (already passed) events, some of
+// which schedule more events while running: both queues must produce the same trace.
+static std::vector<std::uint64_t> random_trace(EventQueue kind, std::uint64_t seed)
+{
+  Scheduler s(kind);
+  std::mt19937_64 rng(seed);
+  std::vector<std::uint64_t> trace;
+  std::uint64_t next_id = 0;
+  Tick now = 0;
+
+  const auto pick_tick = [&](Tick base) -> Tick {
+    switch (rng() % 6)
+    {
+    case 0:
+      return base;
+    case 1:
+      return base > 10 ? base - rng() % 10 : 0; // late
+    case 2:
+      return base + rng() % 70000;             // crosses levels 0..2
+    case 3:
+      return base + (Tick{1} << 32) + rng() % 1000; // beyond the horizon
+    default:
+      return base + rng() % 300;
+    }
+  };
+
+  std::function<void(std::uint64_t)> add = [&](std::uint64_t depth) {
+    const std::uint64_t id = next_id++;
+    const Tick at = pick_tick(now);
+    s.schedule(at, [&, id, depth] {
+      trace.push_back(id);
+      trace.push_back(now);
+      if (depth < 3 && rng() % 3 == 0) add(depth + 1);
+    });
+  };
+
+  for (int step = 0; step < 400; ++step)
+  {
+    for (int k = static_cast<int>(rng() % 5); k > 0; --k) add(0);
+    const auto r = rng() % 10;
+    now += r < 6 ? rng() % 3 : r < 9 ? rng() % 400 : rng() % 100000;
+    s.run_due(now);
+  }
+  // Drain: nested events keep landing past `now`, but depth is bounded.
+  for (int round = 0; round < 8 && s.pending() > 0; ++round)
+  {
+    now += Tick{1} << 34;
+    s.run_due(now);
+  }
+  TEST_ASSERT(s.pending() == 0);
+  return trace;
+}
+
+TEST_CASE(test_timing_wheel_matches_heap)
+{
+  for (std::uint64_t seed = 1; seed <= 40; ++seed)
+  {
+    const auto heap = random_trace(EventQueue::BinaryHeap, seed);
+    const auto wheel = random_trace(EventQueue::TimingWheel, seed);
+    TEST_ASSERT(!heap.empty());
+    TEST_ASSERT(heap == wheel);
+  }
+}
+
+TEST_CASE(test_pending_counts)
+{
+  Scheduler s(EventQueue::TimingWheel);
+  for (Tick t = 0; t < 1000; ++t) s.schedule(t * 37, [] {});
+  TEST_ASSERT(s.pending() == 1000);
+  s.run_due(37 * 499);
+  TEST_ASSERT(s.pending() == 500);
+  s.run_due(37 * 999);
+  TEST_ASSERT(s.pending() == 0);
+}
+
+// Steady state: every event reschedules itself. After a warm-up has grown the arena and the
+// queue storage to the peak pending count, the hot loop must not allocate at all.
+TEST_CASE(test_steady_state_does_not_allocate)
+{
+  for (EventQueue kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    Scheduler s(kind);
+    Tick now = 0;
+    std::uint64_t fired = 0;
+
+    struct Rearm
+    {
+      Scheduler* s;
+      const Tick* now;
+      std::uint64_t* fired;
+      Tick delay;
+
+      void operator()() const
+      {
+        ++*fired;
+        s->schedule(*now + delay, *this);
+      }
+    };
+
+    for (Tick i = 0; i < 5000; ++i) s.schedule(i % 700, Rearm{&s, &now, &fired, 1 + i % 300});
+    for (; now < 3000; ++now) s.run_due(now);
+
+    const std::size_t before = g_allocations.load();
+    const std::uint64_t fired_before = fired;
+    for (; now < 20000; ++now) s.run_due(now);
+    TEST_ASSERT(fired - fired_before > 100000);
+    TEST_ASSERT(g_allocations.load() == before);
+    TEST_ASSERT(s.pending() == 5000);
+    TEST_ASSERT(s.arena().live() == 5000);
+  }
+}
+
+// A periodic event must fire exactly like its occurrences scheduled one by one up front,
+// interleaved with one-shot events scheduled before, after and from inside it.
+static std::vector<int> periodic_trace(bool native, EventQueue kind)
+{
+  Scheduler s(kind);
+  std::vector<int> log;
+  const auto one_shot = [&](Tick at, int tag) { s.schedule(at, [&log, tag] { log.push_back(tag); }); };
+
+  one_shot(0, 1);
+  one_shot(100, 2);
+  if (native)
+  {
+    s.schedule_every(50, 0, [&log] { log.push_back(0); }, 1000);
+    s.schedule_every(7, 3, [&log] { log.push_back(9); }, 200);
+  }
+  else
+  {
+    for (Tick t = 0; t <= 1000; t += 50) s.schedule(t, [&log] { log.push_back(0); });
+    for (Tick t = 3; t <= 200; t += 7) s.schedule(t, [&log] { log.push_back(9); });
+  }
+  one_shot(100, 3);
+  one_shot(150, 4);
+
+  for (Tick now = 0; now < 1100; now += 13)
+  {
+    if (now % 100 == 0) one_shot(now + 50, 5); // collides with heartbeat ticks
+    s.run_due(now);
+  }
+  return log;
+}
+
+TEST_CASE(test_periodic_matches_prescheduled)
+{
+  for (EventQueue kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    const auto pre = periodic_trace(false, kind);
+    const auto native = periodic_trace(true, kind);
+    TEST_ASSERT(pre.size() > 40);
+    TEST_ASSERT(pre == native);
+  }
+}
+
+TEST_CASE(test_periodic_memory_and_cancel)
+{
+  for (EventQueue kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    Scheduler s(kind);
+    int fired = 0;
+    const auto h = s.schedule_every(3, 1, [&fired] { ++fired; });
+    for (Tick t = 0; t < 100000; ++t) s.run_due(t);
+    TEST_ASSERT(fired == 33333);
+    TEST_ASSERT(s.pending() == 1);
+    TEST_ASSERT(s.arena().live() == 1);
+
+    TEST_ASSERT(s.cancel(h));
+    TEST_ASSERT(!s.cancel(h));
+    TEST_ASSERT(s.pending() == 0);
+    for (Tick t = 100000; t < 100010; ++t) s.run_due(t);
+    TEST_ASSERT(fired == 33333);
+    TEST_ASSERT(s.arena().live() == 0);
+
+    // Stale handle: the node has been recycled for another event.
+    int other = 0;
+    s.schedule(100020, [&other] { ++other; });
+    TEST_ASSERT(!s.cancel(h));
+    s.run_due(100020);
+    TEST_ASSERT(other == 1);
+
+    // End tick is inclusive; a periodic event may cancel itself while running.
+    int bounded = 0;
+    s.schedule_every(10, 200000, [&bounded] { ++bounded; }, 200050);
+    rescueops::sim::EventHandle self;
+    int self_runs = 0;
+    self = s.schedule_every(1, 200000, [&] {
+      if (++self_runs == 3) s.cancel(self);
+    });
+    for (Tick t = 200000; t < 200200; ++t) s.run_due(t);
+    TEST_ASSERT(bounded == 6);
+    TEST_ASSERT(self_runs == 3);
+    TEST_ASSERT(s.pending() == 0);
+  }
+}
+
+// Per-unit events (declared, mostly independent), pairwise "comms" events touching two units,
+// and an undeclared order-sensitive audit. Any thread count must reproduce the serial run.
+struct UnitSim
+{
+  std::vector<std::uint64_t> state;
+  std::vector<std::uint64_t> audit;
+  std::size_t parallel_events = 0;
+};
+
+static UnitSim unit_sim(EventQueue kind, unsigned threads)
+{
+  constexpr std::uint32_t kUnits = 600;
+  constexpr std::uint32_t kUnitKey = 1;
+  constexpr std::uint32_t kConfigKey = 2;
+
+  Scheduler s(kind);
+  ThreadPool pool(threads);
+  if (threads > 1) s.set_thread_pool(&pool);
+
+  UnitSim sim;
+  sim.state.resize(kUnits);
+  for (std::uint32_t u = 0; u < kUnits; ++u) sim.state[u] = u * 2654435761u;
+  const std::uint64_t config = 12345;
+
+  struct Step
+  {
+    Scheduler* s;
+    UnitSim* sim;
+    const std::uint64_t* config;
+    const Tick* now;
+    std::uint32_t unit;
+
+    void operator()() const
+    {
+      auto& x = sim->state[unit];
+      for (int k = 0; k < 50; ++k) x = x * 6364136223846793005ull + *config + static_cast<std::uint64_t>(k);
+      if (*now < 300)
+      {
+        rescueops::sim::EventAccess access;
+        access.write(rescueops::sim::access_key(kUnitKey, unit)).read(rescueops::sim::access_key(kConfigKey, 0));
+        s->schedule(*now + 1 + x % 4, access, *this);
+      }
+    }
+  };
+
+  Tick now = 0;
+  for (std::uint32_t u = 0; u < kUnits; ++u)
+  {
+    rescueops::sim::EventAccess access;
+    access.write(rescueops::sim::access_key(kUnitKey, u)).read(rescueops::sim::access_key(kConfigKey, 0));
+    s.schedule(u % 3, access, Step{&s, &sim, &config, &now, u});
+  }
+
+  // Comms: swap-mix two units every 7 ticks (conflicts with both units' steps).
+  for (std::uint32_t u = 0; u + 1 < kUnits; u += 2)
+  {
+    rescueops::sim::EventAccess access;
+    access.write(rescueops::sim::access_key(kUnitKey, u)).write(rescueops::sim::access_key(kUnitKey, u + 1));
+    s.schedule_every(7, u % 7, access, [&sim, u] {
+      const auto a = sim.state[u];
+      sim.state[u] ^= sim.state[u + 1] >> 7;
+      sim.state[u + 1] += a;
+    }, 280);
+  }
+
+  // Undeclared audit: serial barrier, order-sensitive.
+  s.schedule_every(5, 0, [&sim] {
+    std::uint64_t h = sim.audit.empty() ? 0 : sim.audit.back();
+    for (auto v : sim.state) h = h * 31 + v;
+    sim.audit.push_back(h);
+  });
+
+  for (; now < 320; ++now) s.run_due(now);
+  sim.parallel_events = s.parallel_events();
+  return sim;
+}
+
+TEST_CASE(test_parallel_batches_match_serial)
+{
+  for (EventQueue kind : {EventQueue::BinaryHeap, EventQueue::TimingWheel})
+  {
+    const UnitSim serial = unit_sim(kind, 1);
+    TEST_ASSERT(serial.parallel_events == 0);
+    for (unsigned threads : {2u, 4u})
+    {
+      const UnitSim par = unit_sim(kind, threads);
+      TEST_ASSERT(par.parallel_events > 10000);
+      TEST_ASSERT(par.state == serial.state);
+      TEST_ASSERT(par.audit == serial.audit);
+    }
+  }
+}
+
+TEST_CASE(test_conflict_set)
+{
+  using rescueops::sim::ConflictSet;
+  using rescueops::sim::EventAccess;
+  ConflictSet set;
+  EventAccess a;
+  a.write(1).read(2);
+  EventAccess b;
+  b.read(2).read(3);
+  EventAccess c;
+  c.write(2);
+  EventAccess d;
+  d.read(1);
+  TEST_ASSERT(set.try_claim(a));
+  TEST_ASSERT(set.try_claim(b));  // read/read is fine
+  TEST_ASSERT(!set.try_claim(c)); // write over a read
+  TEST_ASSERT(!set.try_claim(d)); // read of a written key
+  set.clear();
+  TEST_ASSERT(set.try_claim(c));
+
+  set.clear();
+  for (std::uint64_t k = 0; k < 5000; ++k)
+  {
+    EventAccess w;
+    w.write(k * 7919);
+    TEST_ASSERT(set.try_claim(w));
+  }
+  EventAccess again;
+  again.write(4999 * 7919);
+  TEST_ASSERT(!set.try_claim(again));
+
+  EventAccess many;
+  for (std::uint64_t k = 0; k <= EventAccess::kMaxKeys; ++k) many.write(k);
+  TEST_ASSERT(many.exclusive);
+}
+
+// Calls made from inside batch members: handles of events they schedule, and cancel() results
+// (own follow-ups twice, the member itself, an outside event twice). Serial and parallel runs
+// must see the same values and the same outcome.
+static std::vector<int> batch_calls(bool parallel)
+{
+  constexpr std::uint32_t kMembers = 8;
   Scheduler s;
-  std::string log;
+  ThreadPool pool(2);
+  if (parallel) s.set_thread_pool(&pool);
 
-  s.schedule(10, [&] { log += "A"; });
-  s.schedule(5, [&] { log += "B"; });
-  s.schedule(10, [&] { log += "C"; }); // same tick as A, should run after A because scheduled later
+  struct Calls
+  {
+    Scheduler* s = nullptr;
+    std::vector<int> runs = std::vector<int>(kMembers, 0);
+    std::vector<int> results = std::vector<int>(kMembers * 3, -1);
+    std::vector<rescueops::sim::EventAccess> access = std::vector<rescueops::sim::EventAccess>(kMembers);
+    std::vector<rescueops::sim::EventHandle> self = std::vector<rescueops::sim::EventHandle>(kMembers);
+    rescueops::sim::EventHandle victim{};
+    int victim_runs = 0;
+  } c{&s};
+  c.victim = s.schedule(3, [&c] { ++c.victim_runs; });
+  for (std::uint32_t i = 0; i < kMembers; ++i)
+  {
+    c.access[i].write(rescueops::sim::access_key(1, i));
+    c.self[i] = s.schedule_every(1, 1, c.access[i], [&c, i] {
+      if (++c.runs[i] > 1) return;
+      const auto h = c.s->schedule(5, c.access[i], [&c, i] { c.runs[i] += 100; });
+      c.results[i * 3] = h.id != rescueops::sim::EventArena::kNil;
+      if (i % 2 == 0) c.results[i * 3 + 1] = c.s->cancel(h) * 2 + c.s->cancel(h);
+      if (i == 3) c.results[i * 3 + 2] = c.s->cancel(c.self[i]);
+      if (i == 0) c.results[i * 3 + 2] = c.s->cancel(c.victim) * 2 + c.s->cancel(c.victim);
+    }, 6);
+  }
+  for (Tick t = 0; t <= 8; ++t) s.run_due(t);
 
-  s.run_due(4);
-  TEST_ASSERT(log.empty());
+  TEST_ASSERT(s.contract_violations() == 0);
+  TEST_ASSERT(parallel == (s.parallel_events() > 0));
+  TEST_ASSERT(s.pending() == 0);
+  c.results.insert(c.results.end(), c.runs.begin(), c.runs.end());
+  c.results.push_back(c.victim_runs);
+  return c.results;
+}
 
-  s.run_due(5);
-  TEST_ASSERT(log == "B");
+TEST_CASE(test_parallel_batch_handles_and_cancel)
+{
+  const auto serial = batch_calls(false);
+  TEST_ASSERT(serial[0] == 1 && serial[1] == 2 && serial[2] == 2); // handle; true then false twice
+  TEST_ASSERT(batch_calls(true) == serial);
+}
 
-  s.run_due(10);
-  TEST_ASSERT(log == "BAC");
+TEST_CASE(test_parallel_batch_contract_checked)
+{
+  Scheduler s;
+  ThreadPool pool(2);
+  s.set_thread_pool(&pool);
+  int victim_runs = 0;
+  const auto victim = s.schedule(2, [&victim_runs] { ++victim_runs; });
+  std::vector<rescueops::sim::EventHandle> members(4);
+  std::vector<int> results(4, -1);
+  for (std::uint32_t i = 0; i < 4; ++i)
+  {
+    rescueops::sim::EventAccess access;
+    access.write(rescueops::sim::access_key(1, i));
+    members[i] = s.schedule(1, access, [&, i] {
+      if (i == 0) results[0] = s.schedule(0, [] {}).id != rescueops::sim::EventArena::kNil; // earlier tick
+      if (i == 1) results[1] = s.cancel(members[2]);                                          // batch peer
+      if (i >= 2) results[i] = s.cancel(victim);
+    });
+  }
+  s.run_due(1);
+  TEST_ASSERT(s.parallel_events() == 4);
+  TEST_ASSERT(results[0] == 0 && results[1] == 0 && results[2] == 1);
+  // The later member gets false unless it ran first, which is then counted as well.
+  TEST_ASSERT(s.contract_violations() == (results[3] ? 3u : 2u));
+  s.run_due(2);
+  TEST_ASSERT(victim_runs == 0 && s.pending() == 0);
 }
 
 int main()
 {
   RUN_TEST(test_scheduler_order);
+  RUN_TEST(test_timing_wheel_matches_heap);
+  RUN_TEST(test_pending_counts);
+  RUN_TEST(test_steady_state_does_not_allocate);
+  RUN_TEST(test_periodic_matches_prescheduled);
+  RUN_TEST(test_periodic_memory_and_cancel);
+  RUN_TEST(test_conflict_set);
+  RUN_TEST(test_parallel_batches_match_serial);
+  RUN_TEST(test_parallel_batch_handles_and_cancel);
+  RUN_TEST(test_parallel_batch_contract_checked);
   std::cout << "All scheduler tests passed.\n";
   return 0;
 }
@@ -0,0 +1,123 @@
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "sim/engine.hpp"
+#include "sim/spatial_index.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::SpatialIndex;
+using rescueops::sim::Unit;
+using rescueops::sim::UnitTable;
+using rescueops::sim::Vec2i;
+
+static std::vector<std::uint32_t> brute_radius(const UnitTable& units, Vec2i c, int r)
+{
+  std::vector<std::uint32_t> out;
+  for (std::uint32_t i = 0; i < units.size(); ++i)
+  {
+    const long long dx = static_cast<long long>(units.pos(i).x) - c.x;
+    const long long dy = static_cast<long long>(units.pos(i).y) - c.y;
+    if (dx < -r || dx > r || dy < -r || dy > r) continue;
+    if (dx * dx + dy * dy <= static_cast<long long>(r) * r) out.push_back(i);
+  }
+  return out;
+}
+
+static std::vector<std::uint32_t> brute_rect(const UnitTable& units, Vec2i lo, Vec2i hi)
+{
+  std::vector<std::uint32_t> out;
+  for (std::uint32_t i = 0; i < units.size(); ++i)
+  {
+    const Vec2i p = units.pos(i);
+    if (p.x >= lo.x && p.x <= hi.x && p.y >= lo.y && p.y <= hi.y) out.push_back(i);
+  }
+  return out;
+}
+
+TEST_CASE(test_queries_match_brute_force)
+{
+  std::mt19937 rng(5);
+  UnitTable units;
+  for (std::uint32_t i = 0; i < 2000; ++i)
+    units.push_back(Unit{i + 1, "u", Vec2i{static_cast<int>(rng() % 100), static_cast<int>(rng() % 70)}});
+  units.push_back(Unit{9999, "outside", Vec2i{-4, 80}}); // bucketed at the border
+
+  SpatialIndex index(6); // rounds up to 8
+  TEST_ASSERT(index.cell_size() == 8);
+  index.build(units, 100, 70);
+
+  std::vector<std::uint32_t> got;
+  for (int q = 0; q < 300; ++q)
+  {
+    const Vec2i c{static_cast<int>(rng() % 120) - 10, static_cast<int>(rng() % 90) - 10};
+    const int r = static_cast<int>(rng() % 20);
+    index.query_radius(c, r, got);
+    TEST_ASSERT(got == brute_radius(units, c, r));
+
+    const Vec2i lo{c.x - static_cast<int>(rng() % 15), c.y - static_cast<int>(rng() % 15)};
+    index.query_rect(lo, c, got);
+    TEST_ASSERT(got == brute_rect(units, lo, c));
+  }
+  index.query_rect(Vec2i{-10, 75}, Vec2i{0, 90}, got);
+  TEST_ASSERT(got.size() == 1 && got[0] == 2000);
+  index.query_radius(Vec2i{50, 50}, 1'000'000'000, got);
+  TEST_ASSERT(got.size() == units.size());
+  index.query_rect(Vec2i{5, 5}, Vec2i{4, 9}, got);
+  TEST_ASSERT(got.empty());
+
+  // Offsets past the int range: a unit 4e9 away must not wrap around into the radius.
+  units.push_back(Unit{10000, "far", Vec2i{-2'000'000'000, 10}});
+  index.build(units, 100, 70);
+  const Vec2i far_center{2'000'000'000, 10};
+  index.query_radius(far_center, 2'100'000'000, got);
+  TEST_ASSERT(got == brute_radius(units, far_center, 2'100'000'000));
+  TEST_ASSERT(std::find(got.begin(), got.end(), 2001u) == got.end());
+}
+
+// Incremental updates during Engine::run give the same answers as a fresh build.
+TEST_CASE(test_engine_keeps_index_current)
+{
+  Engine eng;
+  eng.world().width = 64;
+  eng.world().height = 64;
+  for (std::uint32_t i = 0; i < 500; ++i)
+    eng.world().units.push_back(Unit{i + 1, "u", Vec2i{static_cast<int>(i % 64), static_cast<int>((i * 7) % 64)}});
+  eng.enable_spatial_index(4);
+  TEST_ASSERT(eng.spatial_index() != nullptr);
+
+  std::vector<std::uint32_t> got;
+  std::vector<std::uint32_t> want;
+  for (const rescueops::sim::Tick end : {40, 41, 120})
+  {
+    eng.run(end);
+    const SpatialIndex* index = eng.spatial_index();
+    TEST_ASSERT(index->moves() > 0 || end == 41);
+
+    SpatialIndex fresh(4);
+    fresh.build(eng.world().units, 64, 64);
+    for (int y = 0; y < 64; y += 5)
+    {
+      for (int x = 0; x < 64; x += 7)
+      {
+        index->query_radius(Vec2i{x, y}, 6, got);
+        fresh.query_radius(Vec2i{x, y}, 6, want);
+        TEST_ASSERT(got == want);
+        TEST_ASSERT(got == brute_radius(eng.world().units, Vec2i{x, y}, 6));
+      }
+    }
+  }
+
+  eng.enable_spatial_index(0);
+  TEST_ASSERT(eng.spatial_index() == nullptr);
+}
+
+int main()
+{
+  RUN_TEST(test_queries_match_brute_force);
+  RUN_TEST(test_engine_keeps_index_current);
+  std::cout << "All spatial index tests passed.\n";
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include "test_common.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sim/engine.hpp"
+#include "sim/trajectory.hpp"
+
+using rescueops::sim::Engine;
+using rescueops::sim::TrajectoryOptions;
+using rescueops::sim::TrajectoryReader;
+using rescueops::sim::TrajectoryRecorder;
+using rescueops::sim::UnitTable;
+using rescueops::sim::Vec2i;
+
+static const char* kScenario = R"({
+  "seed": 11, "world": {"width": 40, "height": 30},
+  "units": [{"name": "a", "x": 0, "y": 0}, {"name": "b", "x": 39, "y": 29}, {"name": "c", "x": 20, "y": 15},
+            {"name": "d", "x": 5, "y": 25}, {"name": "e", "x": 33, "y": 2}]
+})";
+
+static std::string temp_path(const char* name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::string read_file(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+static void load(Engine& eng)
+{
+  rescueops::sim::Scenario s;
+  TEST_ASSERT(rescueops::sim::parse_scenario(kScenario, s));
+  eng.load(s);
+}
+
+// Records 300 ticks of a run (split in two calls) and returns the file contents.
+static std::string record_run(const std::string& path, const TrajectoryOptions& options)
+{
+  Engine eng;
+  load(eng);
+  TrajectoryRecorder rec;
+  TEST_ASSERT(rec.open(path, options));
+  eng.set_trajectory_recorder(&rec);
+  eng.run(120);
+  eng.run(300);
+  TEST_ASSERT(rec.frames() == 301);
+  TEST_ASSERT(rec.close());
+  return read_file(path);
+}
+
+TEST_CASE(test_engine_run_round_trip)
+{
+  const std::string path = temp_path("rescueops_test_trajectory.rtraj");
+  TrajectoryOptions options;
+  options.chunk_frames = 64;
+  record_run(path, options);
+
+  TrajectoryReader reader;
+  std::string error;
+  TEST_ASSERT(reader.open(path, &error));
+  TEST_ASSERT(reader.indexed() && reader.chunk_count() == 5);
+  TEST_ASSERT(reader.first_frame() == 0 && reader.last_frame() == 300 && !reader.has_frame(301));
+
+  // Frame f equals the world after f ticks.
+  Engine ref;
+  load(ref);
+  std::vector<std::uint32_t> ids;
+  std::vector<int> x, y;
+  for (rescueops::sim::Tick f = 0; f <= 300; ++f)
+  {
+    ref.run(f);
+    TEST_ASSERT(reader.read_frame(f, ids, x, y));
+    TEST_ASSERT(ids.size() == 5);
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+      const auto u = ref.world().units[i];
+      TEST_ASSERT(ids[i] == u.id && x[i] == u.pos.x && y[i] == u.pos.y);
+    }
+  }
+
+  // Seeking backwards and across chunks decodes the same frames.
+  const std::vector<int> x200 = (reader.read_frame(200, ids, x, y), x);
+  TEST_ASSERT(reader.read_frame(3, ids, x, y) && reader.read_frame(200, ids, x, y) && x == x200);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_background_writer_matches)
+{
+  const std::string a = temp_path("rescueops_test_trajectory_sync.rtraj");
+  const std::string b = temp_path("rescueops_test_trajectory_bg.rtraj");
+  TrajectoryOptions options;
+  options.chunk_frames = 16;
+  const std::string sync = record_run(a, options);
+  options.background = true;
+  options.max_pending_bytes = 1; // every chunk waits for the previous one
+  TEST_ASSERT(record_run(b, options) == sync);
+  std::filesystem::remove(a);
+  std::filesystem::remove(b);
+}
+
+TEST_CASE(test_escapes_gaps_and_unit_changes)
+{
+  const std::string path = temp_path("rescueops_test_trajectory_jumps.rtraj");
+  TrajectoryRecorder rec;
+  TEST_ASSERT(rec.open(path));
+  UnitTable units;
+  units.push_back(7, "p", Vec2i{0, 0});
+  units.push_back(3, "q", Vec2i{-5, 100000});
+  std::vector<std::vector<Vec2i>> expect;
+  for (int f = 0; f < 10; ++f)
+  {
+    units.set_pos(0, Vec2i{f * f, -f});             // growing jumps need escapes
+    units.set_pos(1, Vec2i{-5 + (f % 2), 100000 - 70000 * (f % 3)});
+    rec.record(static_cast<rescueops::sim::Tick>(f), units);
+    rec.record(static_cast<rescueops::sim::Tick>(f), units); // duplicate frame: ignored
+    expect.push_back({units.pos(0), units.pos(1)});
+  }
+  units.push_back(9, "r", Vec2i{1, 1}); // new unit count: new chunk
+  rec.record(10, units);
+  rec.record(20, units); // gap: new chunk
+  TEST_ASSERT(rec.frames() == 12);
+  TEST_ASSERT(rec.close());
+
+  TrajectoryReader reader;
+  TEST_ASSERT(reader.open(path));
+  TEST_ASSERT(reader.chunk_count() == 3);
+  TEST_ASSERT(!reader.has_frame(15) && reader.has_frame(20) && reader.last_frame() == 20);
+  std::vector<std::uint32_t> ids;
+  std::vector<int> x, y;
+  for (int f = 9; f >= 0; --f)
+  {
+    TEST_ASSERT(reader.read_frame(static_cast<rescueops::sim::Tick>(f), ids, x, y));
+    TEST_ASSERT(ids.size() == 2 && ids[0] == 7 && ids[1] == 3);
+    TEST_ASSERT(x[0] == expect[f][0].x && y[0] == expect[f][0].y && x[1] == expect[f][1].x && y[1] == expect[f][1].y);
+  }
+  TEST_ASSERT(reader.read_frame(20, ids, x, y) && ids.size() == 3 && ids[2] == 9 && x[2] == 1);
+  TEST_ASSERT(!reader.read_frame(15, ids, x, y));
+  std::filesystem::remove(path);
+}
+
+TEST_CASE(test_recovers_unclosed_and_rejects_damaged)
+{
+  const std::string path = temp_path("rescueops_test_trajectory_cut.rtraj");
+  TrajectoryOptions options;
+  options.chunk_frames = 64;
+  const std::string image = record_run(path, options);
+  const auto write = [&](const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << bytes;
+  };
+
+  // Cut inside the last chunk, as if the process died: the four complete chunks remain.
+  TrajectoryReader reader;
+  write(image.substr(0, image.size() - 200));
+  TEST_ASSERT(reader.open(path) && !reader.indexed());
+  TEST_ASSERT(reader.chunk_count() == 4 && reader.last_frame() == 255);
+  std::vector<std::uint32_t> ids;
+  std::vector<int> x, y;
+  TEST_ASSERT(reader.read_frame(255, ids, x, y) && ids.size() == 5);
+
+  // A flipped payload byte fails that chunk's checksum; other chunks still read.
+  std::string bad = image;
+  bad[16 + 40 + 3] ^= 0x40;
+  write(bad);
+  TEST_ASSERT(reader.open(path) && reader.indexed());
+  TEST_ASSERT(!reader.read_frame(10, ids, x, y));
+  TEST_ASSERT(reader.read_frame(100, ids, x, y));
+
+  bad = image;
+  bad[8] = 9; // version
+  write(bad);
+  std::string error;
+  TEST_ASSERT(!reader.open(path, &error) && error.find("version") != std::string::npos);
+  std::filesystem::remove(path);
+}
+
+int main()
+{
+  RUN_TEST(test_engine_run_round_trip);
+  RUN_TEST(test_background_writer_matches);
+  RUN_TEST(test_escapes_gaps_and_unit_changes);
+  RUN_TEST(test_recovers_unclosed_and_rejects_damaged);
+  std::cout << "All trajectory tests passed.\n";
+  return 0;
+}
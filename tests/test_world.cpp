@@ -0,0 +1,56 @@
+#include "test_common.hpp"
+
+#include "sim/world.hpp"
+
+using rescueops::sim::StringTable;
+using rescueops::sim::Unit;
+using rescueops::sim::UnitTable;
+using rescueops::sim::Vec2i;
+
+TEST_CASE(test_string_table_interns)
+{
+  StringTable t;
+  const auto a = t.intern("alpha");
+  const auto b = t.intern("bravo");
+  TEST_ASSERT(t.intern("alpha") == a);
+  TEST_ASSERT(a != b);
+  TEST_ASSERT(t.size() == 2);
+  TEST_ASSERT(t.at(a) == "alpha" && t.at(b) == "bravo");
+  TEST_ASSERT(t.at(t.intern("")).empty());
+}
+
+TEST_CASE(test_unit_table_columns_and_rows)
+{
+  UnitTable units;
+  units.push_back(Unit{1, "alpha", Vec2i{3, 4}});
+  units.push_back(Unit{2, "bravo", Vec2i{5, 6}});
+  units.push_back(Unit{3, "alpha", Vec2i{7, 8}});
+  TEST_ASSERT(units.size() == 3);
+  TEST_ASSERT(units.names().size() == 2); // "alpha" stored once
+
+  units.x()[1] += 10;
+  units.set_pos(2, Vec2i{0, 1});
+  TEST_ASSERT(units.pos(1).x == 15 && units.pos(1).y == 6);
+
+  const int expect_x[] = {3, 15, 0};
+  std::size_t i = 0;
+  for (const auto& u : units)
+  {
+    TEST_ASSERT(u.id == i + 1);
+    TEST_ASSERT(u.pos.x == expect_x[i]);
+    ++i;
+  }
+  TEST_ASSERT(i == 3);
+  TEST_ASSERT(units[2].name == "alpha" && units[1].name == "bravo");
+
+  units.clear();
+  TEST_ASSERT(units.empty() && units.names().size() == 0);
+}
+
+int main()
+{
+  RUN_TEST(test_string_table_interns);
+  RUN_TEST(test_unit_table_columns_and_rows);
+  std::cout << "All world tests passed.\n";
+  return 0;
+}